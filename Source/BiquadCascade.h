@@ -0,0 +1,138 @@
+#pragma once
+#include <array>
+#include <cmath>
+
+/**
+ * Biquad Cascade
+ * N second-order sections run as one filter: every section is applied to a
+ * sample before moving to the next sample, so the block is read and
+ * written once and the whole cascade's state stays in registers for the
+ * length of the loop.
+ *
+ * Sections are transposed direct form II. Coefficients are normalised
+ * (a0 = 1); a first-order section has b2 = a2 = 0. The cascade only holds
+ * coefficients; the state lives in a separate State per channel, so
+ * channels share one set of coefficients.
+ *
+ * Usage:
+ *   BiquadCascade<2> cascade;
+ *   BiquadCascade<2>::State state[2];
+ *   cascade.setSection(0, BiquadCoefficients::peaking(fs, 2000.0, 1.5, 2.0));
+ *   cascade.process(data, data, numSamples, state[ch]);
+ */
+struct BiquadCoefficients {
+  float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+
+  // Normalises by a0
+  static BiquadCoefficients fromUnnormalised(double b0, double b1, double b2,
+                                             double a0, double a1, double a2) {
+    return {(float)(b0 / a0), (float)(b1 / a0), (float)(b2 / a0),
+            (float)(a1 / a0), (float)(a2 / a0)};
+  }
+
+  // RBJ cookbook shelves and peak, gain in dB
+  static BiquadCoefficients lowShelf(double sampleRate, double frequency,
+                                     double quality, double gainDB) {
+    const Terms t(sampleRate, frequency, quality, gainDB);
+    const double ap = t.a + 1.0, am = t.a - 1.0;
+    const double r = 2.0 * std::sqrt(t.a) * t.alpha;
+    return fromUnnormalised(t.a * (ap - am * t.cosw + r),
+                            2.0 * t.a * (am - ap * t.cosw),
+                            t.a * (ap - am * t.cosw - r),
+                            ap + am * t.cosw + r, -2.0 * (am + ap * t.cosw),
+                            ap + am * t.cosw - r);
+  }
+
+  static BiquadCoefficients highShelf(double sampleRate, double frequency,
+                                      double quality, double gainDB) {
+    const Terms t(sampleRate, frequency, quality, gainDB);
+    const double ap = t.a + 1.0, am = t.a - 1.0;
+    const double r = 2.0 * std::sqrt(t.a) * t.alpha;
+    return fromUnnormalised(t.a * (ap + am * t.cosw + r),
+                            -2.0 * t.a * (am + ap * t.cosw),
+                            t.a * (ap + am * t.cosw - r),
+                            ap - am * t.cosw + r, 2.0 * (am - ap * t.cosw),
+                            ap - am * t.cosw - r);
+  }
+
+  static BiquadCoefficients peaking(double sampleRate, double frequency,
+                                    double quality, double gainDB) {
+    const Terms t(sampleRate, frequency, quality, gainDB);
+    return fromUnnormalised(1.0 + t.alpha * t.a, -2.0 * t.cosw,
+                            1.0 - t.alpha * t.a, 1.0 + t.alpha / t.a,
+                            -2.0 * t.cosw, 1.0 - t.alpha / t.a);
+  }
+
+private:
+  struct Terms {
+    Terms(double sampleRate, double frequency, double quality, double gainDB)
+        : a(std::pow(10.0, gainDB / 40.0)) {
+      const double omega = 2.0 * 3.14159265358979323846 * frequency /
+                           sampleRate;
+      cosw = std::cos(omega);
+      alpha = std::sin(omega) / (2.0 * quality);
+    }
+
+    double a, cosw = 1.0, alpha = 0.0;
+  };
+};
+
+template <int NumSections> class BiquadCascade {
+public:
+  // Two delay terms per section
+  using State = std::array<float, 2 * NumSections>;
+
+  BiquadCascade() {}
+  ~BiquadCascade() {}
+
+  void setSection(int index, const BiquadCoefficients &coefficients) {
+    sections[index] = coefficients;
+  }
+
+  const BiquadCoefficients &getSection(int index) const {
+    return sections[index];
+  }
+
+  static void reset(State &state) { state.fill(0.0f); }
+
+  // In place is fine (input == output)
+  template <typename SampleType>
+  void process(const SampleType *input, SampleType *output, int numSamples,
+               State &state) const {
+    run(numSamples, state, [input](int i) { return (float)input[i]; },
+        [output](int i, float y) { output[i] = (SampleType)y; });
+  }
+
+  // The same loop with the sample source and sink supplied by the caller,
+  // so work around the filter can share its pass over the block:
+  // read(i) returns input sample i, write(i, y) stores output sample i.
+  // Sample i is read before it is written.
+  template <typename Read, typename Write>
+  void run(int numSamples, State &state, Read &&read, Write &&write) const {
+    // Locals, so the compiler can keep them in registers across the loop
+    BiquadCoefficients c[NumSections];
+    float s[2 * NumSections];
+    for (int k = 0; k < NumSections; ++k) {
+      c[k] = sections[k];
+      s[2 * k] = state[2 * k];
+      s[2 * k + 1] = state[2 * k + 1];
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+      float x = read(i);
+      for (int k = 0; k < NumSections; ++k) {
+        const float y = c[k].b0 * x + s[2 * k];
+        s[2 * k] = c[k].b1 * x - c[k].a1 * y + s[2 * k + 1];
+        s[2 * k + 1] = c[k].b2 * x - c[k].a2 * y;
+        x = y;
+      }
+      write(i, x);
+    }
+
+    for (int k = 0; k < 2 * NumSections; ++k)
+      state[k] = s[k];
+  }
+
+private:
+  BiquadCoefficients sections[NumSections];
+};
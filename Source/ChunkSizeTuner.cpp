@@ -0,0 +1,128 @@
+#include "ChunkSizeTuner.h"
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr const char *chunkSizeKey = "chunkSize";
+constexpr const char *chunkSizeCpuKey = "chunkSizeCpu";
+
+// Per run and size; long enough for the largest chunk to repeat
+constexpr int samplesPerRun = 16384;
+constexpr int numRuns = 3;
+} // namespace
+
+ChunkSizeTuner::ChunkSizeTuner() : juce::Thread("Chunk Size Tuner") {}
+
+ChunkSizeTuner::~ChunkSizeTuner() { stopThread(4000); }
+
+int ChunkSizeTuner::getChunkSize(const juce::File &modelFile) {
+  if (const int chunkSize = tuned.load())
+    return chunkSize;
+
+  if (tuningStarted)
+    return defaultChunkSize;
+
+  auto settings = openSettings();
+  if (settings->getValue(chunkSizeCpuKey) ==
+      juce::SystemStats::getCpuModel()) {
+    const int stored = settings->getIntValue(chunkSizeKey);
+    if (std::find(candidates.begin(), candidates.end(), stored) !=
+        candidates.end()) {
+      tuned = stored;
+      return stored;
+    }
+  }
+
+  // Timed at normal priority: a low one would measure the scheduler
+  tuningModel = modelFile;
+  tuningStarted = true;
+  startThread(juce::Thread::Priority::normal);
+  return defaultChunkSize;
+}
+
+void ChunkSizeTuner::setSettingsFile(const juce::File &file) {
+  settingsFile = file;
+}
+
+void ChunkSizeTuner::run() {
+  int chunkSize = 0;
+  try {
+    juce::SharedResourcePointer<ModelRegistry> registry;
+    ModelRegistry::Config config;
+    auto model = registry->build(
+        std::filesystem::u8path(tuningModel.getFullPathName().toStdString()),
+        config);
+    chunkSize = tune(*model);
+  } catch (std::exception &e) {
+    DBG("Chunk size not tuned: " + juce::String(e.what()));
+    return;
+  }
+
+  if (chunkSize == 0)
+    return;
+
+  auto settings = openSettings();
+  settings->setValue(chunkSizeKey, chunkSize);
+  settings->setValue(chunkSizeCpuKey, juce::SystemStats::getCpuModel());
+  settings->saveIfNeeded();
+
+  tuned = chunkSize;
+  DBG("Tuned chunk size: " + juce::String(chunkSize) + " samples");
+}
+
+int ChunkSizeTuner::tune(nam::DSP &model) {
+  model.prewarm();
+
+  // One untimed pass so the first size is not charged for cold caches
+  timeChunkSize(model, candidates.back());
+
+  std::array<double, candidates.size()> costs{};
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (threadShouldExit())
+      return 0;
+    costs[i] = timeChunkSize(model, candidates[i]);
+  }
+
+  const double best = *std::min_element(costs.begin(), costs.end());
+  for (size_t i = 0; i < candidates.size(); ++i)
+    if (costs[i] <= best * (1.0 + tolerance))
+      return candidates[i];
+
+  return defaultChunkSize;
+}
+
+double ChunkSizeTuner::timeChunkSize(nam::DSP &model, int chunkSize) {
+  // Guitar DI level noise from a fixed seed; the model's cost does not
+  // depend on the signal, but denormals would
+  juce::Random random(0x4348554e);
+  std::vector<float> input((size_t)chunkSize), output((size_t)chunkSize);
+  for (auto &sample : input)
+    sample = 0.2f * (random.nextFloat() * 2.0f - 1.0f);
+
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < numRuns; ++run) {
+    const auto start = juce::Time::getHighResolutionTicks();
+    for (int done = 0; done < samplesPerRun; done += chunkSize) {
+      model.process(input.data(), output.data(), chunkSize);
+      model.finalize_(chunkSize);
+    }
+    const auto ticks = juce::Time::getHighResolutionTicks() - start;
+    best = juce::jmin(best, juce::Time::highResolutionTicksToSeconds(ticks));
+  }
+
+  return best / samplesPerRun;
+}
+
+std::unique_ptr<juce::PropertiesFile> ChunkSizeTuner::openSettings() const {
+  juce::PropertiesFile::Options options;
+  options.applicationName = "Mayerism";
+  options.folderName = "CraftLabs Mayerism";
+  options.filenameSuffix = "settings";
+  options.osxLibrarySubFolder = "Application Support";
+
+  if (settingsFile != juce::File())
+    return std::make_unique<juce::PropertiesFile>(settingsFile, options);
+  return std::make_unique<juce::PropertiesFile>(options);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "ModelRegistry.h"
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/**
+ * Chunk Size Tuner
+ * The size of the chunks the processor cuts host blocks into, picked once
+ * per machine.
+ *
+ * The amp model's cost per sample depends on how many samples it gets per
+ * call, and where the sweet spot lies depends on the CPU's caches. The
+ * first time the plugin is prepared on a machine, a background thread
+ * times the amp model at each candidate size and keeps the cheapest.
+ * Sizes within tolerance of the cheapest count as equal and the smallest
+ * of them wins, as smaller chunks keep the chain's buffers in cache.
+ * Until the result is in, processors prepare with defaultChunkSize; it
+ * applies from their next prepare.
+ *
+ * The chunk size can only cut host blocks down: blocks shorter than it
+ * run at the host's size, as gathering them up would add latency. It
+ * pays off with hosts whose blocks are longer than the sweet spot.
+ *
+ * The result is stored in the user's settings file together with the CPU
+ * it was measured on, so a copied settings folder is tuned again on the
+ * new machine. The tuner is process-wide: plugin instances hold it through
+ * a juce::SharedResourcePointer, so a machine is timed once.
+ */
+class ChunkSizeTuner : private juce::Thread {
+public:
+  static constexpr std::array<int, 6> candidates{64, 128, 256, 512, 1024,
+                                                 2048};
+  static constexpr int defaultChunkSize = 512;
+
+  // A size this much slower than the best still counts as equal
+  static constexpr double tolerance = 0.05;
+
+  ChunkSizeTuner();
+  ~ChunkSizeTuner() override;
+
+  /**
+   * The stored chunk size, or defaultChunkSize while this machine has
+   * none; then the model in `modelFile` is timed in the background. Stays
+   * at defaultChunkSize if that model cannot be built. Message thread;
+   * never waits for the timing.
+   */
+  int getChunkSize(const juce::File &modelFile);
+
+  // Stores the result in `file` instead of the user's settings, e.g. a
+  // temporary file in tests. Message thread, before getChunkSize().
+  void setSettingsFile(const juce::File &file);
+
+  // Times `model` at each candidate size; returns the winner, or 0 if the
+  // thread was told to stop
+  int tune(nam::DSP &model);
+
+private:
+  void run() override;
+
+  std::unique_ptr<juce::PropertiesFile> openSettings() const;
+
+  // Seconds per sample, best of a few runs
+  static double timeChunkSize(nam::DSP &model, int chunkSize);
+
+  juce::File settingsFile; // empty: the user's settings
+  juce::File tuningModel;
+  std::atomic<int> tuned{0};
+  bool tuningStarted{false};
+};
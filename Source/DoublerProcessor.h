@@ -114,6 +114,8 @@ public:
         lastDelayValue = newDelay;
     }
 
+    void reset() { delayModule.reset(); }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         juce::dsp::AudioBlock<float> block(buffer);
@@ -0,0 +1,104 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+
+class SignalChain;
+struct PedalBank;
+
+/**
+ * Execution Plan
+ * The pre-amp pedals of a SignalChain flattened into the order they run in,
+ * as a fixed list of stage functions with the channel count each one runs
+ * on.
+ *
+ * The pedal order is a choice parameter (PEDAL_ORDER_ID), one entry per
+ * ordering of the four pedals. A plan holds only the pedals that are
+ * awake: on, or still fading out through their PedalBypass. Each chain
+ * compiles the plan for every ordering and every set of awake pedals once,
+ * in hook() on the message thread. The audio thread looks its plan up by
+ * getPlanIndex() and walks the list, with no per-pedal branching on the
+ * order and no call at all for a pedal that is asleep.
+ *
+ * An order change runs the old and the new plan side by side on the
+ * chain's two pedal banks and crossfades (see SignalChain).
+ */
+class ExecutionPlan {
+public:
+  enum Pedal { Compressor = 0, Boost, TubeScreamer, Klon, NumPedals };
+
+  // 4! orderings; index 0 is comp > boost > TS > Klon
+  static constexpr int numOrders = 24;
+  using Order = std::array<Pedal, NumPedals>;
+
+  // One bit per Pedal, set while the pedal is awake
+  static constexpr int numAwakeSets = 1 << NumPedals;
+  static constexpr int numPlans = numOrders * numAwakeSets;
+
+  static constexpr int getPlanIndex(int order, int awakePedals) {
+    return order * numAwakeSets + awakePedals;
+  }
+
+  using StageFn = void (*)(SignalChain &, PedalBank &,
+                           juce::AudioBuffer<float> &);
+
+  struct Step {
+    StageFn run;
+    int numChannels; // leading channels of the chain buffer it runs on
+  };
+
+  ExecutionPlan() {}
+  ~ExecutionPlan() {}
+
+  void clear() { numSteps = 0; }
+
+  void add(StageFn run, int numChannels) {
+    jassert(numSteps < maxSteps);
+    steps[(size_t)numSteps++] = {run, numChannels};
+  }
+
+  const Step *begin() const { return steps.data(); }
+  const Step *end() const { return steps.data() + numSteps; }
+
+  // Orderings in lexicographic order of pedal index, so the parameter's
+  // indices never move
+  static Order getOrder(int index) {
+    Order order{Compressor, Boost, TubeScreamer, Klon};
+    for (int i = 0; i < index % numOrders; ++i)
+      std::next_permutation(order.begin(), order.end());
+    return order;
+  }
+
+  static juce::String getPedalName(Pedal pedal) {
+    switch (pedal) {
+    case Compressor:
+      return "Comp";
+    case Boost:
+      return "Boost";
+    case TubeScreamer:
+      return "TS";
+    case Klon:
+      return "Klon";
+    default:
+      return {};
+    }
+  }
+
+  // "Comp > Boost > TS > Klon", ...; the parameter's choices
+  static juce::StringArray getOrderNames() {
+    juce::StringArray names;
+    for (int i = 0; i < numOrders; ++i) {
+      juce::StringArray pedals;
+      for (auto pedal : getOrder(i))
+        pedals.add(getPedalName(pedal));
+      names.add(pedals.joinIntoString(" > "));
+    }
+    return names;
+  }
+
+private:
+  static constexpr int maxSteps = NumPedals;
+
+  std::array<Step, maxSteps> steps{};
+  int numSteps{0};
+};
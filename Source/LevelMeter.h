@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * Level Meter
+ * Vertical bar meter fed by the editor from a MeterReader level: the bar
+ * shows rms, a line marks the held peak. Only repaints when what it shows
+ * has moved by at least a pixel.
+ */
+class LevelMeter : public juce::Component {
+public:
+  LevelMeter() { setInterceptsMouseClicks(false, false); }
+  ~LevelMeter() override {}
+
+  void setColours(juce::Colour bar, juce::Colour background) {
+    barColour = bar;
+    backgroundColour = background;
+    repaint();
+  }
+
+  void setLevel(float rms, float peakHold) {
+    const float newBar = toProportion(rms);
+    const float newPeak = toProportion(peakHold);
+    const float pixel = 1.0f / juce::jmax(1, getHeight());
+
+    if (std::abs(newBar - bar) < pixel && std::abs(newPeak - peak) < pixel)
+      return;
+
+    bar = newBar;
+    peak = newPeak;
+    repaint();
+  }
+
+  void paint(juce::Graphics &g) override {
+    const auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(backgroundColour);
+    g.fillRect(bounds);
+
+    g.setColour(barColour);
+    g.fillRect(bounds.withTop(bounds.getBottom() - bounds.getHeight() * bar));
+
+    if (peak > 0.0f) {
+      const float y = bounds.getBottom() - bounds.getHeight() * peak;
+      g.drawHorizontalLine(juce::roundToInt(y), bounds.getX(),
+                           bounds.getRight());
+    }
+  }
+
+private:
+  // Same scale as the meters this replaces: linear in dB down to -80 dB
+  static constexpr float floorDb = -80.0f;
+
+  static float toProportion(float gain) {
+    return juce::jlimit(
+        0.0f, 1.0f,
+        1.0f - juce::Decibels::gainToDecibels(gain, floorDb) / floorDb);
+  }
+
+  juce::Colour barColour{juce::Colours::grey};
+  juce::Colour backgroundColour{juce::Colours::lightgrey};
+  float bar{0.0f};
+  float peak{0.0f};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
+};
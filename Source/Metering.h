@@ -0,0 +1,224 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * Meter Frame
+ * One block's worth of level statistics, gathered on the audio thread.
+ *
+ * Each tap only records a peak and a sum of squares; RMS windows, peak
+ * hold, decay and history are left to the editor (see MeterReader). Pedal
+ * taps are measured only while the pedal actually runs, so a bypassed or
+ * sleeping pedal reads as silent.
+ */
+struct MeterFrame {
+  enum Tap {
+    Input = 0,
+    Compressor,
+    Boost,
+    TubeScreamer,
+    Klon,
+    Amp,
+    Doubler,
+    Chorus,
+    Delay,
+    Reverb,
+    Output,
+    NumTaps
+  };
+
+  std::array<float, NumTaps> peak{};
+  std::array<float, NumTaps> sumSquares{};
+  std::array<int, NumTaps> numSamples{};
+
+  // Noise gate state at the end of the block
+  float gateReductionDb{0.0f};
+  bool gating{false};
+
+  void clear() { *this = MeterFrame(); }
+
+  // Audio thread: folds a (sub-)block into the tap, averaged over channels
+  void measure(Tap tap, const juce::AudioBuffer<float> &buffer) {
+    const int channels = buffer.getNumChannels();
+    const int length = buffer.getNumSamples();
+    if (channels == 0 || length == 0)
+      return;
+
+    float blockPeak = 0.0f;
+    float blockSquares = 0.0f;
+
+    for (int ch = 0; ch < channels; ++ch) {
+      const float *data = buffer.getReadPointer(ch);
+
+      const auto range =
+          juce::FloatVectorOperations::findMinAndMax(data, length);
+      blockPeak = juce::jmax(blockPeak, -range.getStart(), range.getEnd());
+      blockSquares += sumOfSquares(data, length);
+    }
+
+    peak[tap] = juce::jmax(peak[tap], blockPeak);
+    sumSquares[tap] += blockSquares / (float)channels;
+    numSamples[tap] += length;
+  }
+
+  // Four independent sums so the loop vectorises without -ffast-math
+  static float sumOfSquares(const float *data, int length) {
+    float sums[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    int i = 0;
+    for (; i + 4 <= length; i += 4)
+      for (int lane = 0; lane < 4; ++lane)
+        sums[lane] += data[i + lane] * data[i + lane];
+
+    for (; i < length; ++i)
+      sums[0] += data[i] * data[i];
+
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+  }
+};
+
+/**
+ * Meter Ring
+ * Single-producer, single-consumer queue of MeterFrames.
+ *
+ * The audio thread pushes one frame per block; the editor drains whatever
+ * has arrived at frame rate. Neither side locks or allocates. While no
+ * editor is reading the ring fills up and new frames are dropped.
+ */
+class MeterRing {
+public:
+  MeterRing() {}
+  ~MeterRing() {}
+
+  // Audio thread; false if the ring is full
+  bool push(const MeterFrame &frame) {
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 == 0)
+      return false;
+
+    frames[(size_t)scope.startIndex1] = frame;
+    return true;
+  }
+
+  // Message thread; calls fn(frame) for every pending frame, oldest first
+  template <typename Function> int drain(Function &&fn) {
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+      fn(frames[(size_t)(scope.startIndex1 + i)]);
+    for (int i = 0; i < scope.blockSize2; ++i)
+      fn(frames[(size_t)(scope.startIndex2 + i)]);
+
+    return scope.blockSize1 + scope.blockSize2;
+  }
+
+private:
+  // About a second of 128-sample blocks at 48 kHz
+  static constexpr int capacity = 512;
+
+  juce::AbstractFifo fifo{capacity};
+  std::array<MeterFrame, capacity> frames;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterRing)
+};
+
+/**
+ * Meter Reader
+ * Editor side of the metering: drains a MeterRing at frame rate and turns
+ * the frames into display levels for every tap.
+ *
+ * - rms: over the frames that arrived since the last update, falling no
+ *   faster than the release time
+ * - peak: highest sample since the last update, with the same release
+ * - peakHold: highest peak, held for holdSeconds
+ * - history: the last historySize rms values, one per update
+ *
+ * Gate gain reduction and state come from the newest frame.
+ */
+class MeterReader {
+public:
+  MeterReader() {}
+  ~MeterReader() {}
+
+  struct Level {
+    float rms{0.0f};
+    float peak{0.0f};
+    float peakHold{0.0f};
+  };
+
+  static constexpr int historySize = 128;
+
+  // Call from a timer; secondsElapsed is the timer period
+  void update(MeterRing &ring, float secondsElapsed) {
+    std::array<float, MeterFrame::NumTaps> peaks{};
+    std::array<double, MeterFrame::NumTaps> squares{};
+    std::array<int, MeterFrame::NumTaps> counts{};
+
+    const int frames = ring.drain([&](const MeterFrame &frame) {
+      for (int tap = 0; tap < MeterFrame::NumTaps; ++tap) {
+        peaks[tap] = juce::jmax(peaks[tap], frame.peak[tap]);
+        squares[tap] += frame.sumSquares[tap];
+        counts[tap] += frame.numSamples[tap];
+      }
+      gateReductionDb = frame.gateReductionDb;
+      gating = frame.gating;
+    });
+
+    // Nothing arrived (transport stopped, bypassed): fall back to silence
+    if (frames == 0) {
+      gateReductionDb = 0.0f;
+      gating = false;
+    }
+
+    const float release =
+        std::pow(10.0f, -releaseDbPerSecond * secondsElapsed / 20.0f);
+    historyPosition = (historyPosition + 1) % historySize;
+
+    for (int tap = 0; tap < MeterFrame::NumTaps; ++tap) {
+      auto &level = levels[tap];
+      const float rms =
+          counts[tap] > 0 ? (float)std::sqrt(squares[tap] / counts[tap]) : 0.0f;
+
+      level.rms = juce::jmax(rms, level.rms * release);
+      level.peak = juce::jmax(peaks[tap], level.peak * release);
+
+      holdTime[tap] += secondsElapsed;
+      if (peaks[tap] >= level.peakHold || holdTime[tap] > holdSeconds) {
+        level.peakHold = peaks[tap];
+        holdTime[tap] = 0.0f;
+      }
+
+      history[tap][historyPosition] = level.rms;
+    }
+  }
+
+  // Drops whatever queued up while nobody was reading
+  void discard(MeterRing &ring) {
+    ring.drain([](const MeterFrame &) {});
+  }
+
+  const Level &get(MeterFrame::Tap tap) const { return levels[tap]; }
+
+  float getGateReductionDb() const { return gateReductionDb; }
+  bool isGating() const { return gating; }
+
+  // rms of the tap `age` updates ago (0 = newest)
+  float getHistory(MeterFrame::Tap tap, int age) const {
+    return history[tap][(historyPosition - age % historySize + historySize) %
+                        historySize];
+  }
+
+private:
+  static constexpr float releaseDbPerSecond = 24.0f;
+  static constexpr float holdSeconds = 1.5f;
+
+  std::array<Level, MeterFrame::NumTaps> levels;
+  std::array<float, MeterFrame::NumTaps> holdTime{};
+  std::array<std::array<float, historySize>, MeterFrame::NumTaps> history{};
+  int historyPosition{0};
+
+  float gateReductionDb{0.0f};
+  bool gating{false};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterReader)
+};
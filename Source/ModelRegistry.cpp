@@ -0,0 +1,125 @@
+#include "ModelRegistry.h"
+#include "json.hpp"
+
+std::unique_ptr<nam::DSP>
+ModelRegistry::build(const std::filesystem::path &modelPath, Config &config) {
+  // Reads and parses files under a lock; never from the audio thread
+  RealtimeGuard::checkBlocking();
+
+  juce::MemoryBlock contents;
+  const juce::File file(juce::String(modelPath.u8string()));
+  if (!file.loadFileAsData(contents))
+    throw std::runtime_error("Unable to read model file");
+
+  const auto hash = hashContents(contents);
+
+  {
+    const juce::ScopedLock scope(lock);
+    if (auto shared = entries[hash].lock()) {
+      config = shared;
+      return buildFrom(*shared);
+    }
+  }
+
+  // First use: parse outside the lock, it can take a while
+  auto parsed = std::make_shared<Entry>();
+  parsed->config = parseContents(contents);
+
+#if JUCE_DEBUG
+  if (weightPrecision != WeightQuantizer::Precision::Float32) {
+    const auto report =
+        WeightQuantizer::measure(parsed->config, weightPrecision);
+    DBG(WeightQuantizer::getName(weightPrecision) + " weights: ESR " +
+        juce::String(report.esr, 8) + ", null " +
+        juce::String(report.nullDb, 1) + " dB over " +
+        juce::String(report.numWeights) + " weights");
+  }
+#endif
+
+  if (parsed->config.architecture == "WaveNet") {
+    try {
+      parsed->sharedWeights =
+          SharedWaveNet::Weights::parse(parsed->config, weightPrecision);
+      parsed->config.weights = std::vector<float>();
+      if (batchedAmps)
+        parsed->batch = std::make_shared<SharedWaveNet::Batch>();
+    } catch (std::runtime_error &e) {
+      DBG("Model weights not shared: " + juce::String(e.what()));
+    }
+  }
+
+  // Not shared: NeuralAmpModelerCore runs it in float, on rounded weights
+  if (parsed->sharedWeights == nullptr)
+    WeightQuantizer::quantize(parsed->config, weightPrecision);
+
+  auto model = buildFrom(*parsed);
+
+  const juce::ScopedLock scope(lock);
+  auto &entry = entries[hash];
+  if (auto raced = entry.lock())
+    config = raced;
+  else
+    entry = config = parsed;
+
+  // Forget entries whose last model has gone
+  for (auto it = entries.begin(); it != entries.end();)
+    it = it->second.expired() ? entries.erase(it) : std::next(it);
+
+  return model;
+}
+
+nam::dspData ModelRegistry::parseContents(const juce::MemoryBlock &contents) {
+  const auto *text = static_cast<const char *>(contents.getData());
+
+  nam::dspData config;
+  try {
+    const auto j = nlohmann::json::parse(text, text + contents.getSize());
+    nam::verify_config_version(j["version"]);
+
+    config.version = j["version"];
+    config.architecture = j["architecture"];
+    config.config = j["config"];
+    config.metadata = j["metadata"];
+
+    if (j.find("weights") == j.end())
+      throw std::runtime_error("Corrupted model file is missing weights.");
+    config.weights = j["weights"].get<std::vector<float>>();
+
+    config.expected_sample_rate =
+        j.find("sample_rate") != j.end() ? j["sample_rate"].get<double>()
+                                         : -1.0;
+  } catch (nlohmann::json::exception &e) {
+    throw std::runtime_error(std::string("Malformed model file: ") +
+                             e.what());
+  }
+
+  return config;
+}
+
+std::unique_ptr<nam::DSP> ModelRegistry::buildFrom(const Entry &entry) {
+  if (entry.sharedWeights != nullptr)
+    return std::make_unique<SharedWaveNet>(entry.sharedWeights, entry.batch);
+
+  // get_dsp fills in the layers from a config it may modify, so it gets its
+  // own copy; the file is not read or parsed again
+  nam::dspData copy = entry.config;
+  return nam::get_dsp(copy);
+}
+
+int ModelRegistry::getNumEntries() {
+  const juce::ScopedLock scope(lock);
+  int count = 0;
+  for (const auto &entry : entries)
+    count += entry.second.expired() ? 0 : 1;
+  return count;
+}
+
+juce::uint64 ModelRegistry::hashContents(const juce::MemoryBlock &contents) {
+  juce::uint64 hash = 14695981039346656037ull;
+  const auto *bytes = static_cast<const juce::uint8 *>(contents.getData());
+  for (size_t i = 0; i < contents.getSize(); ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "RealtimeGuard.h"
+#include "ResamplingNAM.h"
+#include "SharedWaveNet.h"
+#include "WeightQuantizer.h"
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+
+// Set by the WEIGHT_PRECISION CMake option
+#ifndef MAYERISM_WEIGHT_PRECISION
+#define MAYERISM_WEIGHT_PRECISION 0
+#endif
+
+// Set by the BATCHED_AMPS CMake option
+#ifndef MAYERISM_BATCHED_AMPS
+#define MAYERISM_BATCHED_AMPS 0
+#endif
+
+/**
+ * Model Registry
+ * Process-wide cache of parsed NAM model files, keyed by a hash of the
+ * file's contents.
+ *
+ * The first load of a model parses it (JSON and weights) and keeps the
+ * parsed config. Every later load of the same bytes, from any plugin
+ * instance or signal chain, builds its DSP straight from that config.
+ * Entries are reference counted: the config is freed once the last model
+ * built from it is gone.
+ *
+ * Hold a juce::SharedResourcePointer<ModelRegistry>; the registry itself
+ * lives as long as at least one holder does.
+ *
+ * WaveNet models are built as SharedWaveNet, which maps the entry's
+ * weights instead of copying them: a model used by several instances is in
+ * memory once. Other architectures (and WaveNets SharedWaveNet does not
+ * cover) are built by nam::get_dsp from the entry's parsed config, each
+ * with its own copy of the weights.
+ *
+ * Weights are stored at the WEIGHT_PRECISION build option's precision as
+ * they are parsed, so every model built from an entry shares it (see
+ * WeightQuantizer).
+ *
+ * With the BATCHED_AMPS build option, the SharedWaveNets built from an
+ * entry also share its batch, and run their blocks together one block
+ * late (see SharedWaveNet::Batch).
+ */
+class ModelRegistry {
+public:
+  struct Entry {
+    // Parsed file; its weights are dropped once sharedWeights holds them
+    nam::dspData config;
+    std::shared_ptr<const SharedWaveNet::Weights> sharedWeights;
+
+    // The batch its SharedWaveNets join, with BATCHED_AMPS
+    std::shared_ptr<SharedWaveNet::Batch> batch;
+  };
+
+  using Config = std::shared_ptr<const Entry>;
+
+  ModelRegistry() {}
+  ~ModelRegistry() {}
+
+  /**
+   * Builds a model from a .nam file, parsing it only if no live entry has
+   * the same contents. `config` keeps the shared entry alive; hold it for
+   * as long as the model. Throws std::runtime_error for an unreadable or
+   * malformed file, and what nam::get_dsp throws.
+   */
+  std::unique_ptr<nam::DSP> build(const std::filesystem::path &modelPath,
+                                  Config &config);
+
+  // Number of distinct models currently shared
+  int getNumEntries();
+
+  static constexpr auto weightPrecision =
+      (WeightQuantizer::Precision)MAYERISM_WEIGHT_PRECISION;
+  static constexpr bool batchedAmps = MAYERISM_BATCHED_AMPS != 0;
+
+  // FNV-1a over the file contents
+  static juce::uint64 hashContents(const juce::MemoryBlock &contents);
+
+  // Reads a .nam file's JSON into a config, without building a model.
+  // Throws std::runtime_error for a malformed file.
+  static nam::dspData parseContents(const juce::MemoryBlock &contents);
+
+private:
+  static std::unique_ptr<nam::DSP> buildFrom(const Entry &entry);
+
+  juce::CriticalSection lock;
+  std::map<juce::uint64, std::weak_ptr<const Entry>> entries;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModelRegistry)
+};
@@ -2,50 +2,47 @@
 
 NamEditor::NamEditor(NamJUCEAudioProcessor &p)
     : AudioProcessorEditor(&p), audioProcessor(p), topBar(p),
-      pmc(p.getPresetManager(), [&]() { updateAfterPresetLoad(); }) {
+      pmc(p.getPresetManager(), [&]() { updateAfterPresetLoad(); }),
+      profilerOverlay(p.getProfiler()) {
 
-  // Load page background images
-  backgroundPreEffects = juce::ImageFileFormat::loadFrom(
+  // Load page background images (decoded once per process)
+  backgroundPreEffects = sharedImages->get(
       BinaryData::backgroundpre_png, BinaryData::backgroundpre_pngSize);
-  backgroundPreEffectsNoKnobs = juce::ImageFileFormat::loadFrom(
+  backgroundPreEffectsNoKnobs = sharedImages->get(
       BinaryData::background_pre_no_knobs_png,
       BinaryData::background_pre_no_knobs_pngSize);
-  backgroundAmp = juce::ImageFileFormat::loadFrom(
+  backgroundAmp = sharedImages->get(
       BinaryData::backgroundamp_png, BinaryData::backgroundamp_pngSize);
-  backgroundPostEffects = juce::ImageFileFormat::loadFrom(
+  backgroundPostEffects = sharedImages->get(
       BinaryData::backgroundpost_png, BinaryData::backgroundpost_pngSize);
 
   // Load pedal button images for TS toggle
-  pedalButtonOn = juce::ImageFileFormat::loadFrom(
+  pedalButtonOn = sharedImages->get(
       BinaryData::PedalButtonOn_png, BinaryData::PedalButtonOn_pngSize);
-  pedalButtonOff = juce::ImageFileFormat::loadFrom(
+  pedalButtonOff = sharedImages->get(
       BinaryData::PedalButtonOff_png, BinaryData::PedalButtonOff_pngSize);
 
   // Load pedal button images for post-effects pedals
-  pedalButtonOnPostEffects = juce::ImageFileFormat::loadFrom(
+  pedalButtonOnPostEffects = sharedImages->get(
       BinaryData::KnobOnPostEffects_png, BinaryData::KnobOnPostEffects_pngSize);
-  pedalButtonOffPostEffects =
-      juce::ImageFileFormat::loadFrom(BinaryData::KnobOffPostEffects_png,
-                                      BinaryData::KnobOffPostEffects_pngSize);
+  pedalButtonOffPostEffects = sharedImages->get(
+      BinaryData::KnobOffPostEffects_png,
+      BinaryData::KnobOffPostEffects_pngSize);
 
-  // Meters
-  meterIn.setMeterSource(&audioProcessor.getMeterInSource());
+  // Meters; levels queued while the editor was closed are stale
+  meterReader.discard(audioProcessor.getMeterRing());
   addAndMakeVisible(meterIn);
-
-  meterOut.setMeterSource(&audioProcessor.getMeterOutSource());
   addAndMakeVisible(meterOut);
 
   meterIn.setAlpha(0.8);
   meterOut.setAlpha(0.8);
 
-  meterIn.setSelectedChannel(0);
-  meterOut.setSelectedChannel(0);
-
   meterIn.toFront(true);
   meterOut.toFront(true);
 
   // Initialize meter positions and styling
   setMeterPosition();
+  startTimerHz(meterRefreshHz);
 
   lnf.setColour(Slider::textBoxOutlineColourId,
                 juce::Colours::transparentBlack);
@@ -105,6 +102,12 @@ NamEditor::NamEditor(NamJUCEAudioProcessor &p)
 
   addAndMakeVisible(&topBar);
 
+  // CPU profiler overlay, hidden until asked for (settings menu or
+  // Ctrl/Cmd+Shift+P); it comes to the front when shown
+  addChildComponent(profilerOverlay);
+  topBar.onToggleProfiler = [this] { profilerOverlay.toggle(); };
+  setWantsKeyboardFocus(true);
+
   setupPageTabs();
   setKnobVisibility(); // Set initial visibility based on default page
 }
@@ -120,20 +123,20 @@ void NamEditor::paint(juce::Graphics &g) {
   g.setColour(juce::Colours::white);
   g.setFont(15.0f);
 
-  // Draw the background for the current page
+  // Draw the background for the current page, pre-scaled to the window size
   switch (currentPage) {
   case PRE_EFFECTS:
     // Use debug background (no knobs) if flag is set, otherwise use normal
     if (useDebugPreBackground)
-      g.drawImageAt(backgroundPreEffectsNoKnobs, 0, 0);
+      scaledBackgrounds.draw(g, backgroundPreEffectsNoKnobs, 0, 0);
     else
-      g.drawImageAt(backgroundPreEffects, 0, 0);
+      scaledBackgrounds.draw(g, backgroundPreEffects, 0, 0);
     break;
   case AMP:
-    g.drawImageAt(backgroundAmp, 0, 0);
+    scaledBackgrounds.draw(g, backgroundAmp, 0, 0);
     break;
   case POST_EFFECTS:
-    g.drawImageAt(backgroundPostEffects, 0, 0);
+    scaledBackgrounds.draw(g, backgroundPostEffects, 0, 0);
     break;
   }
 }
@@ -144,9 +147,32 @@ void NamEditor::resized() {
   // Preset Manager - centered between GATE and DOUBLER knobs
   // GATE ends at x=272, DOUBLER starts at x=674, centered at x=343
   pmc.setBounds(343, 82, 260, 65);
+
+  profilerOverlay.setBounds(getLocalBounds().withSizeKeepingCentre(600, 380));
 }
 
-void NamEditor::timerCallback() {}
+bool NamEditor::keyPressed(const juce::KeyPress &key) {
+  const auto shortcut =
+      juce::KeyPress('p', juce::ModifierKeys::commandModifier |
+                              juce::ModifierKeys::shiftModifier,
+                     0);
+
+  if (key == shortcut) {
+    profilerOverlay.toggle();
+    return true;
+  }
+
+  return false;
+}
+
+void NamEditor::timerCallback() {
+  meterReader.update(audioProcessor.getMeterRing(), 1.0f / meterRefreshHz);
+
+  const auto &in = meterReader.get(MeterFrame::Input);
+  const auto &out = meterReader.get(MeterFrame::Output);
+  meterIn.setLevel(in.rms, in.peakHold);
+  meterOut.setLevel(out.rms, out.peakHold);
+}
 
 void NamEditor::sliderValueChanged(juce::Slider *slider) {
   // Update value labels whenever any slider changes
@@ -154,20 +180,10 @@ void NamEditor::sliderValueChanged(juce::Slider *slider) {
 }
 
 void NamEditor::setMeterPosition() {
-  // Meter bar color (the moving part) - 717171
-  meterlnf.setColour(foleys::LevelMeter::lmMeterGradientLowColour,
-                     juce::Colour::fromString("FF717171"));
-  // Set high gradient to same color to avoid gradient effect
-  meterlnf.setColour(foleys::LevelMeter::lmMeterGradientMidColour,
-                     juce::Colour::fromString("FF717171"));
-  // Outline - transparent for clean look
-  meterlnf.setColour(foleys::LevelMeter::lmMeterOutlineColour,
-                     juce::Colours::transparentWhite);
-  // Background color - D7D7D7
-  meterlnf.setColour(foleys::LevelMeter::lmMeterBackgroundColour,
-                     juce::Colour::fromString("FFD7D7D7"));
-  meterIn.setLookAndFeel(&meterlnf);
-  meterOut.setLookAndFeel(&meterlnf);
+  // Meter bar color (the moving part) - 717171, background - D7D7D7
+  for (auto *meter : {&meterIn, &meterOut})
+    meter->setColours(juce::Colour::fromString("FF717171"),
+                      juce::Colour::fromString("FFD7D7D7"));
 
   int meterHeight = 115;
   int meterWidth = 14;
@@ -472,11 +488,11 @@ void NamEditor::setupPageTabs() {
   postEffectsPage = std::make_unique<juce::ImageButton>("PostEffectsPage");
 
   // Load and set tab icons
-  juce::Image preIcon = juce::ImageFileFormat::loadFrom(
+  juce::Image preIcon = sharedImages->get(
       BinaryData::PreIcon_png, BinaryData::PreIcon_pngSize);
-  juce::Image ampIcon = juce::ImageFileFormat::loadFrom(
+  juce::Image ampIcon = sharedImages->get(
       BinaryData::AmpIcon_png, BinaryData::AmpIcon_pngSize);
-  juce::Image postIcon = juce::ImageFileFormat::loadFrom(
+  juce::Image postIcon = sharedImages->get(
       BinaryData::PostIcon_png, BinaryData::PostIcon_pngSize);
 
   preEffectsPage->setImages(false, true, true, preIcon, 1.0f,
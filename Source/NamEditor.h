@@ -3,6 +3,8 @@
 // clang-format off
 #include "PluginProcessor.h"
 #include "MyLookAndFeel.h"
+#include "LevelMeter.h"
+#include "ProfilerOverlay.h"
 #include "TopBarComponent.h"
 #include "PresetManager/PresetManagerComponent.h"
 // clang-format on
@@ -24,6 +26,9 @@ public:
 
   void setMeterPosition();
 
+  // Ctrl/Cmd+Shift+P shows the CPU profiler
+  bool keyPressed(const juce::KeyPress &key) override;
+
   enum PluginKnobs {
     PluginInput = 0, // Independent input gain
     Input,           // NAM amp input
@@ -75,10 +80,12 @@ private:
       "DELAY_MIX_ID"};
 
   // Page background images
+  juce::SharedResourcePointer<SharedImages> sharedImages;
   juce::Image backgroundPreEffects;
   juce::Image backgroundPreEffectsNoKnobs; // Debug version without knobs
   juce::Image backgroundAmp;
   juce::Image backgroundPostEffects;
+  ScaledImageCache scaledBackgrounds;
 
   // Debug flag: set to true to show background without knobs for positioning
   bool useDebugPreBackground = false;
@@ -102,12 +109,14 @@ private:
 
   int screensOffset = 46;
 
-  foleys::LevelMeter meterIn{foleys::LevelMeter::SingleChannel},
-      meterOut{foleys::LevelMeter::SingleChannel};
-  MeterLookAndFeel meterlnf, meterlnf2;
+  // Fed from the processor's meter ring at frame rate
+  MeterReader meterReader;
+  LevelMeter meterIn, meterOut;
+  static constexpr int meterRefreshHz = 30;
 
   TopBarComponent topBar;
   PresetManagerComponent pmc;
+  ProfilerOverlay profilerOverlay;
   juce::Label knobLabels[4]; // Labels for Input, Gate, Doubler, Output
   juce::Label
       knobValueLabels[4]; // Value labels for Input, Gate, Doubler, Output
@@ -1,16 +1,43 @@
 #include "NeuralAmpModeler.h"
+#include "Waveshapers.h"
 #include "json.hpp"
 #include <filesystem>
 #include <iostream>
+#include <mutex>
+
+namespace {
+// Tanh activation backed by the shared vectorized rational tanh.
+// Registered over NAM's "Tanh"/"Fasttanh" entries so every layer built after
+// install() picks it up instead of the scalar per-element loop.
+class VectorizedTanhActivation : public nam::activations::Activation {
+public:
+  void apply(float *data, long size) override {
+    waveshapers::process(waveshapers::Shape::RationalTanh, data, (int)size);
+  }
+
+  // NAM's activation table is process-wide and unguarded, and hosts may
+  // construct instances on several threads at once: write it only once
+  static void install() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+      static VectorizedTanhActivation instance;
+      nam::activations::Activation::enable_fast_tanh();
+      _activations["Tanh"] = &instance;
+      _activations["Fasttanh"] = &instance;
+    });
+  }
+};
+} // namespace
 
 NeuralAmpModeler::NeuralAmpModeler() {
   mToneStack = std::make_unique<dsp::tone_stack::BasicNamToneStack>();
-  nam::activations::Activation::enable_fast_tanh();
-
-  mNoiseGateTrigger.AddListener(&mNoiseGateGain);
+  VectorizedTanhActivation::install();
 }
 
-NeuralAmpModeler::~NeuralAmpModeler() {}
+NeuralAmpModeler::~NeuralAmpModeler() {
+  delete mStagedModel.exchange(nullptr);
+  releaseRetiredModels();
+}
 
 void NeuralAmpModeler::prepare(juce::dsp::ProcessSpec &spec) {
   this->sampleRate = spec.sampleRate;
@@ -18,75 +45,168 @@ void NeuralAmpModeler::prepare(juce::dsp::ProcessSpec &spec) {
 
   outputBuffer.setSize(1, spec.maximumBlockSize, false, false, false);
   outputBuffer.clear();
+  incomingResamplerBuffer.setSize(1, spec.maximumBlockSize, false, false,
+                                  false);
 
+  releaseRetiredModels();
   resetModel();
+  resamplerWarmSamples =
+      juce::jmax(1, (int)(resamplerWarmSeconds * this->sampleRate));
+  resamplerFadeSamples =
+      juce::jmax(1, (int)(resamplerFadeSeconds * this->sampleRate));
+  sleepFadeStep =
+      1.0f / (float)juce::jmax(1, (int)(sleepFadeSeconds * this->sampleRate));
+  sleepGain = 1.0f;
+  snapResampler();
   mToneStack->Reset(this->sampleRate, this->samplesPerBlock);
 
   mNoiseGateTrigger.SetSampleRate(this->sampleRate);
+
+  // The gate sizes its buffers on the first block of each new size. Run one
+  // silent block of the largest size now, so smaller and equal blocks later
+  // never allocate on the audio thread.
+  float *silence = outputBuffer.getWritePointer(0);
+  mNoiseGateTrigger.Process(&silence, 1, this->samplesPerBlock);
+  outputBuffer.clear();
+
+  // Receptive field in host samples (44.1k is the lowest native model rate,
+  // so this errs long) plus one block of margin for the resampler
+  inputSilence.setHoldSamples(
+      (int)std::ceil(receptiveFieldSeconds * this->sampleRate) +
+      this->samplesPerBlock);
+  inputSilence.reset();
 }
 
 void NeuralAmpModeler::processBlock(juce::AudioBuffer<float> &buffer) {
   this->applyDSPStaging();
-  this->updateParameters();
 
+  // Skip the model, gate and tone stack entirely while idle, once the
+  // output has faded out
+  const bool inputSilent = SilenceDetector::isSilent(buffer);
+  if (inputSilence.canSkip(inputSilent) && sleepGain == 0.0f) {
+    // Nothing to fade while asleep
+    snapResampler();
+    buffer.clear();
+    return;
+  }
+
+  const int numSamples = buffer.getNumSamples();
   auto *channelDataLeft = buffer.getWritePointer(0);
   auto *channelDataRight = buffer.getWritePointer(1);
   auto *outputData = outputBuffer.getWritePointer(0);
 
-  float **inputPointer = &channelDataLeft;
-  float **outputPointer = &outputData;
-  float **processedOutput;
-  float **triggerOutput = inputPointer;
-
-  if (noiseGateActive) // Process gate trigger
-    triggerOutput =
-        mNoiseGateTrigger.Process(inputPointer, 1, buffer.getNumSamples());
+  if (noiseGateActive) { // Process gate trigger
+    StageProfiler::Scope scope(profiler, gateStage);
+    mNoiseGateTrigger.Process(&channelDataLeft, 1, numSamples);
+  }
 
+  const float *modelOutput = channelDataLeft;
   if (mModel != nullptr) {
-    // Input Gain
-    buffer.applyGain(dB_to_linear(params[Parameters::kInputLevel]->load()));
+    StageProfiler::Scope scope(profiler, ampStage);
+
+    // Input Gain, on the one channel the model reads
+    juce::FloatVectorOperations::multiply(channelDataLeft, inputGain,
+                                          numSamples);
+
+    // A change mid-warm back to the live resampler ends the switch; one
+    // mid-fade waits for the fade
+    if (resamplerSwitch != ResamplerSwitch::Crossfading) {
+      if (mModel->IsFastResampling() == fastResampling) {
+        resamplerSwitch = ResamplerSwitch::Idle;
+      } else if (resamplerSwitch == ResamplerSwitch::Idle) {
+        resamplerSwitch = ResamplerSwitch::Warming;
+        resamplerSwitchSamplesLeft = resamplerWarmSamples;
+      }
+    }
 
-    mModel->process(*inputPointer, *outputPointer, buffer.getNumSamples());
-    mModel->finalize_(buffer.getNumSamples());
+    if (resamplerSwitch == ResamplerSwitch::Idle) {
+      mModel->process(channelDataLeft, outputData, numSamples);
+      mModel->finalize_(numSamples);
+    } else {
+      processResamplerSwitch(channelDataLeft, outputData, numSamples);
+    }
 
-    processedOutput = outputPointer;
-  } else {
-    processedOutput = inputPointer;
+    modelOutput = outputData;
   }
 
-  // Apply the noise gate
-  float **gateGainOutput =
-      noiseGateActive
-          ? mNoiseGateGain.Process(processedOutput, 1, buffer.getNumSamples())
-          : processedOutput;
+  // Everything after the model in one pass: gate gain, tone stack, output
+  // gain and the dual mono write-out. The gate is timed with the tone stack
+  // here, as the two are no longer separable.
+  {
+    StageProfiler::Scope scope(profiler, toneStackStage);
+
+    const float gain = outputGain;
+    const auto write = [=](int i, float y) {
+      channelDataLeft[i] = gain * y;
+      channelDataRight[i] = gain * y;
+    };
+
+    if (noiseGateActive) {
+      const float *gainReductionDB =
+          mNoiseGateTrigger.GetGainReductionDBData(0);
+      mToneStack->ProcessMono(
+          numSamples,
+          [=](int i) {
+            // Fully open most of the time while playing
+            const float db = gainReductionDB[i];
+            return db == 0.0f ? modelOutput[i]
+                              : modelOutput[i] * dbToGain(db);
+          },
+          write);
+    } else {
+      mToneStack->ProcessMono(
+          numSamples, [=](int i) { return modelOutput[i]; }, write);
+    }
+  }
 
-  // Tone Stack
-  float **toneStackOutPointers =
-      mToneStack->Process(gateGainOutput, 1, buffer.getNumSamples());
-  doDualMono(buffer, toneStackOutPointers);
+  // Output is not watched: a model can emit a DC offset on silence
+  inputSilence.update(inputSilent, true, buffer.getNumSamples());
+  fadeSleep(buffer);
+}
 
-  // Output Gain
-  buffer.applyGain(dB_to_linear(params[Parameters::kOutputLevel]->load()));
+void NeuralAmpModeler::fadeSleep(juce::AudioBuffer<float> &buffer) {
+  const float target = inputSilence.isAsleep() ? 0.0f : 1.0f;
+  if (sleepGain == target)
+    return;
+
+  // Per sample, as PedalBypass fades, so short blocks carry it on
+  const float step = target > sleepGain ? sleepFadeStep : -sleepFadeStep;
+  float g = sleepGain;
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto *x = buffer.getWritePointer(ch);
+    g = sleepGain;
+    for (int i = 0; i < buffer.getNumSamples(); ++i) {
+      g = juce::jlimit(0.0f, 1.0f, g + step);
+      x[i] *= g;
+    }
+  }
+  sleepGain = g;
 }
 
 bool NeuralAmpModeler::loadModel(const std::string modelPath) {
+  // Free the models the audio thread swapped out, here on the message
+  // thread
+  releaseRetiredModels();
+
   try {
     auto dspPath = std::filesystem::u8path(modelPath);
-    std::unique_ptr<nam::DSP> model = nam::get_dsp(dspPath);
-    std::unique_ptr<ResamplingNAM> temp =
+    auto loaded = std::make_unique<LoadedModel>();
+    std::unique_ptr<nam::DSP> model =
+        modelRegistry->build(dspPath, loaded->config);
+    loaded->dsp =
         std::make_unique<ResamplingNAM>(std::move(model), this->sampleRate);
 
-    temp->Reset(this->sampleRate, this->samplesPerBlock);
+    loaded->dsp->Reset(this->sampleRate, this->samplesPerBlock);
+    modelLatency = loaded->dsp->GetModelLatency();
 
-    mStagedModel = std::move(temp);
+    // A model staged earlier and not yet taken is ours to free
+    delete mStagedModel.exchange(loaded.release());
 
     return true;
   } catch (std::runtime_error &e) {
-    if (mStagedModel != nullptr) {
-      mStagedModel = nullptr;
-    }
+    delete mStagedModel.exchange(nullptr);
+    modelLatency = 0;
 
-    std::cout << "woops" << std::endl;
     std::cerr << "Failed to read DSP module" << std::endl;
     std::cerr << e.what() << std::endl;
 
@@ -144,52 +264,163 @@ bool NeuralAmpModeler::loadModelFromMemory(const void *data, const int size) {
 
 bool NeuralAmpModeler::isModelLoaded() { return this->modelLoaded; }
 
-void NeuralAmpModeler::clearModel() { this->shouldRemoveModel = true; }
+void NeuralAmpModeler::clearModel() {
+  delete mStagedModel.exchange(nullptr);
+  shouldRemoveModel = true;
+  modelLatency = 0;
+}
 
 void NeuralAmpModeler::applyDSPStaging() {
-  // Remove marked modules
-  if (shouldRemoveModel) {
-    mModel = nullptr;
+  // Remove marked modules, once there is room to hand them back
+  if (shouldRemoveModel.load(std::memory_order_acquire) && retireModel()) {
     shouldRemoveModel = false;
+    modelLoaded = false;
     //_UpdateLatency();
   }
 
-  // Move things from staged to live
-  if (mStagedModel != nullptr) {
-    // Move from staged to active DSP
-    mModel = std::move(mStagedModel);
-    mStagedModel = nullptr;
+  // Move things from staged to live; the model stays staged until the live
+  // one can be retired
+  if (mStagedModel.load(std::memory_order_relaxed) == nullptr ||
+      !retireModel())
+    return;
+
+  if (auto *staged = mStagedModel.exchange(nullptr)) {
+    mLiveModel.reset(staged); // mLiveModel was empty: retired above
+    mModel = mLiveModel->dsp.get();
+    snapResampler();
     modelLoaded = true;
+    inputSilence.reset();
     //_UpdateLatency();
   }
 }
 
-void NeuralAmpModeler::resetModel() {
-  if (mStagedModel != nullptr)
-    mStagedModel->Reset(this->sampleRate, this->samplesPerBlock);
+void NeuralAmpModeler::setFastResampling(bool shouldUseFast) {
+  if (shouldUseFast == fastResampling)
+    return;
 
-  else if (mModel != nullptr)
+  fastResampling = shouldUseFast;
+
+  // Nothing is heard from the model: swap at once. Otherwise the next
+  // block starts warming the incoming resampler.
+  if (mModel == nullptr || isAsleep())
+    snapResampler();
+}
+
+void NeuralAmpModeler::snapResampler() {
+  if (mModel != nullptr)
+    mModel->SetFastResampling(fastResampling);
+  resamplerSwitch = ResamplerSwitch::Idle;
+}
+
+void NeuralAmpModeler::processResamplerSwitch(float *input, float *output,
+                                              int numSamples) {
+  auto *incoming = incomingResamplerBuffer.getWritePointer(0);
+  mModel->ProcessBoth(input, output, incoming, numSamples);
+  mModel->finalize_(numSamples);
+
+  if (resamplerSwitch == ResamplerSwitch::Warming) {
+    resamplerSwitchSamplesLeft -= numSamples;
+    if (resamplerSwitchSamplesLeft <= 0) {
+      resamplerSwitch = ResamplerSwitch::Crossfading;
+      resamplerSwitchSamplesLeft = resamplerFadeSamples;
+    }
+    return;
+  }
+
+  // Linear crossfade; the incoming resampler goes live from the next block
+  const int fadeLength = juce::jmin(numSamples, resamplerSwitchSamplesLeft);
+  const float startGain = 1.0f - (float)resamplerSwitchSamplesLeft /
+                                     (float)resamplerFadeSamples;
+  const float endGain =
+      1.0f - (float)(resamplerSwitchSamplesLeft - fadeLength) /
+                 (float)resamplerFadeSamples;
+
+  outputBuffer.applyGainRamp(0, 0, fadeLength, 1.0f - startGain,
+                             1.0f - endGain);
+  outputBuffer.addFromWithRamp(0, 0, incoming, fadeLength, startGain,
+                               endGain);
+  if (fadeLength < numSamples)
+    outputBuffer.copyFrom(0, fadeLength, incomingResamplerBuffer, 0,
+                          fadeLength, numSamples - fadeLength);
+
+  // The one faded to goes live, even if the choice has changed back since:
+  // the next block then starts over towards it
+  resamplerSwitchSamplesLeft -= fadeLength;
+  if (resamplerSwitchSamplesLeft == 0) {
+    mModel->SetFastResampling(!mModel->IsFastResampling());
+    resamplerSwitch = ResamplerSwitch::Idle;
+  }
+}
+
+bool NeuralAmpModeler::retireModel() {
+  if (mLiveModel == nullptr)
+    return true;
+
+  // Queued, not destroyed: freeing a model here would deallocate on the
+  // audio thread
+  const auto scope = retiredFifo.write(1);
+  if (scope.blockSize1 == 0)
+    return false;
+
+  retiredModels[(size_t)scope.startIndex1] = mLiveModel.release();
+  mModel = nullptr;
+  resamplerSwitch = ResamplerSwitch::Idle;
+  return true;
+}
+
+void NeuralAmpModeler::releaseRetiredModels() {
+  const auto scope = retiredFifo.read(retiredFifo.getNumReady());
+
+  for (int i = 0; i < scope.blockSize1; ++i)
+    delete retiredModels[(size_t)(scope.startIndex1 + i)];
+  for (int i = 0; i < scope.blockSize2; ++i)
+    delete retiredModels[(size_t)(scope.startIndex2 + i)];
+}
+
+void NeuralAmpModeler::resetModel() {
+  // The audio thread is stopped while the host prepares
+  if (auto *staged = mStagedModel.load()) {
+    staged->dsp->Reset(this->sampleRate, this->samplesPerBlock);
+    modelLatency = staged->dsp->GetModelLatency();
+  } else if (mModel != nullptr) {
     mModel->Reset(this->sampleRate, this->samplesPerBlock);
+    modelLatency = mModel->GetModelLatency();
+  }
 }
 
-void NeuralAmpModeler::updateParameters() {
+void NeuralAmpModeler::setParameters(const ParameterSnapshot &snapshot) {
+  using P = ParameterSnapshot;
 
-  // Noise Gate
-  noiseGateActive = int(params[Parameters::kNoiseGateThreshold]->load()) < -100
-                        ? false
-                        : true;
+  const auto toneMask =
+      P::bit(toneIDs.bass) | P::bit(toneIDs.middle) | P::bit(toneIDs.treble);
+  if (!snapshot.changed(P::ampMask | toneMask))
+    return;
+
+  if (snapshot.changed(P::AmpInput))
+    inputGain = (float)dB_to_linear(snapshot[P::AmpInput]);
+
+  if (snapshot.changed(P::AmpOutput))
+    outputGain = (float)dB_to_linear(snapshot[P::AmpOutput]);
+
+  // Only the band whose knob moved is recomputed
+  if (snapshot.changed(toneIDs.bass))
+    mToneStack->SetBass(snapshot[toneIDs.bass]);
+  if (snapshot.changed(toneIDs.middle))
+    mToneStack->SetMiddle(snapshot[toneIDs.middle]);
+  if (snapshot.changed(toneIDs.treble))
+    mToneStack->SetTreble(snapshot[toneIDs.treble]);
 
-  mToneStack->SetParam("bass", params[Parameters::kToneBass]->load());
-  mToneStack->SetParam("middle", params[Parameters::kToneMid]->load());
-  mToneStack->SetParam("treble", params[Parameters::kToneTreble]->load());
+  // Noise Gate
+  if (snapshot.changed(P::NoiseGate)) {
+    noiseGateActive = int(snapshot[P::NoiseGate]) < -100 ? false : true;
 
-  if (noiseGateActive) {
-    const dsp::noise_gate::TriggerParams triggerParams(
-        this->ns_time, params[Parameters::kNoiseGateThreshold]->load(),
-        this->ns_ratio, this->ns_openTime, this->ns_holdTime,
-        this->ns_closeTime);
+    if (noiseGateActive) {
+      const dsp::noise_gate::TriggerParams triggerParams(
+          this->ns_time, snapshot[P::NoiseGate], this->ns_ratio,
+          this->ns_openTime, this->ns_holdTime, this->ns_closeTime);
 
-    mNoiseGateTrigger.SetParams(triggerParams);
+      mNoiseGateTrigger.SetParams(triggerParams);
+    }
   }
 }
 
@@ -211,30 +442,6 @@ void NeuralAmpModeler::createParameters(
   DBG("NAM Parameters Created!");
 }
 
-void NeuralAmpModeler::hookParameters(
-    juce::AudioProcessorValueTreeState &apvts) {
-  params[Parameters::kInputLevel] = apvts.getRawParameterValue("INPUT_ID");
-  params[Parameters::kNoiseGateThreshold] =
-      apvts.getRawParameterValue("NGATE_ID");
-  params[Parameters::kToneBass] = apvts.getRawParameterValue("BASS_ID");
-  params[Parameters::kToneMid] = apvts.getRawParameterValue("MIDDLE_ID");
-  params[Parameters::kToneTreble] = apvts.getRawParameterValue("TREBLE_ID");
-  params[Parameters::kOutputLevel] = apvts.getRawParameterValue("OUTPUT_ID");
-
-  DBG("NAM Parameters Hooked!");
-}
-
 double NeuralAmpModeler::dB_to_linear(double db_value) {
   return std::pow(10.0, db_value / 20.0);
 }
-
-void NeuralAmpModeler::doDualMono(juce::AudioBuffer<float> &mainBuffer,
-                                  float **input) {
-  auto channelDataLeft = mainBuffer.getWritePointer(0);
-  auto channelDataRight = mainBuffer.getWritePointer(1);
-
-  for (int sample = 0; sample < mainBuffer.getNumSamples(); ++sample) {
-    channelDataRight[sample] = input[0][sample];
-    channelDataLeft[sample] = input[0][sample];
-  }
-}
\ No newline at end of file
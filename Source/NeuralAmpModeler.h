@@ -4,7 +4,11 @@
 // #define NAM_SAMPLE_FLOAT
 // #define DSP_SAMPLE_FLOAT
 
+#include "ModelRegistry.h"
+#include "ParameterSnapshot.h"
 #include "ResamplingNAM.h"
+#include "SilenceDetector.h"
+#include "StageProfiler.h"
 #include "StatusedTrigger.h"
 #include "ToneStack.h"
 #include "architecture.hpp"
@@ -12,6 +16,9 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include <array>
+#include <atomic>
+
 class NeuralAmpModeler {
 public:
   NeuralAmpModeler();
@@ -20,46 +27,169 @@ public:
   void prepare(juce::dsp::ProcessSpec &spec);
   void processBlock(juce::AudioBuffer<float> &buffer);
 
-  // Returns true if model staged successfully
+  // Returns true if model staged successfully. Message thread; also frees
+  // the models the audio thread has swapped out since the last call.
   bool loadModel(const std::string modelPath);
   bool loadModelFromMemory(const void *data, const int size);
 
   bool isModelLoaded();
+
+  // Removes the live model from the next block on. Message thread.
   void clearModel();
 
-  void createParameters(
+  // Frees the models the audio thread has swapped out. Message thread;
+  // loadModel() and prepare() call it too.
+  void releaseRetiredModels();
+
+  // Moves a staged model to live and drops a model flagged for removal.
+  // Models leaving the audio thread go to the retired queue, never to the
+  // allocator. processBlock() calls it first; call it earlier to look at
+  // hasModel() before the block runs. Audio thread.
+  void applyDSPStaging();
+
+  // A model is live (after staging). Audio thread.
+  bool hasModel() const { return mModel != nullptr; }
+
+  static void createParameters(
       std::vector<std::unique_ptr<juce::RangedAudioParameter>> &parameters);
-  void hookParameters(juce::AudioProcessorValueTreeState &);
-
-  enum Parameters {
-    kInputLevel = 0,
-    kNoiseGateThreshold,
-    kToneBass,
-    kToneMid,
-    kToneTreble,
-    kOutputLevel,
-  };
+
+  // Pushes the amp parameters that changed in this block's snapshot
+  void setParameters(const ParameterSnapshot &snapshot);
 
   StatusedTrigger *getTrigger() { return &mNoiseGateTrigger; };
 
+  // Shorter resampling kernel around the model, kept for models staged
+  // later too. Audio thread, no allocation. The resamplers do not share
+  // their filter history, so while a model is heard the incoming one runs
+  // alongside the live one until it is warm, and the two outputs
+  // crossfade.
+  void setFastResampling(bool shouldUseFast);
+
+  // Times the gate, model and tone stack; nullptr to stop. A dual-amp
+  // chain's second amp reports under its own stages.
+  void setProfiler(StageProfiler *stageProfiler, bool isSecondAmp = false) {
+    profiler = stageProfiler;
+    gateStage = isSecondAmp ? StageProfiler::SecondGate : StageProfiler::Gate;
+    ampStage = isSecondAmp ? StageProfiler::SecondAmp : StageProfiler::Amp;
+    toneStackStage = isSecondAmp ? StageProfiler::SecondToneStack
+                                 : StageProfiler::ToneStack;
+  }
+
+  // Parameters the tone stack follows; BASS_ID, MIDDLE_ID and TREBLE_ID
+  // unless set otherwise
+  void setToneParameters(ParameterIDs::ID bass, ParameterIDs::ID middle,
+                         ParameterIDs::ID treble) {
+    toneIDs = {bass, middle, treble};
+  }
+
+  // Samples the live model's resampling delays its output by. Audio
+  // thread.
+  int getLatencySamples() const {
+    return mModel != nullptr ? mModel->GetLatency() : 0;
+  }
+
+  // Of that, what the newest model adds itself: a batched model's block
+  // (see SharedWaveNet::Batch). Any thread; what the plugin reports.
+  int getModelLatencySamples() const { return modelLatency.load(); }
+
+  // True while the model is skipped because its input has been silent,
+  // and its output has faded out
+  bool isAsleep() const {
+    return inputSilence.isAsleep() && sleepGain == 0.0f;
+  }
+
+  // Wakes the model so it runs from the next block on, and finishes a
+  // resampler change and any sleep fade at once. The model's own history is
+  // flushed by running it, not cleared here. No allocation.
+  void reset() {
+    inputSilence.reset();
+    sleepGain = 1.0f;
+    snapResampler();
+  }
+
+  // Receptive field of the baked model at its native rate. Once the input
+  // has been silent this long the model's history is all zeros, so it can
+  // be skipped and woken again without a discontinuity.
+  static constexpr int receptiveFieldSamples = 4096;
+  static constexpr double receptiveFieldSeconds =
+      receptiveFieldSamples / 44100.0;
+
 private:
   double sampleRate;
   int samplesPerBlock;
   juce::AudioBuffer<float> outputBuffer;
 
-  // Parameter Pointers
-  std::atomic<float> *params[6];
+  // Cached from the parameter snapshot, linear gains
+  float inputGain{1.0f};
+  float outputGain{1.0f};
   bool noiseGateActive{false};
+  bool fastResampling{false};
+
+  // Resampler change under way: the incoming resampler warms up on the
+  // live one's model output, then the two crossfade
+  enum class ResamplerSwitch { Idle, Warming, Crossfading };
+  ResamplerSwitch resamplerSwitch{ResamplerSwitch::Idle};
+  int resamplerSwitchSamplesLeft{0};
+  int resamplerWarmSamples{1};
+  int resamplerFadeSamples{1};
+  juce::AudioBuffer<float> incomingResamplerBuffer;
+
+  static constexpr double resamplerWarmSeconds = 0.005;
+  static constexpr double resamplerFadeSeconds = 0.005;
+
+  // Output fades out as the model falls asleep and in as it wakes: a model
+  // with a DC offset or a noise floor would step otherwise. 0 while asleep.
+  float sleepGain{1.0f};
+  float sleepFadeStep{1.0f};
+
+  static constexpr double sleepFadeSeconds = 0.005;
+
+  std::atomic<bool> modelLoaded{false};
+  std::atomic<int> modelLatency{0};
+  std::atomic<bool> shouldRemoveModel{false};
+
+  // A model with the shared registry entry it was built from, which has to
+  // outlive it
+  struct LoadedModel {
+    std::unique_ptr<ResamplingNAM> dsp;
+    ModelRegistry::Config config;
+  };
+
+  // Parsed model files are shared by every instance in the process
+  juce::SharedResourcePointer<ModelRegistry> modelRegistry;
 
-  bool modelLoaded{false};
-  bool shouldRemoveModel{false};
+  // Model handoff, single producer each way and no locks:
+  // - the message thread swaps a new model into mStagedModel; the audio
+  //   thread takes it with an exchange and owns it as mModel
+  // - a model the audio thread drops goes into the retired queue, drained
+  //   and freed on the message thread
+  // The audio thread leaves a model staged while the queue is full.
+  std::atomic<LoadedModel *> mStagedModel{nullptr};
+  std::unique_ptr<LoadedModel> mLiveModel;
+  ResamplingNAM *mModel{nullptr}; // mLiveModel->dsp, or nullptr
 
-  std::unique_ptr<ResamplingNAM> mModel, mStagedModel;
-  std::unique_ptr<dsp::tone_stack::AbstractToneStack> mToneStack;
+  static constexpr int retiredCapacity = 8;
+  juce::AbstractFifo retiredFifo{retiredCapacity};
+  std::array<LoadedModel *, retiredCapacity> retiredModels{};
+
+  std::unique_ptr<dsp::tone_stack::BasicNamToneStack> mToneStack;
+
+  // Sleeps the model while the input is silent
+  SilenceDetector inputSilence;
+
+  StageProfiler *profiler{nullptr};
+  StageProfiler::Stage gateStage{StageProfiler::Gate};
+  StageProfiler::Stage ampStage{StageProfiler::Amp};
+  StageProfiler::Stage toneStackStage{StageProfiler::ToneStack};
+
+  struct ToneIDs {
+    ParameterIDs::ID bass, middle, treble;
+  };
+  ToneIDs toneIDs{ParameterIDs::Bass, ParameterIDs::Middle,
+                  ParameterIDs::Treble};
 
   // Noise gate
   StatusedTrigger mNoiseGateTrigger;
-  dsp::noise_gate::Gain mNoiseGateGain;
 
   // Noise gate Params
   const double ns_time = 0.01;
@@ -69,17 +199,29 @@ private:
   const double ns_closeTime = 0.05;
 
 private:
-  // Moves DSP modules from staging area to the main area.
-  // Also deletes DSP modules that are flagged for removal.
-  // Exists so that we don't try to use a DSP module that's only
-  // partially-instantiated.
-  void applyDSPStaging();
+
+  // Audio thread: moves the live model to the retired queue. False, and
+  // nothing moved, if the queue is full.
+  bool retireModel();
 
   void resetModel();
 
-  void updateParameters();
+  // Puts the live model on fastResampling now, ending any fade
+  void snapResampler();
+
+  // Runs the model through both resamplers, and crossfades to the
+  // incoming one once it is warm
+  void processResamplerSwitch(float *input, float *output, int numSamples);
+
+  // Ramps the finished block towards silence while asleep, or back up
+  void fadeSleep(juce::AudioBuffer<float> &buffer);
+
   double dB_to_linear(double db_value);
-  void doDualMono(juce::AudioBuffer<float> &mainBuffer, float **input);
+
+  // Per-sample gate gain; exp2 is much cheaper than pow
+  static float dbToGain(float db) {
+    return std::exp2(db * 0.16609640474436813f); // log2(10) / 20
+  }
 };
 
 #endif
\ No newline at end of file
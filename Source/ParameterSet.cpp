@@ -0,0 +1,71 @@
+#include "ParameterSet.h"
+
+ParameterSet::ParameterSet(juce::AudioProcessorValueTreeState &apvts)
+    : apvts(apvts) {
+  const auto &all = apvts.processor.getParameters();
+  params.reserve((size_t)all.size());
+  values.reserve((size_t)all.size());
+
+  for (auto *p : all) {
+    auto *param = dynamic_cast<juce::RangedAudioParameter *>(p);
+    params.push_back(param);
+    values.push_back(p->getValue());
+  }
+}
+
+bool ParameterSet::set(const juce::String &paramID, float value) {
+  auto *param = apvts.getParameter(paramID);
+  if (param == nullptr) {
+    DBG("Unknown parameter in set: " + paramID);
+    return false;
+  }
+
+  set(*param, value);
+  return true;
+}
+
+void ParameterSet::set(juce::RangedAudioParameter &param, float value) {
+  const int index = param.getParameterIndex();
+  jassert(index >= 0 && index < (int)values.size());
+
+  // Corrupt preset or session data: keep what we have
+  if (!std::isfinite(value))
+    return;
+
+  const auto &range = param.getNormalisableRange();
+  const float legal =
+      range.snapToLegalValue(juce::jlimit(range.start, range.end, value));
+  values[(size_t)index] = range.convertTo0to1(legal);
+}
+
+float ParameterSet::get(const juce::String &paramID) const {
+  auto *param = apvts.getParameter(paramID);
+  if (param == nullptr)
+    return 0.0f;
+
+  return param->convertFrom0to1(values[(size_t)param->getParameterIndex()]);
+}
+
+void ParameterSet::setFromState(const juce::ValueTree &state) {
+  for (const auto &child : state) {
+    if (child.hasType("PARAM"))
+      set(child.getProperty("id").toString(),
+          (float)child.getProperty("value"));
+  }
+}
+
+int ParameterSet::apply() const {
+  int numChanged = 0;
+
+  for (size_t i = 0; i < params.size(); ++i) {
+    auto *param = params[i];
+    if (param == nullptr ||
+        std::abs(param->getValue() - values[i]) <= 1.0e-6f)
+      continue;
+
+    param->setValueNotifyingHost(values[i]);
+    ++numChanged;
+  }
+
+  return numChanged;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * Parameter Set
+ * A complete set of parameter values, built and validated off to the side
+ * and then applied to the APVTS in one go.
+ *
+ * A set starts as a copy of the current values, so callers only fill in
+ * what they know (a preset file, the defaults, a session blob). Values are
+ * clamped and snapped to each parameter's range as they are set. apply()
+ * only touches parameters whose value actually changes.
+ *
+ * Apply through NamJUCEAudioProcessor::applyParameterSet(), which holds the
+ * audio thread's parameter snapshot for the duration, so a block sees
+ * either the old set or the new one and never a mix.
+ */
+class ParameterSet {
+public:
+  explicit ParameterSet(juce::AudioProcessorValueTreeState &apvts);
+  ~ParameterSet() {}
+
+  // Plain (denormalised) values. Returns false for unknown IDs.
+  bool set(const juce::String &paramID, float value);
+  void set(juce::RangedAudioParameter &param, float value);
+
+  // Plain value of a parameter in this set; 0 for unknown IDs
+  float get(const juce::String &paramID) const;
+
+  // Reads the PARAM children of an APVTS state tree (preset files)
+  void setFromState(const juce::ValueTree &state);
+
+  /**
+   * Pushes every changed value to its parameter. Message thread only.
+   * Returns the number of parameters that changed.
+   */
+  int apply() const;
+
+private:
+  juce::AudioProcessorValueTreeState &apvts;
+
+  // Indexed by parameter index; values are normalised
+  std::vector<juce::RangedAudioParameter *> params;
+  std::vector<float> values;
+};
@@ -0,0 +1,355 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Parameter Snapshot
+ * Flat copy of every DSP parameter, taken once per block on the audio thread,
+ * plus a bitmask of what changed since the previous block.
+ *
+ * Parameter atomics are looked up by ID string once, in hook(). After that
+ * the audio thread only indexes arrays. Each stage tests its group mask and
+ * skips its setters (and any coefficient recalculation) when none of its
+ * inputs changed.
+ *
+ * Continuous knobs (rampedMask) are not applied as steps. A change starts a
+ * linear ramp that ends at the end of the host block, or after
+ * minRampSeconds if that is longer. While anything ramps, the processor
+ * splits the block into sub-blocks and calls advance() before each one, so
+ * stages see a block-rate ramp instead of running per-sample smoothers.
+ *
+ * A snapshot can follow a Cue instead of the parameters: the processor's
+ * standby chain runs on the preset it expects to be switched to next.
+ */
+
+// Index of every DSP parameter in the snapshot
+struct ParameterIDs {
+  enum ID : int {
+    // Plugin input/output gain
+    PluginInput = 0,
+    PluginOutput,
+
+    // Amp
+    AmpInput,
+    NoiseGate,
+    Bass,
+    Middle,
+    Treble,
+    AmpOutput,
+
+    // Tube Screamer
+    TsDrive,
+    TsTone,
+    TsLevel,
+    TsEnabled,
+
+    // Klon Centaur
+    KlonGain,
+    KlonTreble,
+    KlonLevel,
+    KlonEnabled,
+
+    // Compressor
+    CompVolume,
+    CompAttack,
+    CompSustain,
+    CompEnabled,
+
+    // Clean Boost
+    BoostVolume,
+    BoostEnabled,
+
+    // Chorus
+    ChorusRate,
+    ChorusDepth,
+    ChorusMix,
+    ChorusEnabled,
+
+    // Doubler
+    DoublerSpread,
+
+    // Reverb
+    ReverbMix,
+    ReverbTone,
+    ReverbSize,
+    ReverbEnabled,
+
+    // Delay
+    DelayTime,
+    DelayFeedback,
+    DelayMix,
+    DelayEnabled,
+
+    // Pre-amp pedal order, an index into ExecutionPlan's orderings
+    PedalOrder,
+
+    // Dual amp: share of the second amp in the blend, and its tone stack
+    AmpBlend,
+    Amp2Bass,
+    Amp2Middle,
+    Amp2Treble,
+
+    NumParams
+  };
+
+  using Mask = uint64_t;
+  static_assert(NumParams <= 64, "Mask is too narrow for the parameter set");
+
+  static constexpr Mask bit(ID id) { return Mask(1) << id; }
+
+  // Bits first..last inclusive
+  static constexpr Mask range(ID first, ID last) {
+    return ((Mask(1) << (last - first + 1)) - 1) << first;
+  }
+
+  static const char *getParameterID(ID id);
+};
+
+class ParameterSnapshot : public ParameterIDs {
+public:
+  static constexpr Mask allMask = (Mask(1) << NumParams) - 1;
+
+  // Per-stage groups. Enabled switches are read directly, not dispatched.
+  static constexpr Mask gainMask = range(PluginInput, PluginOutput);
+  static constexpr Mask ampMask = range(AmpInput, AmpOutput);
+  static constexpr Mask tsMask = range(TsDrive, TsLevel);
+  static constexpr Mask klonMask = range(KlonGain, KlonLevel);
+  static constexpr Mask compMask = range(CompVolume, CompSustain);
+  static constexpr Mask boostMask = bit(BoostVolume);
+  static constexpr Mask chorusMask = range(ChorusRate, ChorusMix);
+  static constexpr Mask doublerMask = bit(DoublerSpread);
+  static constexpr Mask reverbMask = range(ReverbMix, ReverbSize);
+  static constexpr Mask delayMask = range(DelayTime, DelayMix);
+  static constexpr Mask routingMask = bit(PedalOrder);
+  static constexpr Mask blendMask = bit(AmpBlend);
+  static constexpr Mask amp2ToneMask = range(Amp2Bass, Amp2Treble);
+
+  // Knobs that ramp across sub-blocks. Everything else (switches, gate
+  // threshold, and stages that already smooth internally) is applied as a
+  // step.
+  static constexpr Mask rampedMask =
+      bit(AmpInput) | range(Bass, AmpOutput) | tsMask | klonMask |
+      bit(CompVolume) | boostMask | blendMask | amp2ToneMask;
+
+  // Granularity of the sub-block split while ramping
+  static constexpr int subBlockSize = 64;
+  static constexpr double minRampSeconds = 0.05;
+
+  /**
+   * Parameter values published from one thread, for a snapshot to follow
+   * in place of the APVTS. Written inside a bulk change bracket of its own.
+   */
+  struct Cue {
+    std::array<std::atomic<float>, NumParams> values{};
+    std::atomic<uint32_t> generation{0};
+
+    void beginChange() { generation.fetch_add(1, std::memory_order_acq_rel); }
+    void endChange() { generation.fetch_add(1, std::memory_order_release); }
+  };
+
+  ParameterSnapshot() {}
+  ~ParameterSnapshot() {}
+
+  /**
+   * Resolve the parameter atomics. Call once, from the processor constructor.
+   */
+  void hook(juce::AudioProcessorValueTreeState &apvts) {
+    for (int i = 0; i < NumParams; ++i) {
+      hostSources[i] = apvts.getRawParameterValue(getParameterID((ID)i));
+      jassert(hostSources[i] != nullptr);
+      targets[i] = values[i] = hostSources[i]->load();
+    }
+    sources = hostSources;
+    markAllDirty();
+  }
+
+  /**
+   * Follow a cue's values from the next update() on, or the parameters
+   * again with nullptr. Audio thread; changes ramp or step as usual. Other
+   * threads must not call getLive() on a snapshot that switches.
+   */
+  void follow(Cue *cue) {
+    if (cue == nullptr) {
+      sources = hostSources;
+      bulkGeneration = hostBulkGeneration;
+      return;
+    }
+
+    for (int i = 0; i < NumParams; ++i)
+      sources[i] = &cue->values[(size_t)i];
+    bulkGeneration = &cue->generation;
+  }
+
+  void prepare(double sampleRate) {
+    minRampSamples = juce::jmax(1, (int)(sampleRate * minRampSeconds));
+  }
+
+  /**
+   * Force every parameter to be dispatched on the next update(), e.g. after
+   * the stages have been re-prepared.
+   */
+  void markAllDirty() { forced = allMask; }
+
+  /**
+   * Take this block's snapshot. Stepped parameters are applied at once;
+   * ramped ones start (or retarget) a ramp. Returns the mask of parameters
+   * that changed value now.
+   */
+  Mask update(int numSamples) {
+    Mask changed = 0;
+
+    // Read everything, then keep it only if no bulk change overlapped
+    const auto generation = bulkGeneration->load(std::memory_order_acquire);
+    for (int i = 0; i < NumParams; ++i)
+      pending[i] = sources[i]->load(std::memory_order_relaxed);
+
+    const bool consistent =
+        (generation & 1) == 0 &&
+        bulkGeneration->load(std::memory_order_acquire) == generation;
+    if (!consistent)
+      pending = targets;
+
+    for (int i = 0; i < NumParams; ++i) {
+      const Mask b = bit((ID)i);
+      const float target = pending[i];
+
+      if ((forced & b) != 0) {
+        // Snap: stages have just been prepared
+        targets[i] = values[i] = target;
+        ramping &= ~b;
+        changed |= b;
+      } else if (target != targets[i]) {
+        targets[i] = target;
+
+        if ((rampedMask & b) != 0) {
+          remaining[i] = juce::jmax(numSamples, minRampSamples);
+          steps[i] = (target - values[i]) / (float)remaining[i];
+          ramping |= b;
+        } else {
+          values[i] = target;
+          changed |= b;
+        }
+      }
+    }
+
+    forced = 0;
+    dirty = changed;
+    return changed;
+  }
+
+  /**
+   * Bracket a multi-parameter change from another thread. Blocks that start
+   * in between keep the previous snapshot, so the change lands whole at the
+   * next block boundary.
+   */
+  void beginBulkChange() {
+    bulkGeneration->fetch_add(1, std::memory_order_acq_rel);
+  }
+  void endBulkChange() {
+    bulkGeneration->fetch_add(1, std::memory_order_release);
+  }
+
+  // Let one bracket on owner cover this snapshot as well
+  void shareBulkChanges(ParameterSnapshot &owner) {
+    hostBulkGeneration = bulkGeneration = owner.bulkGeneration;
+  }
+
+  bool isRamping() const { return ramping != 0; }
+
+  /**
+   * Move all running ramps forward by one sub-block. Adds the ramped
+   * parameters to the changed mask.
+   */
+  Mask advance(int numSamples) {
+    for (int i = 0; i < NumParams; ++i) {
+      const Mask b = bit((ID)i);
+      if ((ramping & b) == 0)
+        continue;
+
+      const int n = juce::jmin(numSamples, remaining[i]);
+      remaining[i] -= n;
+      values[i] = remaining[i] > 0 ? values[i] + steps[i] * (float)n
+                                   : targets[i];
+      if (remaining[i] == 0)
+        ramping &= ~b;
+
+      dirty |= b;
+    }
+    return dirty;
+  }
+
+  // Call after each sub-block has been dispatched
+  void clearChanged() { dirty = 0; }
+
+  float operator[](ID id) const { return values[id]; }
+  bool isOn(ID id) const { return values[id] > 0.5f; }
+
+  // Did anything in the mask change in the current block?
+  bool changed(Mask mask) const { return (dirty & mask) != 0; }
+  bool changed(ID id) const { return changed(bit(id)); }
+
+  // Reads the live value of what the snapshot follows, bypassing the
+  // snapshot. Safe from any thread.
+  float getLive(ID id) const { return sources[id]->load(); }
+
+private:
+  std::array<std::atomic<float> *, NumParams> sources{};
+  std::array<std::atomic<float> *, NumParams> hostSources{};
+  std::array<float, NumParams> values{};
+  std::array<float, NumParams> pending{};
+
+  // Odd while a bulk change is being applied
+  std::atomic<uint32_t> ownBulkGeneration{0};
+  std::atomic<uint32_t> *bulkGeneration = &ownBulkGeneration;
+  std::atomic<uint32_t> *hostBulkGeneration = &ownBulkGeneration;
+
+  // Ramp state, only meaningful for rampedMask
+  std::array<float, NumParams> targets{};
+  std::array<float, NumParams> steps{};
+  std::array<int, NumParams> remaining{};
+  Mask ramping = 0;
+  int minRampSamples = 1;
+
+  Mask dirty = 0;
+  Mask forced = allMask;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterSnapshot)
+};
+
+inline const char *ParameterIDs::getParameterID(ID id) {
+  static constexpr const char *ids[NumParams] = {
+      "PLUGIN_INPUT_ID", "PLUGIN_OUTPUT_ID",
+
+      "INPUT_ID",        "NGATE_ID",        "BASS_ID",
+      "MIDDLE_ID",       "TREBLE_ID",       "OUTPUT_ID",
+
+      "TS_DRIVE_ID",     "TS_TONE_ID",      "TS_LEVEL_ID",
+      "TS_ENABLED_ID",
+
+      "KLON_GAIN_ID",    "KLON_TREBLE_ID",  "KLON_LEVEL_ID",
+      "KLON_ENABLED_ID",
+
+      "COMP_VOLUME_ID",  "COMP_ATTACK_ID",  "COMP_SUSTAIN_ID",
+      "COMP_ENABLED_ID",
+
+      "BOOST_VOLUME_ID", "BOOST_ENABLED_ID",
+
+      "CHORUS_RATE_ID",  "CHORUS_DEPTH_ID", "CHORUS_MIX_ID",
+      "CHORUS_ENABLED_ID",
+
+      "DOUBLER_SPREAD_ID",
+
+      "REVERB_MIX_ID",   "REVERB_TONE_ID",  "REVERB_SIZE_ID",
+      "REVERB_ENABLED_ID",
+
+      "DELAY_TIME_ID",   "DELAY_FEEDBACK_ID", "DELAY_MIX_ID",
+      "DELAY_ENABLED_ID",
+
+      "PEDAL_ORDER_ID",
+
+      "AMP_BLEND_ID",    "AMP2_BASS_ID",    "AMP2_MIDDLE_ID",
+      "AMP2_TREBLE_ID"};
+  return ids[id];
+}
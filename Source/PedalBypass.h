@@ -0,0 +1,186 @@
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+
+/**
+ * Pedal Bypass
+ * Click-free on/off switching for one stage of the chain, in the spirit of
+ * chowdsp::BypassProcessor.
+ *
+ * - Switching crossfades between the dry and processed signal over a few ms.
+ * - Once a stage has faded out it is asleep: processBlockIn() returns nullptr
+ *   and the caller skips both processing and parameter pushes.
+ * - onSleep is called once when the stage falls asleep, so the stage can be
+ *   reset and resume from clean filter/WDF state when switched back on.
+ * - In TailMode::Spill (delay, reverb) switching off does not fade: the stage
+ *   keeps running on silence and its tail is mixed over the dry signal until
+ *   it has decayed, then the stage falls asleep.
+ *
+ * Usage:
+ *   if (auto *target = bypass.processBlockIn(buffer, enabled)) {
+ *     pedal.setXxx(...);
+ *     pedal.process(*target);
+ *     bypass.processBlockOut(buffer);
+ *   }
+ */
+class PedalBypass {
+public:
+  enum class TailMode { Cut = 0, Spill };
+
+  PedalBypass() {}
+  ~PedalBypass() {}
+
+  void prepare(const juce::dsp::ProcessSpec &spec, bool isEnabled,
+               TailMode mode = TailMode::Cut) {
+    sampleRate = spec.sampleRate;
+    tailMode = mode;
+
+    fadeSamples = juce::jmax(1, (int)(sampleRate * fadeTimeMs / 1000.0));
+    tailHoldSamples = (int)(sampleRate * tailHoldMs / 1000.0);
+
+    dryBuffer.setSize((int)spec.numChannels, (int)spec.maximumBlockSize);
+    tailBuffer.setSize((int)spec.numChannels, (int)spec.maximumBlockSize);
+
+    gain = target = isEnabled ? 1.0f : 0.0f;
+    spilling = false;
+    silentSamples = 0;
+  }
+
+  // Jump to a state without fading; clears any spilling tail. No allocation.
+  void reset(bool isEnabled) {
+    gain = target = isEnabled ? 1.0f : 0.0f;
+    spilling = false;
+    silentSamples = 0;
+  }
+
+  /**
+   * How long the tail must stay below the threshold before a spilling stage
+   * is put to sleep. Must cover the longest gap between echoes.
+   */
+  void setTailHoldMs(double holdMs) {
+    tailHoldMs = holdMs;
+    tailHoldSamples = (int)(sampleRate * tailHoldMs / 1000.0);
+  }
+
+  /**
+   * Call at the start of the stage. Returns the buffer the stage should
+   * process, or nullptr when the stage is asleep and can be skipped.
+   */
+  juce::AudioBuffer<float> *processBlockIn(juce::AudioBuffer<float> &buffer,
+                                           bool isEnabled) {
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    target = isEnabled ? 1.0f : 0.0f;
+
+    if (tailMode == TailMode::Spill) {
+      if (!isEnabled && (gain > 0.0f || spilling)) {
+        // Keep the stage running on silence; its output is the bare tail
+        gain = 0.0f;
+        spilling = true;
+        tailBuffer.setSize(numChannels, numSamples, false, false, true);
+        tailBuffer.clear();
+        return &tailBuffer;
+      }
+
+      if (isEnabled && spilling) {
+        // Still warm, so no fade is needed
+        spilling = false;
+        silentSamples = 0;
+        gain = 1.0f;
+        return &buffer;
+      }
+    }
+
+    if (gain == 0.0f && target == 0.0f)
+      return nullptr;
+
+    if (gain != target)
+      for (int ch = 0; ch < numChannels && ch < dryBuffer.getNumChannels();
+           ++ch)
+        dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+    return &buffer;
+  }
+
+  /**
+   * Call after the stage has processed. Applies the crossfade or mixes in
+   * the spilled tail.
+   */
+  void processBlockOut(juce::AudioBuffer<float> &buffer) {
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    if (spilling) {
+      float peak = 0.0f;
+      for (int ch = 0; ch < numChannels && ch < tailBuffer.getNumChannels();
+           ++ch) {
+        buffer.addFrom(ch, 0, tailBuffer, ch, 0, numSamples);
+        peak = juce::jmax(peak, tailBuffer.getMagnitude(ch, 0, numSamples));
+      }
+
+      silentSamples = peak < tailThreshold ? silentSamples + numSamples : 0;
+      if (silentSamples >= tailHoldSamples) {
+        spilling = false;
+        silentSamples = 0;
+        sleep();
+      }
+      return;
+    }
+
+    if (gain == target)
+      return;
+
+    const float step = (target > gain ? 1.0f : -1.0f) / (float)fadeSamples;
+    float g = gain;
+
+    for (int ch = 0; ch < numChannels && ch < dryBuffer.getNumChannels();
+         ++ch) {
+      auto *x = buffer.getWritePointer(ch);
+      const auto *dry = dryBuffer.getReadPointer(ch);
+
+      g = gain;
+      for (int n = 0; n < numSamples; ++n) {
+        g = juce::jlimit(0.0f, 1.0f, g + step);
+        x[n] = dry[n] + g * (x[n] - dry[n]);
+      }
+    }
+
+    gain = g;
+    if (gain == 0.0f)
+      sleep();
+  }
+
+  bool isAsleep() const { return gain == 0.0f && target == 0.0f && !spilling; }
+
+  // Called on the audio thread when the stage falls asleep
+  std::function<void()> onSleep;
+
+private:
+  void sleep() {
+    if (onSleep)
+      onSleep();
+  }
+
+  double sampleRate = 44100.0;
+  TailMode tailMode = TailMode::Cut;
+
+  // Hardcoded crossfade / tail detection settings
+  static constexpr double fadeTimeMs = 5.0;
+  static constexpr float tailThreshold = 1.0e-4f; // -80 dB
+
+  double tailHoldMs = 100.0;
+  int fadeSamples = 1;
+  int tailHoldSamples = 0;
+
+  // 0 = dry, 1 = processed
+  float gain = 0.0f;
+  float target = 0.0f;
+
+  bool spilling = false;
+  int silentSamples = 0;
+
+  juce::AudioBuffer<float> dryBuffer;
+  juce::AudioBuffer<float> tailBuffer;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PedalBypass)
+};
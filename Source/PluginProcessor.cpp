@@ -22,52 +22,18 @@ NamJUCEAudioProcessor::NamJUCEAudioProcessor()
 #endif
               ),
       apvts(*this, nullptr, "Params", createParameters()),
-      presetManager(apvts, [this]() { applyDefaultSettings(); })
+      presetManager(
+          apvts, [this](ParameterSet &values) { fillDefaultSettings(values); },
+          [this](const ParameterSet &values) { applyParameterSet(values); },
+          [this](const ParameterSet &values) { cueParameterSet(values); }),
+      pluginState(apvts)
 #endif
 {
-  // Hook independent input/output gain parameters
-  pluginInputGain = apvts.getRawParameterValue("PLUGIN_INPUT_ID");
-  pluginOutputGain = apvts.getRawParameterValue("PLUGIN_OUTPUT_ID");
-
-  // Hook Tube Screamer parameters
-  tsDrive = apvts.getRawParameterValue("TS_DRIVE_ID");
-  tsTone = apvts.getRawParameterValue("TS_TONE_ID");
-  tsLevel = apvts.getRawParameterValue("TS_LEVEL_ID");
-  tsEnabled = apvts.getRawParameterValue("TS_ENABLED_ID");
-
-  // Hook Klon Centaur parameters
-  klonGain = apvts.getRawParameterValue("KLON_GAIN_ID");
-  klonTreble = apvts.getRawParameterValue("KLON_TREBLE_ID");
-  klonLevel = apvts.getRawParameterValue("KLON_LEVEL_ID");
-  klonEnabled = apvts.getRawParameterValue("KLON_ENABLED_ID");
-
-  // Hook Compressor parameters
-  compVolume = apvts.getRawParameterValue("COMP_VOLUME_ID");
-  compAttack = apvts.getRawParameterValue("COMP_ATTACK_ID");
-  compSustain = apvts.getRawParameterValue("COMP_SUSTAIN_ID");
-  compEnabled = apvts.getRawParameterValue("COMP_ENABLED_ID");
-
-  // Hook Clean Boost parameters
-  boostVolume = apvts.getRawParameterValue("BOOST_VOLUME_ID");
-  boostEnabled = apvts.getRawParameterValue("BOOST_ENABLED_ID");
-
-  // Hook Chorus parameters
-  chorusRate = apvts.getRawParameterValue("CHORUS_RATE_ID");
-  chorusDepth = apvts.getRawParameterValue("CHORUS_DEPTH_ID");
-  chorusMix = apvts.getRawParameterValue("CHORUS_MIX_ID");
-  chorusEnabled = apvts.getRawParameterValue("CHORUS_ENABLED_ID");
-
-  // Hook Reverb parameters
-  reverbMix = apvts.getRawParameterValue("REVERB_MIX_ID");
-  reverbTone = apvts.getRawParameterValue("REVERB_TONE_ID");
-  reverbSize = apvts.getRawParameterValue("REVERB_SIZE_ID");
-  reverbEnabled = apvts.getRawParameterValue("REVERB_ENABLED_ID");
-
-  // Hook Delay parameters
-  delayTime = apvts.getRawParameterValue("DELAY_TIME_ID");
-  delayFeedback = apvts.getRawParameterValue("DELAY_FEEDBACK_ID");
-  delayMix = apvts.getRawParameterValue("DELAY_MIX_ID");
-  delayEnabled = apvts.getRawParameterValue("DELAY_ENABLED_ID");
+  // Resolve all parameter atomics once; the audio thread only reads the
+  // per-block snapshot
+  paramSnapshot.hook(apvts);
+  chainA.hook(apvts, paramSnapshot, profiler);
+  chainB.hook(apvts, paramSnapshot, profiler);
 
   presetManager.loadPreset("Default");
 }
@@ -103,7 +69,10 @@ bool NamJUCEAudioProcessor::isMidiEffect() const {
 #endif
 }
 
-double NamJUCEAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double NamJUCEAudioProcessor::getTailLengthSeconds() const {
+  // Hosts render the full tail on bounce, so keep it bounded
+  return juce::jmin(activeChain.load()->getTailLengthSeconds(), 30.0);
+}
 
 int NamJUCEAudioProcessor::getNumPrograms() {
   return 1; // NB: some hosts don't cope very well if you tell them there are 0
@@ -127,35 +96,6 @@ void NamJUCEAudioProcessor::prepareToPlay(double sampleRate,
                                           int samplesPerBlock) {
   juce::dsp::ProcessSpec spec;
 
-  spec.sampleRate = sampleRate;
-  spec.numChannels = getNumOutputChannels();
-  spec.maximumBlockSize = samplesPerBlock;
-
-  compressorProcessor.prepare(spec);
-
-  cleanBoostProcessor.prepare(spec);
-
-  tsProcessor.prepare(spec);
-  klonProcessor.prepare(spec);
-
-  myNAM.prepare(spec);
-  myNAM.hookParameters(apvts);
-
-  // Parameters are now hooked in the constructor to allow startup defaults
-
-  doubler.prepare(spec);
-
-  chorusProcessor.prepare(spec);
-
-  reverbProcessor.prepare(spec);
-
-  delayProcessor.prepare(spec);
-
-  meterInSource.resize(getTotalNumOutputChannels(),
-                       sampleRate * 0.1 / samplesPerBlock);
-  meterOutSource.resize(getTotalNumOutputChannels(),
-                        sampleRate * 0.1 / samplesPerBlock);
-
   // Load the baked-in model via a temporary file
   auto tempDir = juce::File::getSpecialLocation(juce::File::tempDirectory);
   auto modelTempFile = tempDir.getChildFile("tworock_baked.nam");
@@ -169,22 +109,118 @@ void NamJUCEAudioProcessor::prepareToPlay(double sampleRate,
                                   BinaryData::tworock_namSize);
   }
 
+  // Every stage is prepared for one chunk, whatever the host announces;
+  // processBlock cuts longer blocks up (see ChunkSizeTuner).
+  // Offline renders have no deadline: the amp gets chunks as large as the
+  // host's blocks allow, on which its matrix products run most
+  // efficiently. A high quality bounce gathers host blocks up to them,
+  // clips the pedals at 4x and anti-aliases the boost.
+  bouncing = isNonRealtime();
+  gathering = highQualityBounce.load();
+  chunkSize = bouncing ? bounceChunkSize
+                       : chunkSizeTuner->getChunkSize(modelTempFile);
+  juce::ignoreUnused(samplesPerBlock);
+
+  const bool highQuality = bouncing && gathering;
+  const int oversamplingOrder = highQuality ? bounceOversamplingOrder : 1;
+  chainA.setOversamplingOrder(oversamplingOrder);
+  chainB.setOversamplingOrder(oversamplingOrder);
+  chainA.setAntiAliasing(highQuality);
+  chainB.setAntiAliasing(highQuality);
+
+  spec.sampleRate = sampleRate;
+  spec.numChannels = getNumOutputChannels();
+  spec.maximumBlockSize = (juce::uint32)chunkSize;
+
+  // Full quality until the governor sees how this setup performs
+  governor.prepare(sampleRate);
+  qualityTier = QualityGovernor::Full;
+  chainA.setQualityTier(qualityTier);
+  chainB.setQualityTier(qualityTier);
+
+  // The standby chain goes back on the cue from the first block
+  chainA.followCue(nullptr);
+  chainB.followCue(nullptr);
+  chainA.prepare(spec);
+  chainB.prepare(spec);
+
+  // Preset switches: warm for the amp's receptive field, then crossfade
+  standbyBuffer.setSize((int)spec.numChannels, chunkSize);
+  warmSamples =
+      (int)std::ceil(NeuralAmpModeler::receptiveFieldSeconds * sampleRate);
+  crossfadeSamples = juce::jmax(1, (int)(crossfadeSeconds * sampleRate));
+  switchState = SwitchState::Idle;
+  switchPending = false;
+  activeChain.load()->setHeld(false);
+  standbyCueSerial = -1;
+  cueWarmSamplesLeft = 0;
+
+  // The first gathered or delayed chunk comes out after a chunk of silence
+  gatherBuffer.setSize((int)spec.numChannels, gathering ? bounceChunkSize : 0);
+  gatherBuffer.clear();
+  gatherPos = 0;
+
+  profiler.prepare(sampleRate);
+
+  // Re-push every parameter into the freshly prepared stages
+  paramSnapshot.prepare(sampleRate);
+  paramSnapshot.markAllDirty();
+
+  // Start the plugin gain ramps from where the knobs are, not from unity
+  lastPluginInputGain = std::powf(
+      10.0f, paramSnapshot.getLive(ParameterSnapshot::PluginInput) / 20.0f);
+  lastPluginOutputGain = std::powf(
+      10.0f, paramSnapshot.getLive(ParameterSnapshot::PluginOutput) / 20.0f);
+
   if (modelTempFile.existsAsFile()) {
-    namModelLoaded =
-        myNAM.loadModel(modelTempFile.getFullPathName().toStdString());
+    // Both chains (and every other instance) share one parsed copy of the
+    // file through the model registry
+    const auto modelPath = modelTempFile.getFullPathName().toStdString();
+    namModelLoaded = chainA.loadModel(modelPath) && chainB.loadModel(modelPath);
   } else {
     DBG("Failed to create temp model file at: " +
         modelTempFile.getFullPathName());
   }
 
+  // Dual amp's second capture, if the session has one
+  if (secondAmpFile != juce::File())
+    loadSecondAmp(secondAmpFile);
+
+  updateLatency();
+
   // namModelLoaded =
   //     myNAM.loadModel("/Users/timpelser/Documents/SideProjects/Mayerism/"
   //                     "codebase/nam-juce/Assets/AmpModels/tworock.nam");
 }
 
+void NamJUCEAudioProcessor::dispatchParameters() {
+  using P = ParameterSnapshot;
+  const auto &p = paramSnapshot;
+
+  // Targets only; processBlock ramps towards them per sample. The chains
+  // dispatch their own parameters.
+  if (p.changed(P::gainMask)) {
+    pluginInputGain = std::powf(10.0f, p[P::PluginInput] / 20.0f);
+    pluginOutputGain = std::powf(10.0f, p[P::PluginOutput] / 20.0f);
+  }
+}
+
+void NamJUCEAudioProcessor::followQualityGovernor() {
+  // Offline renders have no deadline: always full quality
+  const int tier = isNonRealtime() ? (int)QualityGovernor::Full
+                                   : (int)governor.getTier();
+  if (tier == qualityTier)
+    return;
+
+  // Each chain changes over in place, stage by stage. The standby chain
+  // follows too, so a preset switch lands on the same tier.
+  chainA.setQualityTier(tier);
+  chainB.setQualityTier(tier);
+  qualityTier = tier;
+}
+
 bool NamJUCEAudioProcessor::getTriggerStatus() {
-  auto t_state = myNAM.getTrigger();
-  return t_state->isGating();
+  return activeChain.load()->getTriggerStatus();
 }
 
 void NamJUCEAudioProcessor::releaseResources() {}
@@ -218,107 +254,247 @@ bool NamJUCEAudioProcessor::isBusesLayoutSupported(
 void NamJUCEAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                          juce::MidiBuffer &midiMessages) {
   juce::ScopedNoDenormals noDenormals;
+
+  // REALTIME_CHECKS builds flag any allocation or lock from here on
+  RealtimeGuard::Scope realtimeScope;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
 
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  juce::dsp::AudioBlock<float> block(buffer);
+  if (bouncing && gathering) {
+    processGathered(buffer, true);
+    return;
+  }
 
-  auto *channelDataLeft = buffer.getWritePointer(0);
-  auto *channelDataRight = buffer.getWritePointer(1);
+  // Everything was prepared for chunkSize samples at most; longer host
+  // blocks, announced or not, run as several chunks
+  const int numSamples = buffer.getNumSamples();
+  for (int start = 0; start < numSamples; start += chunkSize) {
+    juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(),
+                                   buffer.getNumChannels(), start,
+                                   juce::jmin(chunkSize, numSamples - start));
+    processChunk(chunk);
+  }
 
-  buffer.applyGain(std::powf(10.0f, pluginInputGain->load() / 20.0f));
+  // Live, with high quality bounce on: as late as a bounce would be
+  if (gathering)
+    processGathered(buffer, false);
+}
 
-  meterInSource.measureBlock(buffer);
+void NamJUCEAudioProcessor::processGathered(juce::AudioBuffer<float> &buffer,
+                                            bool runChunks) {
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), gatherBuffer.getNumChannels());
+  const int numSamples = buffer.getNumSamples();
+
+  // The host's samples go in, the previous chunk's come out. Offline each
+  // full chunk runs whole, in place; live the block has already run, and
+  // the chunk is only a delay line.
+  for (int start = 0; start < numSamples;) {
+    const int n = juce::jmin(numSamples - start, bounceChunkSize - gatherPos);
+    for (int ch = 0; ch < numChannels; ++ch) {
+      auto *host = buffer.getWritePointer(ch, start);
+      std::swap_ranges(host, host + n,
+                       gatherBuffer.getWritePointer(ch, gatherPos));
+    }
+    start += n;
+    gatherPos += n;
+
+    if (gatherPos == bounceChunkSize) {
+      if (runChunks)
+        processChunk(gatherBuffer);
+      gatherPos = 0;
+    }
+  }
+}
+
+void NamJUCEAudioProcessor::processChunk(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  meterFrame.clear();
+
+  // Covers everything below, including the idle early-out
+  StageProfiler::BlockScope blockScope(profiler, numSamples);
+  QualityGovernor::BlockScope governorScope(governor, numSamples);
+
+  // One snapshot per block; setters only run for what changed
+  paramSnapshot.update(numSamples);
+  dispatchParameters();
+  paramSnapshot.clearChanged();
+  followQualityGovernor();
+
+  // Plugin gains ramp per sample from the previous block's value
+  buffer.applyGainRamp(0, numSamples, lastPluginInputGain, pluginInputGain);
+  lastPluginInputGain = pluginInputGain;
+
+  meterFrame.measure(MeterFrame::Input, buffer);
 
   // Apply -10dB Safety Pad
   buffer.applyGain(juce::Decibels::decibelsToGain(-10.0f));
 
-  // Compressor (at beginning of chain, before TS and amp)
-  if (compEnabled->load() > 0.5f) {
-    compressorProcessor.setVolume(compVolume->load());
-    compressorProcessor.setAttack(compAttack->load());
-    compressorProcessor.setSustain(compSustain->load());
-    compressorProcessor.process(buffer);
+  // Whole chain idle: everything has rung out, output silence for free
+  if (SilenceDetector::isSilent(buffer) && switchState == SwitchState::Idle &&
+      !switchPending.load() && activeChain.load()->isAsleep()) {
+    buffer.clear();
+    lastPluginOutputGain = pluginOutputGain;
+    publishMeters(buffer);
+    return;
   }
 
-  // Clean Boost (after compressor, before TS)
-  if (boostEnabled->load() > 0.5f) {
-    cleanBoostProcessor.setBoost(boostVolume->load());
-    cleanBoostProcessor.process(buffer);
-  }
+  // A block that runs both chains, or has no deadline, says nothing about
+  // what the live chain costs
+  if (isNonRealtime() || switchState != SwitchState::Idle ||
+      switchPending.load())
+    governorScope.discard();
 
-  // TubeScreamer TS808 (before amp) - only process if enabled
-  if (tsEnabled->load() > 0.5f) {
-    tsProcessor.setDrive(tsDrive->load());
-    tsProcessor.setTone(tsTone->load());
-    tsProcessor.setLevel(tsLevel->load());
-    tsProcessor.process(buffer);
-  }
+  processChains(buffer);
+
+  // Apply independent output gain AFTER all post-effects
+  buffer.applyGainRamp(0, numSamples, lastPluginOutputGain, pluginOutputGain);
+  lastPluginOutputGain = pluginOutputGain;
+
+  // --- SAFETY OUTPUT CLIPPER ---
+  // Soft clip the final output to prevent harsh digital clipping.
+  // Limiting slightly below 0dBfs (-0.1dB = ~0.988)
+  const float clipThreshold = 0.988f;
 
-  // Klon Centaur (after TS, before amp) - only process if enabled
-  if (klonEnabled->load() > 0.5f) {
-    klonProcessor.setGain(klonGain->load() / 10.0f);
-    klonProcessor.setTreble(klonTreble->load() / 10.0f);
-    klonProcessor.setLevel(klonLevel->load() / 10.0f);
-    klonProcessor.process(buffer);
+  // Rational tanh gives the same smooth "analog-like" knee as std::tanh.
+  // Under CPU pressure, a plain hard clip at the same ceiling.
+  const auto clipShape = qualityTier >= QualityGovernor::FastClipper
+                             ? waveshapers::Shape::Hard
+                             : waveshapers::Shape::RationalTanh;
+  {
+    StageProfiler::Scope scope(&profiler, StageProfiler::Clipper);
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+      waveshapers::clip(clipShape, buffer.getWritePointer(channel),
+                        buffer.getNumSamples(), clipThreshold);
   }
 
-  myNAM.processBlock(buffer);
+  publishMeters(buffer);
+}
+
+void NamJUCEAudioProcessor::publishMeters(
+    const juce::AudioBuffer<float> &buffer) {
+  auto *active = activeChain.load(std::memory_order_relaxed);
+
+  meterFrame.measure(MeterFrame::Output, buffer);
+  meterFrame.gating = active->getTriggerStatus();
+  meterFrame.gateReductionDb = active->getGateReductionDb();
 
-  // Do Dual Mono
-  for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-    channelDataRight[sample] = channelDataLeft[sample];
+  // Dropped while no editor is draining the ring
+  meterRing.push(meterFrame);
+}
 
-  // Doubler
-  if (*apvts.getRawParameterValue("DOUBLER_SPREAD_ID") > 0.0) {
-    doubler.setDelayMs(*apvts.getRawParameterValue("DOUBLER_SPREAD_ID"));
-    doubler.process(buffer);
+bool NamJUCEAudioProcessor::followCue() {
+  const int serial = cueSerial.load(std::memory_order_acquire);
+  if (!liveStandby.load(std::memory_order_relaxed) || serial == 0) {
+    standbyCueSerial = -1;
+    return false;
   }
 
-  // Chorus
-  if (chorusEnabled->load() > 0.5f) {
-    chorusProcessor.setRate(chorusRate->load());
-    chorusProcessor.setDepth(chorusDepth->load());
-    chorusProcessor.setMix(chorusMix->load());
-    chorusProcessor.process(buffer);
+  // A new cue: start the standby chain on it from clean state. The chain
+  // has to fill the amp's history before it can take over.
+  if (serial != standbyCueSerial) {
+    standbyChain->followCue(&cue);
+    standbyChain->restart();
+    standbyCueSerial = serial;
+    cueWarmSamplesLeft = warmSamples;
   }
 
-  // Delay
-  if (delayEnabled->load() > 0.5f) {
-    delayProcessor.setTime(delayTime->load());
-    delayProcessor.setFeedback(delayFeedback->load());
-    delayProcessor.setMix(delayMix->load());
-    delayProcessor.process(buffer);
+  return true;
+}
+
+void NamJUCEAudioProcessor::processChains(juce::AudioBuffer<float> &buffer) {
+  auto *active = activeChain.load(std::memory_order_relaxed);
+  const int numSamples = buffer.getNumSamples();
+
+  // A preset was applied: the live chain keeps the old values while the
+  // standby chain takes the new ones. If it has been running on exactly
+  // these as the cue, the crossfade starts at once; otherwise it warms up
+  // first. A switch requested mid-warm just restarts the warm-up; one
+  // requested mid-fade waits for the fade.
+  if (switchState != SwitchState::Crossfading &&
+      switchPending.exchange(false)) {
+    const bool cueReady = switchState == SwitchState::Idle &&
+                          standbyCueSerial > 0 &&
+                          switchCue.load() == standbyCueSerial &&
+                          cueWarmSamplesLeft <= 0;
+
+    // Same values either way from here: the parameters now hold the cue
+    standbyChain->followCue(nullptr);
+
+    if (cueReady) {
+      active->setHeld(true);
+      switchState = SwitchState::Crossfading;
+      switchSamplesLeft = crossfadeSamples;
+    } else {
+      if (switchState == SwitchState::Idle) {
+        active->setHeld(true);
+        standbyChain->restart();
+      }
+      switchState = SwitchState::Warming;
+      switchSamplesLeft = warmSamples;
+    }
+
+    // The chain swapped out picks up the next cue once this is over
+    standbyCueSerial = -1;
   }
 
-  // Reverb (at end of chain, post-effects)
-  if (reverbEnabled->load() > 0.5f) {
-    reverbProcessor.setMix(reverbMix->load());
-    reverbProcessor.setTone(reverbTone->load());
-    reverbProcessor.setSize(reverbSize->load());
-    reverbProcessor.process(buffer);
+  if (switchState == SwitchState::Idle && !followCue()) {
+    active->process(buffer, &meterFrame);
+    return;
   }
 
-  // Apply independent output gain AFTER all post-effects
-  buffer.applyGain(std::powf(10.0f, pluginOutputGain->load() / 20.0f));
+  // Both chains run on the same live input
+  juce::AudioBuffer<float> incoming(standbyBuffer.getArrayOfWritePointers(),
+                                    standbyBuffer.getNumChannels(), numSamples);
+  for (int ch = 0; ch < incoming.getNumChannels(); ++ch)
+    incoming.copyFrom(ch, 0, buffer, ch, 0, numSamples);
 
-  // --- SAFETY OUTPUT CLIPPER ---
-  // Soft clip the final output to prevent harsh digital clipping.
-  // Limiting slightly below 0dBfs (-0.1dB = ~0.988)
-  const float clipThreshold = 0.988f;
+  // Stage meters follow the chain that is being heard
+  active->process(buffer, &meterFrame);
+  standbyChain->process(incoming);
 
-  for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-    auto *data = buffer.getWritePointer(channel);
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-      // std::tanh creates a smooth "analog-like" curve as it approaches limit
-      data[i] = clipThreshold * std::tanh(data[i] / clipThreshold);
+  if (switchState == SwitchState::Idle) {
+    cueWarmSamplesLeft = juce::jmax(0, cueWarmSamplesLeft - numSamples);
+    return;
+  }
+
+  if (switchState == SwitchState::Warming) {
+    switchSamplesLeft -= numSamples;
+    if (switchSamplesLeft <= 0) {
+      switchState = SwitchState::Crossfading;
+      switchSamplesLeft = crossfadeSamples;
     }
+    return;
+  }
+
+  // Linear crossfade; the chains are fed the same signal and stay coherent
+  const int fadeLength = juce::jmin(numSamples, switchSamplesLeft);
+  const float startGain =
+      1.0f - (float)switchSamplesLeft / (float)crossfadeSamples;
+  const float endGain =
+      1.0f - (float)(switchSamplesLeft - fadeLength) / (float)crossfadeSamples;
+
+  for (int ch = 0; ch < incoming.getNumChannels(); ++ch) {
+    buffer.applyGainRamp(ch, 0, fadeLength, 1.0f - startGain, 1.0f - endGain);
+    buffer.addFromWithRamp(ch, 0, incoming.getReadPointer(ch), fadeLength,
+                           startGain, endGain);
+
+    if (fadeLength < numSamples)
+      buffer.copyFrom(ch, fadeLength, incoming, ch, fadeLength,
+                      numSamples - fadeLength);
   }
 
-  meterOutSource.measureBlock(buffer);
+  switchSamplesLeft -= fadeLength;
+  if (switchSamplesLeft == 0) {
+    // The outgoing chain stays held until it is given the next cue, or
+    // idle until the next switch
+    activeChain.store(standbyChain);
+    standbyChain = active;
+    switchState = SwitchState::Idle;
+  }
 }
 
 //==============================================================================
@@ -329,16 +505,156 @@ juce::AudioProcessorEditor *NamJUCEAudioProcessor::createEditor() {
 }
 
 //==============================================================================
-void NamJUCEAudioProcessor::getStateInformation(juce::MemoryBlock &destData) {}
+void NamJUCEAudioProcessor::getStateInformation(
+    juce::MemoryBlock &destData) {
+  PluginState::Identity identity;
+  identity.presetName = presetManager.getCurrentPreset();
+  identity.modelName = getModelIdentity();
+  identity.secondModelPath = secondAmpFile.getFullPathName();
+
+  PluginState::Options options;
+  options.liveStandby = liveStandby.load();
+
+  pluginState.write(destData, identity, options);
+}
 
 void NamJUCEAudioProcessor::setStateInformation(const void *data,
-                                                int sizeInBytes) {}
+                                                int sizeInBytes) {
+  PluginState::Identity identity;
+  PluginState::Options options;
+  ParameterSet values{apvts};
+  if (pluginState.read(data, sizeInBytes, identity, options, values)) {
+    setLiveStandby(options.liveStandby);
+    applyParameterSet(values);
+    apvts.state.setProperty(PresetManager::presetNameProperty,
+                            identity.presetName, nullptr);
+
+    // Only the baked model exists today; flag sessions saved with another
+    if (identity.modelName != getModelIdentity())
+      DBG("Session was saved with model " + identity.modelName);
+
+    if (identity.secondModelPath.isEmpty())
+      clearSecondAmp();
+    else if (!loadSecondAmp(juce::File(identity.secondModelPath)))
+      DBG("Second amp not found: " + identity.secondModelPath);
+    return;
+  }
+
+  // Fallback for state saved as APVTS XML
+  if (auto xml = getXmlFromBinary(data, sizeInBytes)) {
+    if (xml->hasTagName(apvts.state.getType())) {
+      values.setFromState(juce::ValueTree::fromXml(*xml));
+      applyParameterSet(values);
+    }
+  }
+}
+
+void NamJUCEAudioProcessor::applyParameterSet(const ParameterSet &values) {
+  // Raised first, so no block sees the new values without also starting
+  // the gapless switch to them. Before the first prepareToPlay() there is
+  // nothing to switch from: the chains start on the values as prepared.
+  const bool prepared = getSampleRate() > 0.0;
+  if (prepared) {
+    switchCue = matchesCue(values) ? cueSerial.load() : -1;
+    switchPending = true;
+  }
+
+  // The audio thread keeps its previous snapshot until the whole set is in
+  paramSnapshot.beginBulkChange();
+  const int numChanged = values.apply();
+  paramSnapshot.endBulkChange();
+
+  if (numChanged == 0)
+    switchPending = false;
+
+  // One host refresh for the whole set
+  if (numChanged > 0)
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+}
+
+void NamJUCEAudioProcessor::cueParameterSet(const ParameterSet &values) {
+  using P = ParameterSnapshot;
+
+  // Bracketed, so the standby chain never starts on half a preset
+  cue.beginChange();
+  for (int i = 0; i < P::NumParams; ++i)
+    cue.values[(size_t)i].store(values.get(P::getParameterID((P::ID)i)),
+                                std::memory_order_relaxed);
+  cue.endChange();
+
+  cueSerial.fetch_add(1, std::memory_order_release);
+}
+
+bool NamJUCEAudioProcessor::matchesCue(const ParameterSet &values) const {
+  using P = ParameterSnapshot;
+  if (cueSerial.load() == 0)
+    return false;
+
+  // Both sides come from the same conversion, so they compare exactly
+  for (int i = 0; i < P::NumParams; ++i)
+    if (values.get(P::getParameterID((P::ID)i)) !=
+        cue.values[(size_t)i].load(std::memory_order_relaxed))
+      return false;
+
+  return true;
+}
+
+bool NamJUCEAudioProcessor::loadSecondAmp(const juce::File &modelFile) {
+  if (!modelFile.existsAsFile())
+    return false;
+
+  // Models are built for the session's sample rate; before the first
+  // prepareToPlay() just remember the file, which it then loads
+  if (getSampleRate() <= 0.0) {
+    secondAmpFile = modelFile;
+    return true;
+  }
+
+  // The second amp's worker starts with the first dual-amp model, and
+  // stays for the processor's lifetime: the audio thread may be using it
+  if (workerPool == nullptr) {
+    workerPool = std::make_unique<RealtimeWorkerPool>(
+        RealtimeWorkerPool::getDefaultNumWorkers(1));
+    chainA.setWorkerPool(workerPool.get());
+    chainB.setWorkerPool(workerPool.get());
+  }
+
+  // Both chains share one parsed copy through the model registry
+  const auto modelPath = modelFile.getFullPathName().toStdString();
+  if (!chainA.loadSecondModel(modelPath) ||
+      !chainB.loadSecondModel(modelPath)) {
+    clearSecondAmp();
+    return false;
+  }
+
+  secondAmpFile = modelFile;
+  updateLatency();
+  return true;
+}
+
+void NamJUCEAudioProcessor::clearSecondAmp() {
+  chainA.clearSecondModel();
+  chainB.clearSecondModel();
+  secondAmpFile = juce::File();
+  updateLatency();
+}
+
+void NamJUCEAudioProcessor::updateLatency() {
+  // Both chains run the same models
+  setLatencySamples(chainA.getModelLatencySamples() +
+                    (gathering ? bounceChunkSize : 0));
+}
+
+juce::String NamJUCEAudioProcessor::getModelIdentity() const {
+  // Name plus size, so a rebuilt model reads as a different identity
+  return "tworock.nam:" + juce::String(BinaryData::tworock_namSize);
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout
 NamJUCEAudioProcessor::createParameters() {
   std::vector<std::unique_ptr<juce::RangedAudioParameter>> parameters;
 
-  myNAM.createParameters(parameters);
+  NeuralAmpModeler::createParameters(parameters);
 
   // Independent input/output gain parameters
   parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -418,6 +734,20 @@ NamJUCEAudioProcessor::createParameters() {
   parameters.push_back(std::make_unique<juce::AudioParameterBool>(
       "DELAY_ENABLED_ID", "DELAY_ENABLED", false));
 
+  // Order of the pedals in front of the amp
+  parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+      "PEDAL_ORDER_ID", "PEDAL_ORDER", ExecutionPlan::getOrderNames(), 0));
+
+  // Dual amp: 0 is the baked amp only, 1 the second capture only
+  parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+      "AMP_BLEND_ID", "AMP_BLEND", 0.0f, 1.0f, 0.0f));
+  parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+      "AMP2_BASS_ID", "AMP2_BASS", 0.0f, 10.0f, 5.0f));
+  parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+      "AMP2_MIDDLE_ID", "AMP2_MIDDLE", 0.0f, 10.0f, 5.0f));
+  parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+      "AMP2_TREBLE_ID", "AMP2_TREBLE", 0.0f, 10.0f, 5.0f));
+
   return {parameters.begin(), parameters.end()};
 }
 
@@ -426,12 +756,14 @@ bool NamJUCEAudioProcessor::supportsDoublePrecisionProcessing() const {
 }
 
 void NamJUCEAudioProcessor::applyDefaultSettings() {
-  auto setParam = [this](juce::String id, float value) {
-    if (auto *param = dynamic_cast<juce::RangedAudioParameter *>(
-            apvts.getParameter(id))) {
-      param->setValueNotifyingHost(
-          param->getNormalisableRange().convertTo0to1(value));
-    }
+  ParameterSet values{apvts};
+  fillDefaultSettings(values);
+  applyParameterSet(values);
+}
+
+void NamJUCEAudioProcessor::fillDefaultSettings(ParameterSet &values) {
+  auto setParam = [&values](juce::String id, float value) {
+    values.set(id, value);
   };
 
   // --- Perfect Sound Defaults ---
@@ -476,6 +808,13 @@ void NamJUCEAudioProcessor::applyDefaultSettings() {
   setParam("REVERB_SIZE_ID", 2.76f);
   setParam("REVERB_ENABLED_ID", 1.0f);
 
+  // Comp > Boost > TS > Klon, baked amp only
+  setParam("PEDAL_ORDER_ID", 0.0f);
+  setParam("AMP_BLEND_ID", 0.0f);
+  setParam("AMP2_BASS_ID", 5.0f);
+  setParam("AMP2_MIDDLE_ID", 5.0f);
+  setParam("AMP2_TREBLE_ID", 5.0f);
+
   // AMP
   setParam("INPUT_ID", -1.68f);
   setParam("BASS_ID", 5.67f);
@@ -485,7 +824,7 @@ void NamJUCEAudioProcessor::applyDefaultSettings() {
 
   // NOISEGATE, DOUBLER, PLUGIN_INPUT and PLUGIN_OUTPUT
   setParam("NGATE_ID", -80.0f);
-  setParam("DOUBLER_ID", 0.0f);
+  setParam("DOUBLER_SPREAD_ID", 0.0f);
   setParam("PLUGIN_INPUT_ID", 0.0f);
   setParam("PLUGIN_OUTPUT_ID", 0.0f);
 }
@@ -3,17 +3,18 @@
 // clang-format off
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
-#include "NeuralAmpModeler.h"
-#include <ff_meters/ff_meters.h>
-#include "DoublerProcessor.h"
-#include "pedals/TubeScreamer/TSProcessor.h"
-#include "pedals/KlonCentaur/KlonProcessor.h"
-#include "pedals/Compressor/CompressorProcessor.h"
-#include "pedals/CleanBoost/CleanBoostProcessor.h"
-#include "pedals/Chorus/ChorusProcessor.h"
-#include "pedals/Reverb/ReverbProcessor.h"
-#include "pedals/Delay/DelayProcessor.h"
+#include "SignalChain.h"
 #include "PresetManager/PresetManager.h"
+#include "Waveshapers.h"
+#include "ParameterSnapshot.h"
+#include "PluginState.h"
+#include "SharedImages.h"
+#include "Metering.h"
+#include "StageProfiler.h"
+#include "RealtimeGuard.h"
+#include "RealtimeWorkerPool.h"
+#include "QualityGovernor.h"
+#include "ChunkSizeTuner.h"
 // clang-format on
 
 //==============================================================================
@@ -62,8 +63,14 @@ public:
 
   bool supportsDoublePrecisionProcessing() const override;
 
-  foleys::LevelMeterSource &getMeterInSource() { return meterInSource; }
-  foleys::LevelMeterSource &getMeterOutSource() { return meterOutSource; }
+  // Block levels for the editor; drained by a MeterReader on the GUI
+  MeterRing &getMeterRing() { return meterRing; }
+
+  // Per-stage audio thread timing, shown by the editor's profiler overlay
+  StageProfiler &getProfiler() { return profiler; }
+
+  // Steps quality down under CPU pressure; the editor shows its tier
+  QualityGovernor &getQualityGovernor() { return governor; }
 
   juce::AudioProcessorValueTreeState apvts;
   juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
@@ -72,75 +79,152 @@ public:
 
   void loadFromPreset(juce::String modelPath, juce::String irPath);
   void applyDefaultSettings();
+  void fillDefaultSettings(ParameterSet &values);
+
+  // Applies a whole parameter set atomically, with one host notification
+  void applyParameterSet(const ParameterSet &values);
+
+  // Live standby: the standby chain runs on the preset expected next, so
+  // switching to it crossfades at once. Costs a second chain's CPU all the
+  // time, which the quality governor sees, so it is off unless chosen, and
+  // saved with the session. Off, the standby chain only runs for a switch.
+  void cueParameterSet(const ParameterSet &values);
+  void setLiveStandby(bool shouldRun) { liveStandby = shouldRun; }
+  bool isLiveStandbyEnabled() const { return liveStandby.load(); }
+
+  // High quality bounce: offline renders gather host blocks into large
+  // chunks, clip TS and Klon at 4x and anti-alias the boost. Gathering
+  // delays the output by a chunk, and the latency reported to the host
+  // must not change when a render starts, so while this is on realtime
+  // playback is delayed by the same chunk. Off by default, for playing
+  // live; takes effect at the next prepareToPlay().
+  void setHighQualityBounce(bool shouldUse) { highQualityBounce = shouldUse; }
+  bool isHighQualityBounceEnabled() const { return highQualityBounce.load(); }
 
   bool isNamModelLoaded() const { return namModelLoaded; }
 
+  // Dual amp: loads a second capture into both chains, blended in by the
+  // AMP_BLEND_ID parameter. Message thread.
+  bool loadSecondAmp(const juce::File &modelFile);
+  void clearSecondAmp();
+  juce::File getSecondAmpFile() const { return secondAmpFile; }
+
 private:
   //==============================================================================
 
-  NeuralAmpModeler myNAM;
+  // Declared before the chains, which keep pointers to them
+  StageProfiler profiler;
 
-  bool namModelLoaded{false};
+  // Runs the second amp in dual-amp mode; one spare core is all it uses.
+  // Made by the first loadSecondAmp(), so single-amp instances start no
+  // thread.
+  std::unique_ptr<RealtimeWorkerPool> workerPool;
 
-  Doubler doubler;
-  TSProcessor tsProcessor;
-  KlonProcessor klonProcessor;
-  CompressorProcessor compressorProcessor;
-  CleanBoostProcessor cleanBoostProcessor;
-  ChorusProcessor chorusProcessor;
-  ReverbProcessor reverbProcessor;
-  DelayProcessor delayProcessor;
+  QualityGovernor governor;
+
+  // Two identical chains: one live, one on standby for gapless preset
+  // switches. The editor reads activeChain, the audio thread swaps it.
+  SignalChain chainA;
+  SignalChain chainB;
+  std::atomic<SignalChain *> activeChain{&chainA};
+  SignalChain *standbyChain{&chainB};
+
+  bool namModelLoaded{false};
+  juce::File secondAmpFile;
+
+  // Preset switch: crossfade to the standby chain, warming it on live
+  // input first unless it has been running on the cued preset
+  enum class SwitchState { Idle, Warming, Crossfading };
+  SwitchState switchState{SwitchState::Idle};
+  std::atomic<bool> switchPending{false};
+  int switchSamplesLeft{0};
+  int warmSamples{0};
+  int crossfadeSamples{1};
+  juce::AudioBuffer<float> standbyBuffer;
+
+  static constexpr double crossfadeSeconds = 0.02;
+
+  // Cued preset. cueSerial counts cues (0: none yet); switchCue is the one
+  // a pending switch goes to, or -1. Audio thread: the cue the standby
+  // chain runs on, and how long until it has filled the amp's history.
+  ParameterSnapshot::Cue cue;
+  std::atomic<int> cueSerial{0};
+  std::atomic<int> switchCue{-1};
+  std::atomic<bool> liveStandby{false};
+  int standbyCueSerial{-1};
+  int cueWarmSamplesLeft{0};
+
+  bool matchesCue(const ParameterSet &values) const;
+
+  // Puts the standby chain on the latest cue; false if there is none to run
+  bool followCue();
+
+  // Runs the live chain, plus the standby one on the cue or while a switch
+  // is under way
+  void processChains(juce::AudioBuffer<float> &buffer);
+
+  // Largest block any stage sees; host blocks are cut into chunks of it
+  int chunkSize{ChunkSizeTuner::defaultChunkSize};
+  juce::SharedResourcePointer<ChunkSizeTuner> chunkSizeTuner;
+
+  // Bounce mode, chosen in prepareToPlay while the host renders offline.
+  // Hosts prepare again around a render, so it follows isNonRealtime().
+  // Host blocks run in chunks of up to bounceChunkSize.
+  static constexpr int bounceChunkSize = 4096;
+  static constexpr int bounceOversamplingOrder = 2; // 4x
+  bool bouncing{false};
+  std::atomic<bool> highQualityBounce{false};
+
+  // High quality bounce as of the last prepare: offline, host blocks are
+  // gathered into whole chunks and come out one chunk late; live, the
+  // output goes through a chunk of delay, so both report the same latency.
+  // Samples before gatherPos are this chunk's, those from it on the
+  // previous chunk's output, swapped with the host's.
+  bool gathering{false};
+  juce::AudioBuffer<float> gatherBuffer;
+  int gatherPos{0};
+  void processGathered(juce::AudioBuffer<float> &buffer, bool runChunks);
+
+  // One chunk of a host block: the whole chain, meters and clipper
+  void processChunk(juce::AudioBuffer<float> &buffer);
 
   bool supportsDouble{false};
 
-  foleys::LevelMeterSource meterInSource;
-  foleys::LevelMeterSource meterOutSource;
+  // This block's levels, pushed to the editor at the end of processBlock
+  MeterFrame meterFrame;
+  MeterRing meterRing;
+  void publishMeters(const juce::AudioBuffer<float> &buffer);
 
   PresetManager presetManager;
 
-  // Independent input/output gain parameters
-  std::atomic<float> *pluginInputGain;
-  std::atomic<float> *pluginOutputGain;
-
-  // Tube Screamer parameters
-  std::atomic<float> *tsDrive;
-  std::atomic<float> *tsTone;
-  std::atomic<float> *tsLevel;
-  std::atomic<float> *tsEnabled;
-
-  // Klon Centaur parameters
-  std::atomic<float> *klonGain;
-  std::atomic<float> *klonTreble;
-  std::atomic<float> *klonLevel;
-  std::atomic<float> *klonEnabled;
-
-  // Compressor parameters
-  std::atomic<float> *compVolume;
-  std::atomic<float> *compAttack;
-  std::atomic<float> *compSustain;
-  std::atomic<float> *compEnabled;
-
-  // Clean Boost parameters
-  std::atomic<float> *boostVolume;
-  std::atomic<float> *boostEnabled;
-
-  // Chorus parameters
-  std::atomic<float> *chorusRate;
-  std::atomic<float> *chorusDepth;
-  std::atomic<float> *chorusMix;
-  std::atomic<float> *chorusEnabled;
-
-  // Reverb parameters
-  std::atomic<float> *reverbMix;
-  std::atomic<float> *reverbTone;
-  std::atomic<float> *reverbSize;
-  std::atomic<float> *reverbEnabled;
-
-  // Delay parameters
-  std::atomic<float> *delayTime;
-  std::atomic<float> *delayFeedback;
-  std::atomic<float> *delayMix;
-  std::atomic<float> *delayEnabled;
+  // Keeps the editor's decoded images alive while the editor is closed
+  juce::SharedResourcePointer<SharedImages> sharedImages;
+
+  // Binary session state for the host
+  PluginState pluginState;
+  juce::String getModelIdentity() const;
+
+  // Drives the plugin in/out gains, and owns the bulk-change bracket both
+  // chains' snapshots share
+  ParameterSnapshot paramSnapshot;
+
+  // Cached linear plugin input/output gain, and the values reached at the
+  // end of the previous block
+  float pluginInputGain{1.0f};
+  float pluginOutputGain{1.0f};
+  float lastPluginInputGain{1.0f};
+  float lastPluginOutputGain{1.0f};
+
+  // Governor tier in effect. The output clipper follows it directly; both
+  // chains are put on it in place.
+  int qualityTier{QualityGovernor::Full};
+
+  void dispatchParameters();
+  void followQualityGovernor();
+
+  // Reports the amp models' own latency, plus a chunk while bouncing, to
+  // the host; message thread, after a model is loaded or removed
+  void updateLatency();
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NamJUCEAudioProcessor)
 };
@@ -0,0 +1,100 @@
+#include "PluginState.h"
+#include <algorithm>
+
+PluginState::PluginState(juce::AudioProcessorValueTreeState &apvts) {
+  for (auto *p : apvts.processor.getParameters()) {
+    if (auto *param = dynamic_cast<juce::RangedAudioParameter *>(p))
+      entries.push_back({hashParameterID(param->paramID), param});
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.hash < b.hash; });
+
+  // Two IDs hashing alike would make one of them unrecallable
+  jassert(std::adjacent_find(entries.begin(), entries.end(),
+                             [](const Entry &a, const Entry &b) {
+                               return a.hash == b.hash;
+                             }) == entries.end());
+}
+
+void PluginState::write(juce::MemoryBlock &destData, const Identity &identity,
+                        const Options &options) const {
+  // Header + four short strings + flags + 8 bytes per parameter
+  destData.ensureSize(
+      64 + (size_t)identity.secondModelPath.getNumBytesAsUTF8() +
+      entries.size() * 8);
+
+  juce::MemoryOutputStream stream(destData, false);
+  stream.writeInt(magic);
+  stream.writeInt(currentVersion);
+  stream.writeString(identity.presetName);
+  stream.writeString(identity.modelName);
+  stream.writeString(identity.irName);
+  stream.writeString(identity.secondModelPath);
+  stream.writeInt(options.liveStandby ? liveStandbyFlag : 0);
+
+  stream.writeCompressedInt((int)entries.size());
+  for (const auto &entry : entries) {
+    stream.writeInt((int)entry.hash);
+    stream.writeFloat(entry.param->convertFrom0to1(entry.param->getValue()));
+  }
+}
+
+bool PluginState::read(const void *data, int sizeInBytes, Identity &identity,
+                       Options &options, ParameterSet &values) const {
+  if (!isBinaryState(data, sizeInBytes))
+    return false;
+
+  juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+  stream.readInt(); // magic
+
+  const int version = stream.readInt();
+  if (version > currentVersion)
+    return false;
+
+  identity.presetName = stream.readString();
+  identity.modelName = stream.readString();
+  identity.irName = stream.readString();
+  identity.secondModelPath = version >= 2 ? stream.readString() : "";
+
+  const int flags = version >= 3 ? stream.readInt() : 0;
+  options.liveStandby = (flags & liveStandbyFlag) != 0;
+
+  // A truncated blob recalls what it can
+  const int count = juce::jmin(stream.readCompressedInt(),
+                               (int)(stream.getNumBytesRemaining() / 8));
+
+  for (int i = 0; i < count; ++i) {
+    const auto hash = (juce::uint32)stream.readInt();
+    const float value = stream.readFloat();
+
+    if (auto *param = find(hash))
+      values.set(*param, value);
+  }
+
+  return true;
+}
+
+bool PluginState::isBinaryState(const void *data, int sizeInBytes) {
+  if (data == nullptr || sizeInBytes < 8)
+    return false;
+
+  return (int)juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+juce::uint32 PluginState::hashParameterID(const juce::String &paramID) {
+  juce::uint32 hash = 2166136261u;
+  for (auto *c = paramID.toRawUTF8(); *c != 0; ++c) {
+    hash ^= (juce::uint8)*c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+juce::RangedAudioParameter *PluginState::find(juce::uint32 hash) const {
+  auto it = std::lower_bound(
+      entries.begin(), entries.end(), hash,
+      [](const Entry &entry, juce::uint32 h) { return entry.hash < h; });
+
+  return it != entries.end() && it->hash == hash ? it->param : nullptr;
+}
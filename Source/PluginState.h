@@ -0,0 +1,79 @@
+#pragma once
+#include "ParameterSet.h"
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * Plugin State
+ * Compact, versioned binary encoding of the session state that the host
+ * stores with a project.
+ *
+ * Layout (little endian):
+ *   int32   magic ('MAYR')
+ *   int32   version
+ *   string  preset name
+ *   string  model identity
+ *   string  IR identity (empty while the plugin has no IR loader)
+ *   string  second amp model path (version 2 on; empty when not in use)
+ *   int32   option flags (version 3 on; bit 0: live preset standby)
+ *   cint    parameter count
+ *   count x { uint32 parameter ID hash, float plain value }
+ *
+ * Parameters are keyed by a hash of their ID, not by index, so adding or
+ * reordering parameters does not break older sessions. Unknown hashes are
+ * skipped; parameters missing from the blob keep their current value.
+ *
+ * Restoring reads straight from the host's memory and looks each hash up in
+ * a table built once in the constructor. Values go into a ParameterSet, so
+ * the caller applies the whole session in one bulk change.
+ */
+class PluginState {
+public:
+  static constexpr int magic = 0x5259414d; // "MAYR"
+  static constexpr int currentVersion = 3;
+
+  struct Identity {
+    juce::String presetName;
+    juce::String modelName;
+    juce::String irName;
+    juce::String secondModelPath;
+  };
+
+  // Settings menu choices saved with the session; off in older sessions
+  struct Options {
+    bool liveStandby{false};
+  };
+
+  explicit PluginState(juce::AudioProcessorValueTreeState &apvts);
+  ~PluginState() {}
+
+  void write(juce::MemoryBlock &destData, const Identity &identity,
+             const Options &options) const;
+
+  /**
+   * Reads a blob written by write() into the set. Returns false, and leaves
+   * the set alone, if the data is not ours or comes from a newer version.
+   */
+  bool read(const void *data, int sizeInBytes, Identity &identity,
+            Options &options, ParameterSet &values) const;
+
+  static bool isBinaryState(const void *data, int sizeInBytes);
+
+  // FNV-1a, stable across platforms and JUCE versions
+  static juce::uint32 hashParameterID(const juce::String &paramID);
+
+private:
+  static constexpr int liveStandbyFlag = 1;
+
+  struct Entry {
+    juce::uint32 hash;
+    juce::RangedAudioParameter *param;
+  };
+
+  // Sorted by hash
+  std::vector<Entry> entries;
+
+  juce::RangedAudioParameter *find(juce::uint32 hash) const;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginState)
+};
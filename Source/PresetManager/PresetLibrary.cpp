@@ -0,0 +1,120 @@
+#include "PresetLibrary.h"
+#include "PresetManager.h"
+#include <algorithm>
+
+namespace {
+std::shared_ptr<const PresetLibrary::Index>
+makeIndex(std::vector<PresetLibrary::Preset> presets) {
+  auto index = std::make_shared<PresetLibrary::Index>();
+
+  index->names.add("Default");
+  index->positions["Default"] = 0;
+
+  for (const auto &preset : presets) {
+    index->positions[preset.name] = index->names.size();
+    index->names.add(preset.name);
+  }
+
+  index->presets = std::move(presets);
+  return index;
+}
+} // namespace
+
+PresetLibrary::PresetLibrary()
+    : PresetLibrary(PresetManager::defaultPresetDirectory,
+                    PresetManager::presetExtension) {}
+
+PresetLibrary::PresetLibrary(const juce::File &directory,
+                             const juce::String &extension)
+    : juce::Thread("Preset Library"), directory(directory),
+      wildcard("*." + extension), index(makeIndex({})) {
+  startThread(juce::Thread::Priority::low);
+}
+
+PresetLibrary::~PresetLibrary() { stopThread(2000); }
+
+std::shared_ptr<const PresetLibrary::Index> PresetLibrary::getIndex() const {
+  const juce::SpinLock::ScopedLockType lock(indexLock);
+  return index;
+}
+
+bool PresetLibrary::decode(const juce::File &file, Preset &preset) {
+  juce::XmlDocument xmlDocument{file};
+  const auto xml = xmlDocument.getDocumentElement();
+  if (xml == nullptr)
+    return false;
+
+  preset.values.clear();
+  for (auto *param : xml->getChildWithTagNameIterator("PARAM"))
+    preset.values.emplace_back(param->getStringAttribute("id"),
+                               (float)param->getDoubleAttribute("value"));
+
+  return true;
+}
+
+void PresetLibrary::run() {
+  while (!threadShouldExit()) {
+    if (refresh())
+      sendChangeMessage();
+
+    wait(pollIntervalMs);
+  }
+}
+
+bool PresetLibrary::refresh() {
+  const auto previous = getIndex();
+  const auto files = directory.findChildFiles(
+      juce::File::TypesOfFileToFind::findFiles, false, wildcard);
+
+  std::vector<Preset> presets;
+  presets.reserve((size_t)files.size());
+  bool changed = false;
+
+  for (const auto &file : files) {
+    if (threadShouldExit())
+      return false;
+
+    Preset preset;
+    preset.name = file.getFileNameWithoutExtension();
+    preset.file = file;
+    preset.modified = file.getLastModificationTime();
+    preset.size = file.getSize();
+
+    // Unchanged files keep their decoded values
+    const auto *known = previous->find(preset.name);
+    if (known != nullptr && known->file == file &&
+        known->modified == preset.modified && known->size == preset.size) {
+      preset.values = known->values;
+    } else {
+      // Broken files are only retried once they are written again
+      const auto path = file.getFullPathName();
+      const auto failed = unreadable.find(path);
+      if (failed != unreadable.end() && failed->second == preset.modified)
+        continue;
+
+      if (!decode(file, preset)) {
+        DBG("Skipping unreadable preset: " + path);
+        unreadable[path] = preset.modified;
+        continue;
+      }
+      changed = true;
+    }
+
+    presets.push_back(std::move(preset));
+  }
+
+  // Catches deletions
+  changed |= presets.size() != previous->presets.size();
+  if (!changed)
+    return false;
+
+  std::sort(presets.begin(), presets.end(),
+            [](const Preset &a, const Preset &b) {
+              return a.name.compareNatural(b.name) < 0;
+            });
+
+  auto next = makeIndex(std::move(presets));
+  const juce::SpinLock::ScopedLockType lock(indexLock);
+  index = std::move(next);
+  return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Preset Library
+ * In-memory index of the preset folder, with every preset's parameter
+ * values already decoded.
+ *
+ * A background thread builds the index once and then polls the folder,
+ * re-reading only files whose size or modification time changed. Each
+ * rebuild is published as a new immutable Index, and listeners get a
+ * change message on the message thread.
+ *
+ * Browsing (names, lookup by name, next/previous) never touches the disk.
+ *
+ * The library is process-wide: plugin instances hold it through a
+ * juce::SharedResourcePointer, so one watcher thread serves all of them and
+ * each editor subscribes to its change messages.
+ */
+class PresetLibrary : private juce::Thread, public juce::ChangeBroadcaster {
+public:
+  struct Preset {
+    juce::String name;
+    juce::File file;
+    juce::Time modified;
+    juce::int64 size{0};
+
+    // Plain values by parameter ID, as stored in the file
+    std::vector<std::pair<juce::String, float>> values;
+  };
+
+  struct Index {
+    // "Default" first, then the files sorted by name
+    juce::StringArray names;
+    std::vector<Preset> presets; // aligned with names, minus "Default"
+    std::unordered_map<juce::String, int> positions;
+
+    int indexOf(const juce::String &name) const {
+      const auto it = positions.find(name);
+      return it != positions.end() ? it->second : -1;
+    }
+
+    // nullptr for "Default" and unknown names
+    const Preset *find(const juce::String &name) const {
+      const int index = indexOf(name);
+      return index > 0 ? &presets[(size_t)index - 1] : nullptr;
+    }
+  };
+
+  // The plugin's preset folder, for juce::SharedResourcePointer
+  PresetLibrary();
+  PresetLibrary(const juce::File &directory, const juce::String &extension);
+  ~PresetLibrary() override;
+
+  // The current index; safe from any thread, never blocks on disk
+  std::shared_ptr<const Index> getIndex() const;
+
+  // Wake the watcher now, e.g. after saving or deleting a preset
+  void rescan() { notify(); }
+
+  // Reads one preset file; false if it is not a valid preset
+  static bool decode(const juce::File &file, Preset &preset);
+
+  static constexpr int pollIntervalMs = 1000;
+
+private:
+  void run() override;
+  bool refresh();
+
+  const juce::File directory;
+  const juce::String wildcard;
+
+  // Watcher thread only: files that failed to decode, by modification time
+  std::unordered_map<juce::String, juce::Time> unreadable;
+
+  mutable juce::SpinLock indexLock;
+  std::shared_ptr<const Index> index;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
@@ -9,9 +9,13 @@ const juce::File PresetManager::defaultPresetDirectory{
 const juce::String PresetManager::presetExtension{"nampreset"};
 const juce::String PresetManager::presetNameProperty{"presetName"};
 
-PresetManager::PresetManager(juce::AudioProcessorValueTreeState &apvts,
-                             std::function<void()> onReset)
-    : apvts(apvts), onResetToDefault(std::move(onReset)) {
+PresetManager::PresetManager(
+    juce::AudioProcessorValueTreeState &apvts,
+    std::function<void(ParameterSet &)> onDefaults,
+    std::function<void(const ParameterSet &)> onApply,
+    std::function<void(const ParameterSet &)> onCue)
+    : apvts(apvts), onDefaultParameters(std::move(onDefaults)),
+      onApplyParameters(std::move(onApply)), onCueParameters(std::move(onCue)) {
   if (!defaultPresetDirectory.exists()) {
     const auto result = defaultPresetDirectory.createDirectory();
     if (result.failed()) {
@@ -44,6 +48,8 @@ void PresetManager::savePreset(const juce::String &presetName) {
     DBG("Error creating preset file: " + presetFile.getFullPathName());
     jassertfalse;
   }
+
+  library->rescan();
 }
 
 void PresetManager::deletePreset(const juce::String &presetName) {
@@ -65,47 +71,84 @@ void PresetManager::deletePreset(const juce::String &presetName) {
   }
 
   currentPreset.setValue("");
+  library->rescan();
 }
 
 void PresetManager::loadPreset(const juce::String &presetName) {
+  loadPreset(presetName, 1);
+}
+
+void PresetManager::loadPreset(const juce::String &presetName,
+                               int direction) {
   if (presetName.isEmpty())
     return;
 
-  if (presetName == "Default") {
-    if (onResetToDefault)
-      onResetToDefault();
-    currentPreset.setValue("Default");
+  ParameterSet values{apvts};
+  if (!readPreset(presetName, values))
     return;
-  }
 
-  const auto presetFile =
-      defaultPresetDirectory.getChildFile(presetName + "." + presetExtension);
-  if (!presetFile.existsAsFile()) {
-    DBG("Preset File " + presetFile.getFullPathName() + " does not exist");
-    jassertfalse;
-    return;
+  if (onApplyParameters)
+    onApplyParameters(values);
+  currentPreset.setValue(presetName);
+
+  cueNextPreset(direction);
+}
+
+bool PresetManager::readPreset(const juce::String &presetName,
+                               ParameterSet &values) {
+  if (presetName == "Default") {
+    if (onDefaultParameters)
+      onDefaultParameters(values);
+    return true;
   }
 
-  juce::XmlDocument xmlDocument{presetFile};
-  const auto valueTreeToLoad =
-      juce::ValueTree::fromXml(*xmlDocument.getDocumentElement());
+  // Already decoded by the library
+  const auto index = library->getIndex();
+  const auto *preset = index->find(presetName);
+  PresetLibrary::Preset decoded;
+  if (preset == nullptr) {
+    // Not indexed yet (e.g. saved a moment ago): read the file directly
+    const auto presetFile =
+        defaultPresetDirectory.getChildFile(presetName + "." + presetExtension);
+    if (!presetFile.existsAsFile()) {
+      DBG("Preset File " + presetFile.getFullPathName() + " does not exist");
+      jassertfalse;
+      return false;
+    }
 
-  apvts.replaceState(valueTreeToLoad);
-  currentPreset.setValue(presetName);
+    if (!PresetLibrary::decode(presetFile, decoded)) {
+      DBG("Preset File " + presetFile.getFullPathName() +
+          " is not valid XML");
+      jassertfalse;
+      return false;
+    }
+    preset = &decoded;
+  }
+
+  for (const auto &[paramID, value] : preset->values)
+    values.set(paramID, value);
+  return true;
 }
 
-juce::StringArray PresetManager::getAllPresets() const {
-  juce::StringArray presets;
-  presets.add("Default");
+void PresetManager::cueNextPreset(int direction) {
+  if (!onCueParameters)
+    return;
+
+  const auto index = library->getIndex();
+  const int numPresets = index->names.size();
+  const int currentIndex = index->indexOf(currentPreset.toString());
+  if (numPresets < 2 || currentIndex < 0)
+    return;
 
-  const auto fileArray = defaultPresetDirectory.findChildFiles(
-      juce::File::TypesOfFileToFind::findFiles, false, "*" + presetExtension);
+  const int cueIndex = (currentIndex + direction + numPresets) % numPresets;
 
-  for (const auto &file : fileArray) {
-    presets.add(file.getFileNameWithoutExtension());
-  }
+  ParameterSet values{apvts};
+  if (readPreset(index->names[cueIndex], values))
+    onCueParameters(values);
+}
 
-  return presets;
+juce::StringArray PresetManager::getAllPresets() const {
+  return library->getIndex()->names;
 }
 
 juce::String PresetManager::getCurrentPreset() const {
@@ -113,32 +156,27 @@ juce::String PresetManager::getCurrentPreset() const {
 }
 
 int PresetManager::loadNextPreset() {
-  const auto allPresets = getAllPresets();
-  if (allPresets.isEmpty())
-    return -1;
+  const auto index = library->getIndex();
+  const int numPresets = index->names.size();
 
-  const auto currentIndex = allPresets.indexOf(currentPreset.toString());
+  const auto currentIndex = index->indexOf(currentPreset.toString());
   const auto nextIndex =
-      currentIndex + 1 > (allPresets.size() - 1) ? 0 : currentIndex + 1;
-
-  // loadPreset(allPresets.getReference(nextIndex)); //This will work on
-  // JUCE 6.1.5
+      currentIndex + 1 > (numPresets - 1) ? 0 : currentIndex + 1;
 
+  loadPreset(index->names[nextIndex]);
   return nextIndex;
 }
 
 int PresetManager::loadPreviousPreset() {
-  const auto allPresets = getAllPresets();
-  if (allPresets.isEmpty())
-    return -1;
+  const auto index = library->getIndex();
+  const int numPresets = index->names.size();
 
-  const auto currentIndex = allPresets.indexOf(currentPreset.toString());
+  const auto currentIndex = index->indexOf(currentPreset.toString());
   const auto previousIndex =
-      currentIndex - 1 < 0 ? allPresets.size() - 1 : currentIndex - 1;
-
-  // loadPreset(allPresets.getReference(previousIndex)); //This will work on
-  // JUCE 6.1.5
+      currentIndex - 1 < 0 ? numPresets - 1 : currentIndex - 1;
 
+  // Stepping backwards: the one before is the likelier next
+  loadPreset(index->names[previousIndex], -1);
   return previousIndex;
 }
 
@@ -1,12 +1,19 @@
 #pragma once
 // #include <JuceHeader.h>
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "../ParameterSet.h"
+#include "PresetLibrary.h"
 #include <functional>
 
 class PresetManager : juce::ValueTree::Listener {
 public:
+  // onDefaults fills in the "Default" preset. onApply pushes a loaded
+  // preset to the processor in one bulk change; onCue hands it the preset
+  // the user is expected to load next, so it can be warmed up ahead.
   PresetManager(juce::AudioProcessorValueTreeState &apvts,
-                std::function<void()> onReset);
+                std::function<void(ParameterSet &)> onDefaults,
+                std::function<void(const ParameterSet &)> onApply,
+                std::function<void(const ParameterSet &)> onCue);
   ~PresetManager();
 
   void savePreset(const juce::String &presetName);
@@ -17,6 +24,10 @@ public:
   juce::StringArray getAllPresets() const;
   juce::String getCurrentPreset() const;
 
+  // Sends a change message whenever the preset folder's contents change.
+  // One library and watcher thread serve every plugin instance.
+  PresetLibrary &getLibrary() { return *library; }
+
   static const juce::File defaultPresetDirectory;
   static const juce::String presetExtension;
   static const juce::String presetNameProperty;
@@ -25,6 +36,19 @@ private:
   void valueTreeRedirected(juce::ValueTree &treeChanged) override;
 
   juce::AudioProcessorValueTreeState &apvts;
-  std::function<void()> onResetToDefault;
+  std::function<void(ParameterSet &)> onDefaultParameters;
+  std::function<void(const ParameterSet &)> onApplyParameters;
+  std::function<void(const ParameterSet &)> onCueParameters;
   juce::Value currentPreset;
+
+  juce::SharedResourcePointer<PresetLibrary> library;
+
+  // Loads a preset, then cues its neighbour in the direction of travel
+  void loadPreset(const juce::String &presetName, int direction);
+
+  // Fills values with a preset; false if it cannot be found or read
+  bool readPreset(const juce::String &presetName, ParameterSet &values);
+
+  // Cues the neighbour of the current preset in the direction of travel
+  void cueNextPreset(int direction);
 };
\ No newline at end of file
@@ -5,6 +5,11 @@ PresetManagerComponent::PresetManagerComponent(
     PresetManager &pm, std::function<void()> &&updateFunction)
     : presetManager(pm), parentUpdater(std::move(updateFunction)) {
   constructUI();
+  presetManager.getLibrary().addChangeListener(this);
+}
+
+PresetManagerComponent::~PresetManagerComponent() {
+  presetManager.getLibrary().removeChangeListener(this);
 }
 
 void PresetManagerComponent::constructUI() {
@@ -58,14 +63,15 @@ void PresetManagerComponent::constructUI() {
   nextButton.setMouseCursor(juce::MouseCursor::PointingHandCursor);
   previousButton.setMouseCursor(juce::MouseCursor::PointingHandCursor);
 
+  // The manager loads the preset; only the UI is updated here
   nextButton.onClick = [this] {
     const auto index = presetManager.loadNextPreset();
-    presetComboBox.setSelectedItemIndex(index, juce::sendNotification);
+    showLoadedPreset(index);
   };
 
   previousButton.onClick = [this] {
     const auto index = presetManager.loadPreviousPreset();
-    presetComboBox.setSelectedItemIndex(index, juce::sendNotification);
+    showLoadedPreset(index);
   };
 
   addAndMakeVisible(&saveButton);
@@ -145,6 +151,17 @@ void PresetManagerComponent::resized() {
 
 void PresetManagerComponent::parameterChanged() {}
 
+void PresetManagerComponent::showLoadedPreset(int index) {
+  presetComboBox.setSelectedItemIndex(index, juce::dontSendNotification);
+  presetName.setText(presetComboBox.getText());
+  parentUpdater();
+}
+
+void PresetManagerComponent::changeListenerCallback(
+    juce::ChangeBroadcaster *) {
+  loadComboBox();
+}
+
 void PresetManagerComponent::comboBoxChanged(
     juce::ComboBox *comboBoxThatHasChanged) {
   const auto selectedText = comboBoxThatHasChanged->getText();
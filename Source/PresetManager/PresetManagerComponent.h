@@ -1,12 +1,15 @@
 #pragma once
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "../SharedImages.h"
 #include "PresetManager.h"
 
 class PresetManagerComponent : public juce::Component,
-                               public juce::ComboBox::Listener {
+                               public juce::ComboBox::Listener,
+                               private juce::ChangeListener {
 public:
   PresetManagerComponent(PresetManager &,
                          std::function<void()> &&updateFunction);
+  ~PresetManagerComponent() override;
 
   void paint(juce::Graphics &g) override;
   void resized() override;
@@ -34,13 +37,14 @@ private:
   juce::ImageButton previousButton, nextButton;
 
 
-  juce::Image backPushed = juce::ImageFileFormat::loadFrom(
+  juce::SharedResourcePointer<SharedImages> sharedImages;
+  juce::Image backPushed = sharedImages->get(
       BinaryData::backpushed_png, BinaryData::backpushed_pngSize);
-  juce::Image backUnushed = juce::ImageFileFormat::loadFrom(
+  juce::Image backUnushed = sharedImages->get(
       BinaryData::backunpushed_png, BinaryData::backunpushed_pngSize);
-  juce::Image forwardPushed = juce::ImageFileFormat::loadFrom(
+  juce::Image forwardPushed = sharedImages->get(
       BinaryData::forwardpushed_png, BinaryData::forwardpushed_pngSize);
-  juce::Image forwardUnpushed = juce::ImageFileFormat::loadFrom(
+  juce::Image forwardUnpushed = sharedImages->get(
       BinaryData::forwardunpushed_png, BinaryData::forwardunpushed_pngSize);
 
   PresetManager &presetManager;
@@ -49,6 +53,10 @@ private:
   juce::TooltipWindow tooltipWindow{this, 300};
 
   void constructUI();
+  void showLoadedPreset(int index);
+
+  // The preset folder changed on disk
+  void changeListenerCallback(juce::ChangeBroadcaster *source) override;
 
   std::function<void()> parentUpdater;
 
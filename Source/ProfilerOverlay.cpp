@@ -0,0 +1,157 @@
+#include "ProfilerOverlay.h"
+
+ProfilerOverlay::ProfilerOverlay(StageProfiler &p) : profiler(p) {
+  setVisible(false);
+
+  resetButton.onClick = [this] {
+    profiler.reset();
+    RealtimeGuard::resetViolations();
+    repaint();
+  };
+  exportButton.onClick = [this] { exportCsv(); };
+  closeButton.onClick = [this] { toggle(); };
+
+  addAndMakeVisible(resetButton);
+  addAndMakeVisible(exportButton);
+  addAndMakeVisible(closeButton);
+}
+
+ProfilerOverlay::~ProfilerOverlay() { profiler.setEnabled(false); }
+
+void ProfilerOverlay::toggle() {
+  const bool show = !isVisible();
+
+  profiler.setEnabled(show);
+  setVisible(show);
+
+  if (show) {
+    toFront(false);
+    startTimerHz(refreshHz);
+  } else {
+    stopTimer();
+  }
+}
+
+void ProfilerOverlay::timerCallback() { repaint(); }
+
+void ProfilerOverlay::resized() {
+  auto buttons = getLocalBounds().reduced(10).removeFromBottom(24);
+  closeButton.setBounds(buttons.removeFromRight(70));
+  buttons.removeFromRight(6);
+  exportButton.setBounds(buttons.removeFromRight(90));
+  buttons.removeFromRight(6);
+  resetButton.setBounds(buttons.removeFromRight(70));
+}
+
+void ProfilerOverlay::paint(juce::Graphics &g) {
+  g.fillAll(juce::Colours::black.withAlpha(0.85f));
+  g.setColour(juce::Colours::grey);
+  g.drawRect(getLocalBounds());
+
+  const auto load = profiler.getLoadStats();
+  const double deadline = load.meanBlockMicros;
+
+  auto area = getLocalBounds().reduced(10);
+  g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 13.0f,
+                       juce::Font::plain));
+
+  // Headline: how much of each block's time the whole chain takes
+  g.setColour(load.maxLoad >= 1.0 ? juce::Colours::orangered
+                                  : juce::Colours::whitesmoke);
+  g.drawText(juce::String::formatted(
+                 "Block deadline %.0f us   load mean %.1f%%  max %.1f%%",
+                 deadline, load.meanLoad * 100.0, load.maxLoad * 100.0),
+             area.removeFromTop(rowHeight), juce::Justification::left);
+
+  auto loadRow = area.removeFromTop(rowHeight);
+  g.setColour(juce::Colours::grey);
+  g.drawText("load 0-100%+", loadRow.removeFromLeft(180),
+             juce::Justification::left);
+  drawHistogram(g, loadRow.toFloat().reduced(0, 3), load.histogram.data(),
+                StageProfiler::numLoadBuckets);
+
+#if MAYERISM_REALTIME_CHECKS
+  // Allocations, frees and locks seen on the audio thread so far
+  const int violations = RealtimeGuard::getNumViolations();
+  g.setColour(violations > 0 ? juce::Colours::orangered
+                             : juce::Colours::lightgreen);
+  g.drawText(juce::String::formatted(
+                 "Realtime violations: %d alloc, %d free, %d lock",
+                 RealtimeGuard::getNumViolations(RealtimeGuard::Allocation),
+                 RealtimeGuard::getNumViolations(RealtimeGuard::Deallocation),
+                 RealtimeGuard::getNumViolations(RealtimeGuard::Lock)),
+             area.removeFromTop(rowHeight), juce::Justification::left);
+#endif
+
+  area.removeFromTop(6);
+
+  g.setColour(juce::Colours::grey);
+  auto header = area.removeFromTop(rowHeight);
+  g.drawText(juce::String("stage").paddedRight(' ', 18) +
+                 juce::String("mean us").paddedLeft(' ', 9) +
+                 juce::String("max us").paddedLeft(' ', 9) +
+                 juce::String("budget").paddedLeft(' ', 8),
+             header.removeFromLeft(400), juce::Justification::left);
+  g.drawText("<1us .. >16ms", header, juce::Justification::left);
+
+  for (int s = 0; s < StageProfiler::NumStages; ++s) {
+    const auto stage = (StageProfiler::Stage)s;
+    const auto stats = profiler.getStageStats(stage);
+    auto row = area.removeFromTop(rowHeight);
+
+    // Share of an average block's deadline this stage takes per call
+    const double budget = deadline > 0.0 ? stats.meanMicros / deadline : 0.0;
+
+    g.setColour(budget > 0.5 ? juce::Colours::orangered
+                             : juce::Colours::whitesmoke);
+    g.drawText(StageProfiler::getStageName(stage).paddedRight(' ', 18) +
+                   juce::String(stats.meanMicros, 1).paddedLeft(' ', 9) +
+                   juce::String(stats.maxMicros, 1).paddedLeft(' ', 9) +
+                   (juce::String(budget * 100.0, 1) + "%").paddedLeft(' ', 8),
+               row.removeFromLeft(400), juce::Justification::left);
+
+    drawHistogram(g, row.toFloat().reduced(0, 3), stats.histogram.data(),
+                  StageProfiler::numTimeBuckets);
+  }
+}
+
+void ProfilerOverlay::drawHistogram(juce::Graphics &g,
+                                    juce::Rectangle<float> area,
+                                    const juce::uint32 *counts,
+                                    int numBuckets) {
+  juce::uint32 largest = 0;
+  for (int i = 0; i < numBuckets; ++i)
+    largest = juce::jmax(largest, counts[i]);
+
+  if (largest == 0)
+    return;
+
+  const float width = area.getWidth() / (float)numBuckets;
+  g.setColour(juce::Colours::lightgreen);
+
+  for (int i = 0; i < numBuckets; ++i) {
+    const float height = area.getHeight() * (float)counts[i] / (float)largest;
+    g.fillRect(area.getX() + i * width, area.getBottom() - height,
+               juce::jmax(1.0f, width - 1.0f), height);
+  }
+}
+
+void ProfilerOverlay::exportCsv() {
+  // Snapshot now, so the file matches what is on screen
+  const auto csv = profiler.toCsv();
+
+  fileChooser = std::make_unique<juce::FileChooser>(
+      "Export Profile",
+      juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+          .getChildFile("mayerism-profile.csv"),
+      "*.csv");
+
+  const int flags = juce::FileBrowserComponent::saveMode |
+                    juce::FileBrowserComponent::warnAboutOverwriting;
+
+  fileChooser->launchAsync(flags, [csv](const juce::FileChooser &chooser) {
+    const auto file = chooser.getResult();
+    if (file != juce::File())
+      file.replaceWithText(csv);
+  });
+}
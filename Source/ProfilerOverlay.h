@@ -0,0 +1,44 @@
+#pragma once
+#include "RealtimeGuard.h"
+#include "StageProfiler.h"
+#include <JuceHeader.h>
+
+/**
+ * Profiler Overlay
+ * Table of the StageProfiler's per-stage times and the block's deadline
+ * utilisation, drawn over the editor.
+ *
+ * Profiling runs only while the overlay is shown. "Export CSV" writes the
+ * same numbers, histograms included, for attaching to a crackle report.
+ */
+class ProfilerOverlay : public juce::Component, private juce::Timer {
+public:
+  explicit ProfilerOverlay(StageProfiler &);
+  ~ProfilerOverlay() override;
+
+  void paint(juce::Graphics &g) override;
+  void resized() override;
+
+  // Shows or hides the overlay, starting or stopping the profiler with it
+  void toggle();
+
+private:
+  void timerCallback() override;
+  void exportCsv();
+
+  // Draws one histogram as a row of bars, scaled to its largest bucket
+  static void drawHistogram(juce::Graphics &g, juce::Rectangle<float> area,
+                            const juce::uint32 *counts, int numBuckets);
+
+  StageProfiler &profiler;
+
+  juce::TextButton resetButton{"Reset"};
+  juce::TextButton exportButton{"Export CSV"};
+  juce::TextButton closeButton{"Close"};
+  std::unique_ptr<juce::FileChooser> fileChooser;
+
+  static constexpr int refreshHz = 4;
+  static constexpr int rowHeight = 18;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
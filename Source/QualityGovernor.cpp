@@ -0,0 +1,73 @@
+#include "QualityGovernor.h"
+#include <cmath>
+
+void QualityGovernor::prepare(double newSampleRate) {
+  sampleRate = newSampleRate;
+  averageLoad = 0.0;
+  secondsSinceStep = 0.0;
+  secondsWithHeadroom = 0.0;
+  load = 0.0f;
+  tier = Full;
+}
+
+void QualityGovernor::update(juce::int64 ticks, int numSamples) {
+  if (numSamples <= 0 || sampleRate <= 0.0)
+    return;
+
+  const double deadline = numSamples / sampleRate;
+  const double blockLoad =
+      juce::Time::highResolutionTicksToSeconds(ticks) / deadline;
+
+  // One-pole average with a time constant in seconds, whatever the block
+  // size
+  averageLoad += (1.0 - std::exp(-deadline / averagingSeconds)) *
+                 (blockLoad - averageLoad);
+  load.store((float)averageLoad, std::memory_order_relaxed);
+
+  secondsSinceStep += deadline;
+
+  if (!isEnabled()) {
+    setTier(Full);
+    return;
+  }
+
+  const int current = tier.load(std::memory_order_relaxed);
+
+  if (averageLoad > stepDownLoad) {
+    secondsWithHeadroom = 0.0;
+    if (current < NumTiers - 1 && secondsSinceStep >= stepDownSeconds)
+      setTier(current + 1);
+  } else if (averageLoad < stepUpLoad) {
+    secondsWithHeadroom += deadline;
+    if (current > Full && secondsWithHeadroom >= stepUpSeconds)
+      setTier(current - 1);
+  } else {
+    secondsWithHeadroom = 0.0;
+  }
+}
+
+void QualityGovernor::setTier(int newTier) {
+  if (newTier == tier.load(std::memory_order_relaxed))
+    return;
+
+  tier.store(newTier, std::memory_order_relaxed);
+  secondsSinceStep = 0.0;
+  secondsWithHeadroom = 0.0;
+}
+
+juce::String QualityGovernor::getTierName(Tier tierToName) {
+  switch (tierToName) {
+  case Full:
+    return "Full";
+  case NoOversampling:
+    return "No oversampling";
+  case FastResampler:
+    return "Fast resampler";
+  case ReducedReverb:
+    return "Reduced reverb";
+  case FastClipper:
+    return "Fast clipper";
+  default:
+    return {};
+  }
+}
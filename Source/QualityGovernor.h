@@ -0,0 +1,104 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+/**
+ * Quality Governor
+ * Trades sound quality for CPU when the audio thread falls behind, so an
+ * overloaded machine degrades gradually instead of crackling.
+ *
+ * Every block's processing time is compared against its deadline (the
+ * block's duration) and averaged over about averagingSeconds. While the
+ * average stays above stepDownLoad the governor drops one tier at a time,
+ * at most once per stepDownSeconds so each step can show its effect. It
+ * climbs back one tier once the average has stayed below stepUpLoad for
+ * stepUpSeconds. The gap between the two loads and the longer wait
+ * upwards keep it from hunting between two tiers.
+ *
+ * Tiers are cumulative, cheapest loss of quality first:
+ * - NoOversampling: TS and Klon clip at the host rate instead of 2x
+ * - FastResampler:  shorter resampling kernel around the amp model
+ * - ReducedReverb:  one mono reverb tail instead of two
+ * - FastClipper:    plain hard output clip instead of the rational tanh
+ *
+ * The audio thread is the only writer; the editor reads the tier and the
+ * average load any time. The chains apply their tiers in place, each stage
+ * crossfading over a few milliseconds; the processor leaves the blocks of a
+ * preset switch, which run both chains, out of the average.
+ */
+class QualityGovernor {
+public:
+  enum Tier {
+    Full = 0,
+    NoOversampling,
+    FastResampler,
+    ReducedReverb,
+    FastClipper,
+    NumTiers
+  };
+
+  static constexpr double stepDownLoad = 0.8;
+  static constexpr double stepUpLoad = 0.5;
+  static constexpr double averagingSeconds = 0.25;
+  static constexpr double stepDownSeconds = 0.5;
+  static constexpr double stepUpSeconds = 5.0;
+
+  QualityGovernor() {}
+  ~QualityGovernor() {}
+
+  // Back to full quality with a clean average. Message thread, while the
+  // audio thread is stopped.
+  void prepare(double newSampleRate);
+
+  // Disabled, the governor stays at Full. Any thread.
+  void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+  bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+  Tier getTier() const { return (Tier)tier.load(std::memory_order_relaxed); }
+
+  // Average block time as a share of the deadline; 1.0 = the whole block
+  float getLoad() const { return load.load(std::memory_order_relaxed); }
+
+  // Times a whole processBlock and feeds it to the governor
+  class BlockScope {
+  public:
+    BlockScope(QualityGovernor &owner, int blockSamples)
+        : governor(&owner), numSamples(blockSamples),
+          start(juce::Time::getHighResolutionTicks()) {}
+
+    ~BlockScope() {
+      if (governor != nullptr)
+        governor->update(juce::Time::getHighResolutionTicks() - start,
+                         numSamples);
+    }
+
+    // Leaves this block out, e.g. one with no deadline
+    void discard() { governor = nullptr; }
+
+  private:
+    QualityGovernor *governor;
+    int numSamples;
+    juce::int64 start;
+
+    JUCE_DECLARE_NON_COPYABLE(BlockScope)
+  };
+
+  static juce::String getTierName(Tier tierToName);
+
+private:
+  // Audio thread, once per block
+  void update(juce::int64 ticks, int numSamples);
+
+  void setTier(int newTier);
+
+  std::atomic<bool> enabled{true};
+  std::atomic<int> tier{Full};
+  std::atomic<float> load{0.0f};
+
+  double sampleRate{48000.0};
+  double averageLoad{0.0};
+  double secondsSinceStep{0.0};
+  double secondsWithHeadroom{0.0};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QualityGovernor)
+};
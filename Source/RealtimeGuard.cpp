@@ -0,0 +1,258 @@
+#include "RealtimeGuard.h"
+
+#if MAYERISM_REALTIME_CHECKS
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+#include <Eigen/Core>
+#endif
+
+// glibc exports its allocator under a second name, so malloc and friends
+// can be replaced below and still reach it
+#if defined(__GLIBC__) && !defined(__APPLE__)
+#define MAYERISM_INTERPOSE_MALLOC 1
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *memory, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *memory);
+}
+#else
+#define MAYERISM_INTERPOSE_MALLOC 0
+#endif
+
+namespace {
+// Nesting depth of Scopes on this thread. Initial-exec, so reading it never
+// calls into the dynamic loader, which may allocate.
+#if MAYERISM_INTERPOSE_MALLOC
+__attribute__((tls_model("initial-exec")))
+#endif
+thread_local int realtimeDepth = 0;
+
+std::atomic<RealtimeGuard::Mode> guardMode{RealtimeGuard::Mode::Record};
+std::array<std::atomic<int>, RealtimeGuard::NumViolations> violations{};
+
+// The allocator itself, past the replaced malloc (which would count again)
+void *rawMalloc(std::size_t size) {
+#if MAYERISM_INTERPOSE_MALLOC
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+void rawFree(void *memory) {
+#if MAYERISM_INTERPOSE_MALLOC
+  __libc_free(memory);
+#else
+  std::free(memory);
+#endif
+}
+
+// Everything below runs inside operator new, so none of it may allocate
+void *allocate(std::size_t size) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  return rawMalloc(size == 0 ? 1 : size);
+}
+
+void *allocateAligned(std::size_t size, std::size_t alignment) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  size = size == 0 ? alignment : size;
+#if JUCE_WINDOWS
+  return _aligned_malloc(size, alignment);
+#elif MAYERISM_INTERPOSE_MALLOC
+  return __libc_memalign(juce::jmax(alignment, sizeof(void *)), size);
+#else
+  void *memory = nullptr;
+  return posix_memalign(&memory, juce::jmax(alignment, sizeof(void *)),
+                        size) == 0
+             ? memory
+             : nullptr;
+#endif
+}
+
+void release(void *memory) {
+  if (memory == nullptr)
+    return;
+
+  RealtimeGuard::check(RealtimeGuard::Deallocation);
+  rawFree(memory);
+}
+
+void releaseAligned(void *memory) {
+  if (memory == nullptr)
+    return;
+
+  RealtimeGuard::check(RealtimeGuard::Deallocation);
+#if JUCE_WINDOWS
+  _aligned_free(memory);
+#else
+  rawFree(memory);
+#endif
+}
+} // namespace
+
+void RealtimeGuard::enter() {
+  if (realtimeDepth++ == 0) {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    Eigen::internal::set_is_malloc_allowed(false);
+#endif
+  }
+}
+
+void RealtimeGuard::leave() {
+  if (--realtimeDepth == 0) {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    Eigen::internal::set_is_malloc_allowed(true);
+#endif
+  }
+}
+
+void RealtimeGuard::setMode(Mode mode) { guardMode = mode; }
+
+bool RealtimeGuard::isRealtimeThread() { return realtimeDepth > 0; }
+
+void RealtimeGuard::check(Violation kind) {
+  if (realtimeDepth == 0)
+    return;
+
+  violations[(size_t)kind].fetch_add(1, std::memory_order_relaxed);
+
+  if (guardMode.load(std::memory_order_relaxed) == Mode::Abort)
+    std::abort();
+}
+
+int RealtimeGuard::getNumViolations(Violation kind) {
+  return violations[(size_t)kind].load();
+}
+
+int RealtimeGuard::getNumViolations() {
+  int total = 0;
+  for (const auto &count : violations)
+    total += count.load();
+  return total;
+}
+
+void RealtimeGuard::resetViolations() {
+  for (auto &count : violations)
+    count = 0;
+}
+
+//==============================================================================
+// Global replacements; every allocation in the process goes through these
+void *operator new(std::size_t size) {
+  if (auto *memory = allocate(size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+  if (auto *memory = allocate(size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  if (auto *memory = allocateAligned(size, (std::size_t)alignment))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  if (auto *memory = allocateAligned(size, (std::size_t)alignment))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { release(memory); }
+void operator delete[](void *memory) noexcept { release(memory); }
+void operator delete(void *memory, std::size_t) noexcept { release(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { release(memory); }
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept {
+  release(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept {
+  release(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+  releaseAligned(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept {
+  releaseAligned(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept {
+  releaseAligned(memory);
+}
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept {
+  releaseAligned(memory);
+}
+
+//==============================================================================
+// C allocator replacements, for allocations that bypass operator new (C
+// code, and Eigen's aligned_malloc). Only where glibc makes that
+// possible; elsewhere just operator new and delete are checked.
+#if MAYERISM_INTERPOSE_MALLOC
+extern "C" {
+void *malloc(size_t size) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *memory, size_t size) {
+  RealtimeGuard::check(size == 0 ? RealtimeGuard::Deallocation
+                                 : RealtimeGuard::Allocation);
+  return __libc_realloc(memory, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  return __libc_memalign(alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **memory, size_t alignment, size_t size) {
+  RealtimeGuard::check(RealtimeGuard::Allocation);
+  *memory = __libc_memalign(alignment, size);
+  return *memory != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+void free(void *memory) {
+  if (memory == nullptr)
+    return;
+
+  RealtimeGuard::check(RealtimeGuard::Deallocation);
+  __libc_free(memory);
+}
+}
+#endif
+
+#endif
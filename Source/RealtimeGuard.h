@@ -0,0 +1,71 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * Realtime Guard
+ * Debug check that the audio thread neither allocates, frees nor blocks.
+ *
+ * Compiled in only with the REALTIME_CHECKS CMake option, which defines
+ * MAYERISM_REALTIME_CHECKS. A Scope marks the current thread as realtime
+ * for as long as it lives (processBlock puts one around everything).
+ * While a thread is marked:
+ * - the replaced global operator new / delete report a violation
+ * - on glibc, so do malloc, calloc, realloc, the aligned allocators and
+ *   free. That takes effect where this code is linked into an executable
+ *   (the Standalone app, the test runner); a plugin loaded by a host binds
+ *   malloc to libc first. On macOS and Windows only operator new and
+ *   delete are checked.
+ * - Eigen's allocator, used by the amp model, trips its own
+ *   EIGEN_RUNTIME_NO_MALLOC assertion (needs a build with assertions)
+ * - checkBlocking(), called where plugin code takes a lock, reports one
+ *
+ * In Record mode violations are counted per kind, for a test or the
+ * profiler overlay to read. In Abort mode the process stops at the first
+ * one, so a debugger lands on the offending call. Without the option
+ * every call below compiles to nothing.
+ */
+class RealtimeGuard {
+public:
+  enum class Mode { Record, Abort };
+  enum Violation { Allocation = 0, Deallocation, Lock, NumViolations };
+
+#if MAYERISM_REALTIME_CHECKS
+  class Scope {
+  public:
+    Scope() { enter(); }
+    ~Scope() { leave(); }
+
+  private:
+    JUCE_DECLARE_NON_COPYABLE(Scope)
+  };
+
+  static void setMode(Mode mode);
+
+  static bool isRealtimeThread();
+
+  // Reports a violation if the calling thread is marked realtime
+  static void check(Violation kind);
+  static void checkBlocking() { check(Lock); }
+
+  static int getNumViolations(Violation kind);
+  static int getNumViolations();
+  static void resetViolations();
+
+private:
+  static void enter();
+  static void leave();
+#else
+  class Scope {
+  public:
+    Scope() {}
+  };
+
+  static void setMode(Mode) {}
+  static bool isRealtimeThread() { return false; }
+  static void check(Violation) {}
+  static void checkBlocking() {}
+  static int getNumViolations(Violation) { return 0; }
+  static int getNumViolations() { return 0; }
+  static void resetViolations() {}
+#endif
+};
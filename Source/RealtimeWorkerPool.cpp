@@ -0,0 +1,64 @@
+#include "RealtimeWorkerPool.h"
+#include <thread>
+
+RealtimeWorkerPool::RealtimeWorkerPool(int numWorkers) {
+  for (int i = 0; i < numWorkers; ++i)
+    workers.push_back(std::make_unique<Worker>(i));
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool() { workers.clear(); }
+
+void RealtimeWorkerPool::run(JobFn fn, void *context) {
+  for (auto &worker : workers)
+    if (worker->tryStart(fn, context))
+      return;
+
+  fn(context);
+}
+
+void RealtimeWorkerPool::wait() {
+  for (auto &worker : workers) {
+    // Jobs take a large part of a block, so a worker that is still busy
+    // here is usually close to done; yield only if it is not
+    for (int spins = 0; worker->isBusy(); ++spins)
+      if (spins > 1000)
+        std::this_thread::yield();
+  }
+}
+
+//==============================================================================
+RealtimeWorkerPool::Worker::Worker(int index)
+    : juce::Thread("Realtime Worker " + juce::String(index + 1)) {
+  startThread(juce::Thread::Priority::highest);
+}
+
+RealtimeWorkerPool::Worker::~Worker() {
+  signalThreadShouldExit();
+  wake.signal();
+  stopThread(2000);
+}
+
+bool RealtimeWorkerPool::Worker::tryStart(JobFn fn, void *context) {
+  if (isBusy())
+    return false;
+
+  job = fn;
+  jobContext = context;
+  busy.store(true, std::memory_order_release);
+  wake.signal();
+  return true;
+}
+
+void RealtimeWorkerPool::Worker::run() {
+  // Same floating point mode as the audio thread
+  juce::ScopedNoDenormals noDenormals;
+
+  while (!threadShouldExit()) {
+    wake.wait(-1);
+
+    if (busy.load(std::memory_order_acquire)) {
+      job(jobContext);
+      busy.store(false, std::memory_order_release);
+    }
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * Realtime Worker Pool
+ * A few high-priority threads that take work off the audio thread for the
+ * length of one block, e.g. the second amp model in dual-amp mode.
+ *
+ * The audio thread hands out jobs with run(), does its own share of the
+ * block, then calls wait(), which returns once every job has finished. A
+ * job is a plain function pointer and context, so handing one out does not
+ * allocate. With no idle worker (single core machine, or all busy) the job
+ * runs inline on the caller, so results never depend on the pool's size.
+ *
+ * Waking a worker signals a juce::WaitableEvent, which takes a short,
+ * uncontended lock. wait() spins on the worker's flag; it only spins for
+ * as long as the job takes longer than the caller's own share.
+ *
+ * One caller thread at a time: the processor's chains take turns on the
+ * audio thread.
+ */
+class RealtimeWorkerPool {
+public:
+  using JobFn = void (*)(void *context);
+
+  explicit RealtimeWorkerPool(int numWorkers);
+  ~RealtimeWorkerPool();
+
+  int getNumWorkers() const { return (int)workers.size(); }
+
+  // Runs fn(context) on an idle worker, or right here if there is none
+  void run(JobFn fn, void *context);
+
+  // Barrier: returns once every job handed out since the last wait is done
+  void wait();
+
+  // One worker per spare core, up to `maxWorkers`
+  static int getDefaultNumWorkers(int maxWorkers) {
+    return juce::jlimit(0, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+  }
+
+private:
+  class Worker : private juce::Thread {
+  public:
+    explicit Worker(int index);
+    ~Worker() override;
+
+    // False if the worker is still busy with an earlier job
+    bool tryStart(JobFn fn, void *context);
+    bool isBusy() const { return busy.load(std::memory_order_acquire); }
+
+  private:
+    void run() override;
+
+    juce::WaitableEvent wake;
+    std::atomic<bool> busy{false};
+    JobFn job{nullptr};
+    void *jobContext{nullptr};
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeWorkerPool)
+};
@@ -13,12 +13,14 @@ static const double PI = 3.1415926535897931;
 #include <filesystem>
 #include <iostream>
 #include <utility>
+#include <vector>
 #include "../Modules/NeuralAmpModelerCore/NAM/dsp.h"
 #include "../Modules/AudioDSPTools/dsp/NoiseGate.h"
 #include "../Modules/AudioDSPTools/dsp/dsp.h"
 #include "../Modules/AudioDSPTools/dsp/ResamplingContainer/ResamplingContainer.h"
 #include "../Modules/AudioDSPTools/dsp/ImpulseResponse.h"
 #include "../Modules/AudioDSPTools/dsp/wav.h"
+#include "SharedWaveNet.h"
 
 // Get the sample rate of a NAM model.
 // Sometimes, the model doesn't know its own sample rate; this wrapper guesses 48k based on the way that most
@@ -39,15 +41,30 @@ public:
     // Resampling wrapper around the NAM models
     ResamplingNAM(std::unique_ptr<nam::DSP> encapsulated, const double expected_sample_rate)
         : nam::DSP(expected_sample_rate), mEncapsulated(std::move(encapsulated)), mResampler(GetNAMSampleRate(mEncapsulated))
+        , mFastResampler(GetNAMSampleRate(mEncapsulated))
     {
         // Assign the encapsulated object's processing function  to this object's member so that the resampler can use it:
         auto ProcessBlockFunc = [&](NAM_SAMPLE** input, NAM_SAMPLE** output, int numFrames)
         {
             mEncapsulated->process(input[0], output[0], numFrames);
             mEncapsulated->finalize_(numFrames);
+            if (mWarmingOther)
+                for (int i = 0; i < numFrames; i++)
+                    PushTap(output[0][i]);
         };
         mBlockProcessFunc = ProcessBlockFunc;
 
+        // The resampler that is not live reads the model output the live one recorded, instead of running the model
+        auto TapBlockFunc = [&](NAM_SAMPLE** input, NAM_SAMPLE** output, int numFrames)
+        {
+            for (int i = 0; i < numFrames; i++)
+                output[0][i] = mTapRead < mTapWrite ? mTap[mTapRead++ & mTapMask] : (NAM_SAMPLE)0.0;
+        };
+        mTapBlockFunc = TapBlockFunc;
+
+        // A batched model is told its largest block in Reset()
+        mSharedWaveNet = dynamic_cast<SharedWaveNet*>(mEncapsulated.get());
+
         // Get the other information from the encapsulated NAM so that we can tell the outside world about what we're
         // holding.
         if (mEncapsulated->HasLoudness())
@@ -68,25 +85,29 @@ public:
 
     void process(NAM_SAMPLE* input, NAM_SAMPLE* output, const int num_frames) override
     {
-        if (!mFinalized)
-            throw std::runtime_error("Processing was called before the last block was finalized!");
-        if (num_frames > mMaxExternalBlockSize)
-            // We can afford to be careful
-            throw std::runtime_error("More frames were provided than the max expected!");
+        mWarmingOther = false;
+        ProcessLive(input, output, num_frames);
+    };
 
-        if (!NeedToResample())
+    // The same, and the block through the resampler that is not live into `otherOutput`. That one is fed the model
+    // output the live one produces, not a second run of the model, so that its filters hold the recent signal when a
+    // caller crossfades to it. Without resampling both outputs are the model's.
+    void ProcessBoth(NAM_SAMPLE* input, NAM_SAMPLE* output, NAM_SAMPLE* otherOutput, const int num_frames)
+    {
+        if (!mWarmingOther)
         {
-            mEncapsulated->process(input, output, num_frames);
-            mEncapsulated->finalize_(num_frames);
-        }
-        else
-        {
-            mResampler.ProcessBlock(&input, &output, num_frames, mBlockProcessFunc);
+            mTapRead = mTapWrite = 0;
+            mWarmingOther = true;
         }
 
-        // Prepare for external call to .finalize_()
-        lastNumExternalFramesProcessed = num_frames;
-        mFinalized = false;
+        ProcessLive(input, output, num_frames);
+
+        if (!NeedToResample())
+            std::copy(output, output + num_frames, otherOutput);
+        else if (mUseFastResampler)
+            mResampler.ProcessBlock(&input, &otherOutput, num_frames, mTapBlockFunc);
+        else
+            mFastResampler.ProcessBlock(&input, &otherOutput, num_frames, mTapBlockFunc);
     };
 
     void finalize_(const int num_frames) override
@@ -104,24 +125,64 @@ public:
         mFinalized = true;
     };
 
-    int GetLatency() const { return NeedToResample() ? mResampler.GetLatency() : 0; };
+    int GetLatency() const
+    {
+        if (!NeedToResample())
+            return GetModelLatency();
+        return (mUseFastResampler ? mFastResampler.GetLatency() : mResampler.GetLatency()) + GetModelLatency();
+    };
+
+    // The part of the latency the encapsulated model adds itself, at the external rate: a batched SharedWaveNet's
+    // held-back block, rounded to the nearest sample when resampling.
+    int GetModelLatency() const
+    {
+        if (mSharedWaveNet == nullptr)
+            return 0;
+        return static_cast<int>(
+            std::lround(mSharedWaveNet->getLatency() * GetExpectedSampleRate() / GetEncapsulatedSampleRate()));
+    };
+
+    // Use the shorter resampling kernel: about a third of the work per sample, with a wider transition band and more
+    // aliasing near Nyquist. The filter history is not carried over: callers warm the other resampler with
+    // ProcessBoth() and crossfade to it before switching.
+    void SetFastResampling(const bool useFast) { mUseFastResampler = useFast; };
+    bool IsFastResampling() const { return mUseFastResampler; };
 
     void Reset(const double sampleRate, const int maxBlockSize)
     {
         mExpectedSampleRate = sampleRate;
         mMaxExternalBlockSize = maxBlockSize;
         mResampler.Reset(sampleRate, maxBlockSize);
+        mFastResampler.Reset(sampleRate, maxBlockSize);
 
         // Allocations in the encapsulated model (HACK)
         // Stolen some code from the resampler; it'd be nice to have these exposed as methods? :)
         const double mUpRatio = sampleRate / GetEncapsulatedSampleRate();
         const auto maxEncapsulatedBlockSize = static_cast<int>(std::ceil(static_cast<double>(maxBlockSize) / mUpRatio));
-        std::vector<NAM_SAMPLE> input, output;
-        for (int i = 0; i < maxEncapsulatedBlockSize; i++)
-            input.push_back((NAM_SAMPLE)0.0);
-        output.resize(maxEncapsulatedBlockSize); // Doesn't matter what's in here
-        mEncapsulated->process(input.data(), output.data(), maxEncapsulatedBlockSize);
-        mEncapsulated->finalize_(maxEncapsulatedBlockSize);
+        // A SharedWaveNet never allocates as it processes, and running it here would hand its block to the batch off
+        // the audio thread: it only needs to know its block size
+        if (mSharedWaveNet != nullptr)
+        {
+            mSharedWaveNet->setMaxBlockSize(maxEncapsulatedBlockSize);
+        }
+        else
+        {
+            std::vector<NAM_SAMPLE> input, output;
+            for (int i = 0; i < maxEncapsulatedBlockSize; i++)
+                input.push_back((NAM_SAMPLE)0.0);
+            output.resize(maxEncapsulatedBlockSize); // Doesn't matter what's in here
+            mEncapsulated->process(input.data(), output.data(), maxEncapsulatedBlockSize);
+            mEncapsulated->finalize_(maxEncapsulatedBlockSize);
+        }
+
+        // Room for a few blocks of model output between the two resamplers
+        size_t tapSize = 1;
+        while (tapSize < 4 * static_cast<size_t>(maxEncapsulatedBlockSize))
+            tapSize *= 2;
+        mTap.assign(tapSize, (NAM_SAMPLE)0.0);
+        mTapMask = tapSize - 1;
+        mTapRead = mTapWrite = 0;
+        mWarmingOther = false;
 
         mFinalized = true; // prepare for `.process()`
     };
@@ -131,8 +192,48 @@ public:
 
 private:
     bool NeedToResample() const { return GetExpectedSampleRate() != GetEncapsulatedSampleRate(); };
+
+    // The block through the live resampler and the model
+    void ProcessLive(NAM_SAMPLE* input, NAM_SAMPLE* output, const int num_frames)
+    {
+        if (!mFinalized)
+            throw std::runtime_error("Processing was called before the last block was finalized!");
+        if (num_frames > mMaxExternalBlockSize)
+            // We can afford to be careful
+            throw std::runtime_error("More frames were provided than the max expected!");
+
+        if (!NeedToResample())
+        {
+            mEncapsulated->process(input, output, num_frames);
+            mEncapsulated->finalize_(num_frames);
+        }
+        else if (mUseFastResampler)
+        {
+            mFastResampler.ProcessBlock(&input, &output, num_frames, mBlockProcessFunc);
+        }
+        else
+        {
+            mResampler.ProcessBlock(&input, &output, num_frames, mBlockProcessFunc);
+        }
+
+        // Prepare for external call to .finalize_()
+        lastNumExternalFramesProcessed = num_frames;
+        mFinalized = false;
+    };
+
+    // Records one sample of model output for the other resampler
+    void PushTap(const NAM_SAMPLE sample)
+    {
+        mTap[mTapWrite++ & mTapMask] = sample;
+        // The reader fell a whole ring behind: it skips ahead
+        if (mTapWrite - mTapRead > mTap.size())
+            mTapRead = mTapWrite - mTap.size();
+    };
+
     // The encapsulated NAM
     std::unique_ptr<nam::DSP> mEncapsulated;
+    // mEncapsulated, if it is a SharedWaveNet
+    SharedWaveNet* mSharedWaveNet = nullptr;
     // The processing for NAM is a little weird--there's a call to .finalize_() that's expected.
     // This flag makes sure that the NAM sees alternating instances of .process() and .finalize_()
     // A value of `true` means that we expect the ResamplingNAM object to see .process() next;
@@ -141,6 +242,9 @@ private:
 
     // The resampling wrapper
     dsp::ResamplingContainer<NAM_SAMPLE, 1, 12> mResampler;
+    // Same, with a 4-lobe Lanczos kernel instead of 12
+    dsp::ResamplingContainer<NAM_SAMPLE, 1, 4> mFastResampler;
+    bool mUseFastResampler = false;
 
     // Used to check that we don't get too large a block to process.
     int mMaxExternalBlockSize = 0;
@@ -150,6 +254,15 @@ private:
 
     // This function is defined to conform to the interface expected by the iPlug2 resampler.
     std::function<void(NAM_SAMPLE**, NAM_SAMPLE**, int)> mBlockProcessFunc;
+    // The same shape, for the resampler that is not live: reads the tap
+    std::function<void(NAM_SAMPLE**, NAM_SAMPLE**, int)> mTapBlockFunc;
+
+    // While ProcessBoth() runs, the model output at its own rate, from the live resampler to the other one
+    std::vector<NAM_SAMPLE> mTap;
+    size_t mTapMask = 0;
+    size_t mTapRead = 0;
+    size_t mTapWrite = 0;
+    bool mWarmingOther = false;
 };
 
 #endif
\ No newline at end of file
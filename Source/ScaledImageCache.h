@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include <tuple>
+
+/**
+ * Scaled Image Cache
+ * Draws images at exactly the device pixel size they end up at, so paint()
+ * is a straight blit instead of a resample.
+ *
+ * Each (image, source area, device size) is rescaled once with high
+ * quality and kept. The device size accounts for the editor scale factor
+ * (e.g. the 0.8 small-window mode) and the display scale, read from the
+ * Graphics context; when that changes the cache is dropped and refilled
+ * lazily.
+ *
+ * Keys use the source image's pixel data, so sources must outlive the
+ * cache (the SharedImages entries do).
+ */
+class ScaledImageCache {
+public:
+  ScaledImageCache() {}
+  ~ScaledImageCache() {}
+
+  void draw(juce::Graphics &g, const juce::Image &source,
+            juce::Rectangle<int> sourceArea, juce::Rectangle<float> area) {
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != cachedScale) {
+      images.clear();
+      cachedScale = scale;
+    }
+
+    // Snap to whole device pixels so the blit is not interpolated
+    const auto device = (area * scale).getSmallestIntegerContainer();
+    if (device.isEmpty())
+      return;
+
+    const Key key{&*source.getPixelData(), sourceArea.getX(),
+                  sourceArea.getY(),       sourceArea.getWidth(),
+                  sourceArea.getHeight(),  device.getWidth(),
+                  device.getHeight()};
+
+    auto &image = images[key];
+    if (!image.isValid())
+      image = source.getClippedImage(sourceArea).rescaled(
+          device.getWidth(), device.getHeight(),
+          juce::Graphics::highResamplingQuality);
+
+    g.drawImageTransformed(
+        image, juce::AffineTransform::translation((float)device.getX(),
+                                                  (float)device.getY())
+                   .scaled(1.0f / scale));
+  }
+
+  void draw(juce::Graphics &g, const juce::Image &source, int x, int y) {
+    draw(g, source, source.getBounds(),
+         source.getBounds().toFloat().translated((float)x, (float)y));
+  }
+
+private:
+  using Key = std::tuple<const void *, int, int, int, int, int, int>;
+
+  std::map<Key, juce::Image> images;
+  float cachedScale = 0.0f;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScaledImageCache)
+};
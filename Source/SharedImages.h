@@ -0,0 +1,45 @@
+#pragma once
+#include "RealtimeGuard.h"
+#include <JuceHeader.h>
+#include <map>
+
+/**
+ * Shared Images
+ * Decodes each embedded image once per process and hands out shared
+ * references to the same pixels.
+ *
+ * Hold a juce::SharedResourcePointer<SharedImages>. The processor holds
+ * one too, so closing and reopening an editor (or opening a second
+ * instance's editor) reuses the decoded images instead of decoding every
+ * PNG again. The images are treated as read-only; take a
+ * createCopy() before drawing into one.
+ *
+ * Usage:
+ *   juce::SharedResourcePointer<SharedImages> images;
+ *   auto knob = images->get(BinaryData::knob_png, BinaryData::knob_pngSize);
+ */
+class SharedImages {
+public:
+  SharedImages() {}
+  ~SharedImages() {}
+
+  // Thread-safe; decodes on first use of this data
+  juce::Image get(const void *data, int size) {
+    RealtimeGuard::checkBlocking();
+    const juce::ScopedLock scope(lock);
+
+    auto &image = images[data];
+    if (!image.isValid())
+      image = juce::ImageFileFormat::loadFrom(data, (size_t)size);
+
+    return image;
+  }
+
+private:
+  juce::CriticalSection lock;
+
+  // Keyed by the embedded data, which lives as long as the binary
+  std::map<const void *, juce::Image> images;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedImages)
+};
@@ -0,0 +1,708 @@
+#include "SharedWaveNet.h"
+#include "Waveshapers.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+SharedWaveNet::Activation parseActivation(const std::string &name) {
+  using A = SharedWaveNet::Activation;
+
+  // The plugin runs NAM's Tanh and Fasttanh as the same rational tanh
+  if (name == "Tanh" || name == "Fasttanh")
+    return A::Tanh;
+  if (name == "Sigmoid")
+    return A::Sigmoid;
+  if (name == "ReLU")
+    return A::ReLU;
+  if (name == "Hardtanh")
+    return A::Hardtanh;
+
+  throw std::runtime_error("Unsupported WaveNet activation: " + name);
+}
+
+// Reads the model's weights in NAM's order into the shared buffer
+class WeightReader {
+public:
+  WeightReader(const std::vector<float> &source, std::vector<float> &storage)
+      : source(source), storage(storage) {}
+
+  float next() {
+    if (read >= source.size())
+      throw std::runtime_error("WaveNet model has too few weights");
+    return source[read++];
+  }
+
+  SharedWaveNet::Weights::Block allocate(int rows, int cols) {
+    SharedWaveNet::Weights::Block block{storage.size(), rows, cols};
+    storage.resize(storage.size() + (size_t)rows * (size_t)cols, 0.0f);
+    return block;
+  }
+
+  float &at(const SharedWaveNet::Weights::Block &block, int row, int col) {
+    return storage[block.offset + (size_t)col * (size_t)block.rows +
+                   (size_t)row];
+  }
+
+  // A 1x1 convolution: row by row, then the bias if it has one
+  void readConv1x1(const SharedWaveNet::Weights::Block &weight,
+                   const SharedWaveNet::Weights::Block *bias) {
+    for (int i = 0; i < weight.rows; ++i)
+      for (int j = 0; j < weight.cols; ++j)
+        at(weight, i, j) = next();
+
+    if (bias != nullptr)
+      for (int i = 0; i < bias->rows; ++i)
+        at(*bias, i, 0) = next();
+  }
+
+  bool isAtEnd() const { return read == source.size(); }
+
+private:
+  const std::vector<float> &source;
+  std::vector<float> &storage;
+  size_t read{0};
+};
+} // namespace
+
+std::shared_ptr<const SharedWaveNet::Weights>
+SharedWaveNet::Weights::parse(const nam::dspData &config,
+                              WeightQuantizer::Precision precision) {
+  if (config.architecture != "WaveNet")
+    throw std::runtime_error("Not a WaveNet model: " + config.architecture);
+
+  const auto &json = config.config;
+  if (json.contains("head") && !json["head"].is_null())
+    throw std::runtime_error("WaveNet post-stack heads are not supported");
+
+  auto parsed = std::make_shared<Weights>();
+  parsed->expectedSampleRate = config.expected_sample_rate;
+
+  if (config.metadata.is_object() && config.metadata.contains("loudness") &&
+      config.metadata["loudness"].is_number()) {
+    parsed->hasLoudness = true;
+    parsed->loudness = config.metadata["loudness"].get<double>();
+  }
+
+  WeightReader reader(config.weights, parsed->storage);
+  parsed->storage.reserve(config.weights.size() + 64);
+
+  int receptiveField = 1;
+  for (const auto &arrayConfig : json.at("layers")) {
+    LayerArray array;
+    array.inputSize = arrayConfig.at("input_size").get<int>();
+    array.conditionSize = arrayConfig.at("condition_size").get<int>();
+    array.headSize = arrayConfig.at("head_size").get<int>();
+    array.channels = arrayConfig.at("channels").get<int>();
+    array.kernelSize = arrayConfig.at("kernel_size").get<int>();
+    array.gated = arrayConfig.at("gated").get<bool>();
+    array.activation =
+        parseActivation(arrayConfig.at("activation").get<std::string>());
+    const bool headBias = arrayConfig.at("head_bias").get<bool>();
+
+    const int channels = array.channels;
+    const int gatedChannels = array.gated ? 2 * channels : channels;
+    const int kernelSize = array.kernelSize;
+
+    if (array.conditionSize != 1)
+      throw std::runtime_error("WaveNet condition must be the mono input");
+    if (parsed->arrays.empty() ? array.inputSize != 1
+                               : array.inputSize !=
+                                     parsed->arrays.back().channels ||
+                                     channels !=
+                                         parsed->arrays.back().headSize)
+      throw std::runtime_error("WaveNet layer arrays do not connect");
+
+    // Input rechannel, no bias
+    array.rechannel = reader.allocate(channels, array.inputSize);
+    reader.readConv1x1(array.rechannel, nullptr);
+
+    for (const auto &dilation : arrayConfig.at("dilations")) {
+      Layer layer;
+      layer.dilation = dilation.get<int>();
+      layer.convMix = reader.allocate(
+          gatedChannels, kernelSize * channels + array.conditionSize);
+      layer.convBias = reader.allocate(gatedChannels, 1);
+      layer.mixer = reader.allocate(channels, channels);
+      layer.mixerBias = reader.allocate(channels, 1);
+
+      // Dilated convolution, flattened output channel first, then input
+      // channel, then tap. Tap k lands in column block k of convMix.
+      for (int i = 0; i < gatedChannels; ++i)
+        for (int j = 0; j < channels; ++j)
+          for (int k = 0; k < kernelSize; ++k)
+            reader.at(layer.convMix, i, k * channels + j) = reader.next();
+      for (int i = 0; i < gatedChannels; ++i)
+        reader.at(layer.convBias, i, 0) = reader.next();
+
+      // Input mixin, no bias: the last columns of convMix
+      for (int i = 0; i < gatedChannels; ++i)
+        for (int j = 0; j < array.conditionSize; ++j)
+          reader.at(layer.convMix, i, kernelSize * channels + j) =
+              reader.next();
+
+      reader.readConv1x1(layer.mixer, &layer.mixerBias);
+
+      receptiveField += layer.dilation * (kernelSize - 1);
+      array.layers.push_back(layer);
+    }
+
+    array.headRechannel = reader.allocate(array.headSize, channels);
+    if (headBias)
+      array.headBias = reader.allocate(array.headSize, 1);
+    reader.readConv1x1(array.headRechannel,
+                       headBias ? &array.headBias : nullptr);
+
+    parsed->arrays.push_back(std::move(array));
+  }
+
+  if (parsed->arrays.empty() || parsed->arrays.back().headSize != 1)
+    throw std::runtime_error("WaveNet must end in a single head channel");
+
+  parsed->headScale = reader.next();
+  if (!reader.isAtEnd())
+    throw std::runtime_error("WaveNet model has too many weights");
+
+  parsed->receptiveField = receptiveField;
+  parsed->reduce(precision);
+  return parsed;
+}
+
+void SharedWaveNet::Weights::reduce(WeightQuantizer::Precision newPrecision) {
+  using Precision = WeightQuantizer::Precision;
+
+  precision = newPrecision;
+  if (precision == Precision::Float32)
+    return;
+
+  // Biases and row scales stay in float storage, rebuilt without the
+  // matrices
+  std::vector<float> floats;
+
+  const auto keepVector = [&](Block &block) {
+    const size_t offset = floats.size();
+    floats.insert(floats.end(), storage.begin() + (ptrdiff_t)block.offset,
+                  storage.begin() + (ptrdiff_t)(block.offset + block.rows));
+    block.offset = offset;
+  };
+
+  const auto packMatrix = [&](Block &block) {
+    const float *source = storage.data() + block.offset;
+    const auto at = [&](int row, int col) {
+      return source[(size_t)col * (size_t)block.rows + (size_t)row];
+    };
+
+    // Column-major, each column padded with zero rows
+    const int paddedRows = weightkernels::getPaddedRows(block.rows);
+
+    if (precision == Precision::Float16) {
+      block.offset = halves.size();
+      for (int j = 0; j < block.cols; ++j)
+        for (int i = 0; i < paddedRows; ++i)
+          halves.push_back(
+              weightkernels::toHalf(i < block.rows ? at(i, j) : 0.0f));
+      return;
+    }
+
+    // Int8: each row (output channel) scaled so its largest weight is 127
+    block.scales = floats.size();
+    for (int i = 0; i < paddedRows; ++i) {
+      float largest = 0.0f;
+      if (i < block.rows)
+        for (int j = 0; j < block.cols; ++j)
+          largest = std::max(largest, std::abs(at(i, j)));
+      floats.push_back(largest > 0.0f ? largest / 127.0f : 1.0f);
+    }
+
+    block.offset = bytes.size();
+    for (int j = 0; j < block.cols; ++j)
+      for (int i = 0; i < paddedRows; ++i)
+        bytes.push_back(
+            i < block.rows
+                ? (int8_t)std::nearbyint(at(i, j) / floats[block.scales + i])
+                : (int8_t)0);
+  };
+
+  for (auto &array : arrays) {
+    packMatrix(array.rechannel);
+    for (auto &layer : array.layers) {
+      packMatrix(layer.convMix);
+      keepVector(layer.convBias);
+      packMatrix(layer.mixer);
+      keepVector(layer.mixerBias);
+    }
+    packMatrix(array.headRechannel);
+    keepVector(array.headBias);
+  }
+
+  storage = std::move(floats);
+  storage.shrink_to_fit();
+  halves.shrink_to_fit();
+  bytes.shrink_to_fit();
+}
+
+SharedWaveNet::SharedWaveNet(std::shared_ptr<const Weights> sharedWeights,
+                             std::shared_ptr<Batch> sharedBatch)
+    : nam::DSP(sharedWeights->expectedSampleRate),
+      weights(std::move(sharedWeights)), kernels(weightkernels::get()),
+      batch(std::move(sharedBatch)) {
+  if (weights->hasLoudness)
+    SetLoudness(weights->loudness);
+
+  int maxStacked = 0;
+  int maxActivations = 0;
+  int maxChannels = 0;
+
+  for (const auto &array : weights->arrays) {
+    auto &states = layerStates.emplace_back();
+    for (const auto &layer : array.layers) {
+      auto &state = states.emplace_back();
+      state.history = layer.dilation * (array.kernelSize - 1);
+      state.buffer = Matrix::Zero(array.channels, state.history + rewindSpan);
+      state.position = state.history;
+
+      maxStacked = std::max(maxStacked, layer.convMix.cols);
+      maxActivations = std::max(maxActivations, layer.convMix.rows);
+    }
+    maxChannels = std::max({maxChannels, array.channels, array.headSize});
+  }
+
+  tileInput.resize((size_t)tileSize);
+  stacked.resize((size_t)maxStacked * tileSize);
+  activations.resize((size_t)maxActivations * tileSize);
+  mixed.resize((size_t)maxChannels * tileSize);
+  for (auto &buffer : arrayOutputs)
+    buffer.resize((size_t)maxChannels * tileSize);
+  for (auto &buffer : heads)
+    buffer.resize((size_t)maxChannels * tileSize);
+}
+
+SharedWaveNet::~SharedWaveNet() { leave(); }
+
+void SharedWaveNet::prewarm() {
+  // The history is this instance's again once its waiting block has run.
+  // Prewarming is off the audio thread, so it never runs the batch.
+  finishWaiting();
+
+  // Settle every history buffer on what silence leaves in it
+  std::vector<float> silence((size_t)tileSize, 0.0f), output((size_t)tileSize);
+  for (int done = 0; done < weights->receptiveField; done += tileSize)
+    processAlone(silence.data(), output.data(), tileSize);
+}
+
+void SharedWaveNet::process(NAM_SAMPLE *input, NAM_SAMPLE *output,
+                            const int num_frames) {
+  if (batchDelay == 0) {
+    processAlone(input, output, num_frames);
+    return;
+  }
+
+  // Longer blocks than announced go through as several, which keeps the
+  // delay the same
+  for (int start = 0; start < num_frames; start += batchDelay)
+    processBatched(input + start, output + start,
+                   std::min(batchDelay, num_frames - start));
+}
+
+void SharedWaveNet::setMaxBlockSize(int maxFrames) {
+  if (batch == nullptr)
+    return;
+
+  leave();
+
+  batchDelay = std::max(1, maxFrames);
+  waitingInput.assign((size_t)batchDelay, 0.0f);
+  waitingOutput.assign((size_t)batchDelay, 0.0f);
+  waitingCount = 0;
+  waitingDone = 0;
+
+  // Holds the output between batchDelay and 2 * batchDelay samples; it
+  // starts with one block of silence
+  delayLine.assign((size_t)(2 * batchDelay), 0.0f);
+  delayRead = 0;
+  delayWrite = batchDelay;
+
+  join();
+}
+
+void SharedWaveNet::processAlone(const float *input, float *output,
+                                 int numFrames) {
+  for (int start = 0; start < numFrames; start += tileSize) {
+    const Lane lane{this, input + start, output + start,
+                    std::min(tileSize, numFrames - start)};
+    processLanes(&lane, 1);
+  }
+}
+
+void SharedWaveNet::processBatched(const float *input, float *output,
+                                   int numFrames) {
+  const int size = (int)delayLine.size();
+
+  // The previous block's output joins the delay line...
+  collect();
+  for (int i = 0; i < waitingCount; ++i) {
+    delayLine[(size_t)delayWrite] = waitingOutput[(size_t)i];
+    delayWrite = delayWrite + 1 == size ? 0 : delayWrite + 1;
+  }
+
+  // ...which always holds at least batchDelay samples
+  for (int i = 0; i < numFrames; ++i) {
+    output[i] = delayLine[(size_t)delayRead];
+    delayRead = delayRead + 1 == size ? 0 : delayRead + 1;
+  }
+
+  // This block waits for the next pass, or runs now without a slot
+  std::copy(input, input + numFrames, waitingInput.begin());
+  waitingCount = numFrames;
+  waitingDone = 0;
+
+  if (slotIndex < 0) {
+    processAlone(waitingInput.data(), waitingOutput.data(), numFrames);
+    waitingDone = numFrames;
+    return;
+  }
+
+  batch->slots[(size_t)slotIndex].state.store(Batch::Waiting,
+                                              std::memory_order_release);
+}
+
+void SharedWaveNet::collect() {
+  if (slotIndex < 0)
+    return;
+
+  auto &slot = batch->slots[(size_t)slotIndex];
+  int state = Batch::Waiting;
+  if (slot.state.compare_exchange_strong(state, Batch::Running,
+                                         std::memory_order_acquire)) {
+    runBatch();
+    return;
+  }
+
+  finishWaiting();
+}
+
+void SharedWaveNet::finishWaiting() {
+  if (slotIndex < 0)
+    return;
+
+  // Another member's pass holds this block one tile at a time, so the wait
+  // is for at most the tile under way. Whatever is left of the block then
+  // runs here, alone.
+  auto &slot = batch->slots[(size_t)slotIndex];
+  for (int spins = 0;; ++spins) {
+    int state = slot.state.load(std::memory_order_acquire);
+    if (state == Batch::Idle)
+      return;
+
+    if (state == Batch::Waiting &&
+        slot.state.compare_exchange_strong(state, Batch::Running,
+                                           std::memory_order_acquire)) {
+      processAlone(waitingInput.data() + waitingDone,
+                   waitingOutput.data() + waitingDone,
+                   waitingCount - waitingDone);
+      waitingDone = waitingCount;
+      slot.state.store(Batch::Idle, std::memory_order_release);
+      return;
+    }
+
+    if (spins > 1000)
+      std::this_thread::yield();
+  }
+}
+
+void SharedWaveNet::runBatch() {
+  // This instance's block, then every other one waiting now. Other members
+  // are claimed for one tile at a time and handed back between tiles, so
+  // their own threads can take over what is left of their blocks.
+  std::array<int, Batch::maxMembers> others;
+  int numOthers = 0;
+  for (int i = 0; i < Batch::maxMembers; ++i)
+    if (i != slotIndex && batch->slots[(size_t)i].state.load(
+                              std::memory_order_relaxed) == Batch::Waiting)
+      others[(size_t)numOthers++] = i;
+
+  // Fill each tile with the next samples of as many members as fit
+  std::array<Lane, Batch::maxMembers> lanes;
+  std::array<int, Batch::maxMembers> laneSlots;
+  for (;;) {
+    int numLanes = 0;
+    int columns = 0;
+
+    if (waitingDone < waitingCount) {
+      const int n = std::min(waitingCount - waitingDone, tileSize);
+      lanes[(size_t)numLanes] = {this, waitingInput.data() + waitingDone,
+                                 waitingOutput.data() + waitingDone, n};
+      laneSlots[(size_t)numLanes++] = slotIndex;
+      columns += n;
+    }
+
+    for (int o = 0; o < numOthers && columns < tileSize; ++o) {
+      const int index = others[(size_t)o];
+      if (index < 0)
+        continue;
+
+      // Gone, finished, or taken over by its own thread
+      auto &slot = batch->slots[(size_t)index];
+      int state = Batch::Waiting;
+      if (!slot.state.compare_exchange_strong(state, Batch::Running,
+                                              std::memory_order_acquire)) {
+        others[(size_t)o] = -1;
+        continue;
+      }
+
+      auto *member = slot.member;
+      const int n = std::min(member->waitingCount - member->waitingDone,
+                             tileSize - columns);
+      lanes[(size_t)numLanes] = {
+          member, member->waitingInput.data() + member->waitingDone,
+          member->waitingOutput.data() + member->waitingDone, n};
+      laneSlots[(size_t)numLanes++] = index;
+      columns += n;
+    }
+
+    if (numLanes == 0)
+      break;
+    processLanes(lanes.data(), numLanes);
+
+    for (int l = 0; l < numLanes; ++l) {
+      auto *member = lanes[(size_t)l].net;
+      member->waitingDone += lanes[(size_t)l].n;
+      if (member != this)
+        batch->slots[(size_t)laneSlots[(size_t)l]].state.store(
+            member->waitingDone < member->waitingCount ? Batch::Waiting
+                                                       : Batch::Idle,
+            std::memory_order_release);
+    }
+  }
+
+  batch->slots[(size_t)slotIndex].state.store(Batch::Idle,
+                                              std::memory_order_release);
+}
+
+void SharedWaveNet::join() {
+  // No free slot: the model runs alone, with the same delay
+  for (int i = 0; i < Batch::maxMembers; ++i) {
+    auto &slot = batch->slots[(size_t)i];
+    int state = Batch::Free;
+    if (slot.state.compare_exchange_strong(state, Batch::Changing,
+                                           std::memory_order_acquire)) {
+      slot.member = this;
+      slotIndex = i;
+      slot.state.store(Batch::Idle, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+void SharedWaveNet::leave() {
+  if (slotIndex < 0)
+    return;
+
+  // A block still waiting is dropped; one running in another member's
+  // pass is waited out
+  auto &slot = batch->slots[(size_t)slotIndex];
+  for (;;) {
+    int state = slot.state.load(std::memory_order_acquire);
+    if (state != Batch::Running &&
+        slot.state.compare_exchange_weak(state, Batch::Changing,
+                                         std::memory_order_acquire))
+      break;
+    std::this_thread::yield();
+  }
+
+  slot.member = nullptr;
+  slot.state.store(Batch::Free, std::memory_order_release);
+  slotIndex = -1;
+}
+
+void SharedWaveNet::processLanes(const Lane *lanes, int numLanes) {
+  const auto &w = *weights;
+
+  // Each lane's columns start at offsets[i]
+  std::array<int, Batch::maxMembers> offsets;
+  int n = 0;
+  for (int i = 0; i < numLanes; ++i) {
+    offsets[(size_t)i] = n;
+    n += lanes[i].n;
+  }
+
+  // The lanes' inputs side by side
+  const float *input = lanes[0].input;
+  if (numLanes > 1) {
+    for (int i = 0; i < numLanes; ++i)
+      std::copy(lanes[i].input, lanes[i].input + lanes[i].n,
+                tileInput.begin() + offsets[(size_t)i]);
+    input = tileInput.data();
+  }
+
+  // Array 0 reads the input; each later one reads the previous one's
+  // output, and takes its head from the previous head's rechannel
+  ConstMatrixMap condition(input, 1, n);
+  const float *arrayInput = input;
+  int arrayInputRows = 1;
+
+  MatrixMap(heads[0].data(), w.arrays.front().channels, n).setZero();
+
+  for (size_t a = 0; a < w.arrays.size(); ++a) {
+    const auto &array = w.arrays[a];
+    const int channels = array.channels;
+    const int kernelSize = array.kernelSize;
+
+    MatrixMap head(heads[a % 2].data(), channels, n);
+    MatrixMap arrayOutput(arrayOutputs[a % 2].data(), channels, n);
+    MatrixMap mix(mixed.data(), channels, n);
+
+    // Keep room for this tile in every layer's history of every lane
+    for (int i = 0; i < numLanes; ++i)
+      for (auto &state : lanes[i].net->layerStates[a]) {
+        if (state.position + lanes[i].n <= state.buffer.cols())
+          continue;
+
+        float *data = state.buffer.data();
+        std::memmove(
+            data, data + (size_t)(state.position - state.history) * channels,
+            sizeof(float) * (size_t)state.history * channels);
+        state.position = state.history;
+      }
+
+    // Rechannel, into each lane's first layer history
+    multiply(array.rechannel, arrayInput, arrayInputRows, mix.data(),
+             channels, n);
+    for (int i = 0; i < numLanes; ++i) {
+      auto &state = lanes[i].net->layerStates[a][0];
+      state.buffer.middleCols(state.position, lanes[i].n) =
+          mix.middleCols(offsets[(size_t)i], lanes[i].n);
+    }
+
+    for (size_t l = 0; l < array.layers.size(); ++l) {
+      const auto &layer = array.layers[l];
+
+      // Kernel taps from each lane's history, oldest first, then the
+      // condition: one operand for the dilated convolution and the input
+      // mixin together
+      MatrixMap taps(stacked.data(), layer.convMix.cols, n);
+      for (int i = 0; i < numLanes; ++i) {
+        const auto &state = lanes[i].net->layerStates[a][l];
+        for (int k = 0; k < kernelSize; ++k)
+          taps.block(k * channels, offsets[(size_t)i], channels, lanes[i].n) =
+              state.buffer.middleCols(
+                  state.position + layer.dilation * (k + 1 - kernelSize),
+                  lanes[i].n);
+      }
+      taps.bottomRows(array.conditionSize) = condition;
+
+      MatrixMap z(activations.data(), layer.convMix.rows, n);
+      multiply(layer.convMix, taps.data(), layer.convMix.cols, z.data(),
+               layer.convMix.rows, n);
+      z.colwise() += w.mapVector(layer.convBias);
+
+      // Gated, as in NAM: the activation on the top half only, and a
+      // sigmoid on the bottom half's own values
+      if (!array.gated) {
+        activate(array.activation, z.data(), (int)z.size());
+      } else {
+        for (int t = 0; t < n; ++t)
+          activate(array.activation, z.col(t).data(), channels);
+
+        auto gate = z.bottomRows(channels).array();
+        gate = 1.0f / (1.0f + (-gate).exp());
+        z.topRows(channels).array() *= gate;
+      }
+
+      const auto gatedOutput = z.topRows(channels);
+      head += gatedOutput;
+
+      // Residual into each lane's next layer history, or the array's
+      // output
+      multiply(layer.mixer, z.data(), layer.convMix.rows, mix.data(),
+               channels, n);
+
+      const bool last = l + 1 == array.layers.size();
+      for (int i = 0; i < numLanes; ++i) {
+        auto &states = lanes[i].net->layerStates[a];
+        const int offset = offsets[(size_t)i];
+        const int laneColumns = lanes[i].n;
+
+        MatrixMap layerOutput(
+            last ? arrayOutput.col(offset).data()
+                 : states[l + 1].buffer.col(states[l + 1].position).data(),
+            channels, laneColumns);
+        layerOutput = mix.middleCols(offset, laneColumns) +
+                      states[l].buffer.middleCols(states[l].position,
+                                                  laneColumns);
+        layerOutput.colwise() += w.mapVector(layer.mixerBias);
+      }
+    }
+
+    for (int i = 0; i < numLanes; ++i)
+      for (auto &state : lanes[i].net->layerStates[a])
+        state.position += lanes[i].n;
+
+    // The head's rechannel is the next array's head, or the output
+    const int headSize = array.headSize;
+    MatrixMap nextHead(heads[(a + 1) % 2].data(), headSize, n);
+    multiply(array.headRechannel, head.data(), channels, nextHead.data(),
+             headSize, n);
+    if (array.headBias.rows > 0)
+      nextHead.colwise() += w.mapVector(array.headBias);
+
+    arrayInput = arrayOutput.data();
+    arrayInputRows = channels;
+  }
+
+  const float *finalHead = heads[w.arrays.size() % 2].data();
+  for (int i = 0; i < numLanes; ++i)
+    for (int t = 0; t < lanes[i].n; ++t)
+      lanes[i].output[t] = w.headScale * finalHead[offsets[(size_t)i] + t];
+}
+
+void SharedWaveNet::multiply(const Weights::Block &matrix, const float *x,
+                             int xStride, float *y, int yStride,
+                             int n) const {
+  using Precision = WeightQuantizer::Precision;
+  const auto &w = *weights;
+
+  switch (w.precision) {
+  case Precision::Float16:
+    kernels.half(w.halves.data() + matrix.offset, matrix.rows, matrix.cols, x,
+                 xStride, y, yStride, n);
+    break;
+
+  case Precision::Int8:
+    kernels.int8(w.bytes.data() + matrix.offset,
+                 w.storage.data() + matrix.scales, matrix.rows, matrix.cols,
+                 x, xStride, y, yStride, n);
+    break;
+
+  case Precision::Float32:
+  default: {
+    using Stride = Eigen::OuterStride<>;
+    Eigen::Map<Matrix, 0, Stride>(y, matrix.rows, n, Stride(yStride))
+        .noalias() = w.map(matrix) * Eigen::Map<const Matrix, 0, Stride>(
+                                         x, matrix.cols, n, Stride(xStride));
+    break;
+  }
+  }
+}
+
+void SharedWaveNet::activate(Activation activation, float *data, int size) {
+  switch (activation) {
+  case Activation::Tanh:
+    waveshapers::process(waveshapers::Shape::RationalTanh, data, size);
+    break;
+  case Activation::Sigmoid:
+    for (int i = 0; i < size; ++i)
+      data[i] = 1.0f / (1.0f + std::exp(-data[i]));
+    break;
+  case Activation::ReLU:
+    for (int i = 0; i < size; ++i)
+      data[i] = std::max(data[i], 0.0f);
+    break;
+  case Activation::Hardtanh:
+    for (int i = 0; i < size; ++i)
+      data[i] = std::clamp(data[i], -1.0f, 1.0f);
+    break;
+  }
+}
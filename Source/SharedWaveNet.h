@@ -0,0 +1,271 @@
+#pragma once
+#include "../Modules/NeuralAmpModelerCore/NAM/dsp.h"
+#include "WeightKernels.h"
+#include "WeightQuantizer.h"
+#include <Eigen/Dense>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * Shared WaveNet
+ * NAM's WaveNet forward pass, reimplemented so that the weights are shared
+ * between instances instead of copied into each one.
+ *
+ * Weights holds every matrix of a model in one immutable buffer. The
+ * ModelRegistry parses a file into Weights once; every model built from
+ * it, in any plugin instance, maps Eigen over that buffer. Per instance
+ * there is only the dilated convolutions' history and a few tiles of
+ * scratch, all sized when the model is built.
+ *
+ * Each layer runs as one matrix product per tile: the kernel taps and the
+ * conditioning input are stacked into one operand, so the dilated
+ * convolution and the input mixin are a single GEMM. Blocks longer than
+ * tileSize run as several tiles, which keeps Eigen's blocking buffers on
+ * the stack: process() never allocates.
+ *
+ * Instances of one model can also run as a Batch: each block is held back
+ * until the next one arrives, and whichever instance gets there first runs
+ * every instance's held block in one pass. The columns of a tile are then
+ * several instances' samples side by side, each reading its own history,
+ * so each layer is still one matrix product, over all of them.
+ *
+ * Weights can also be stored in float16, or in int8 with a scale per
+ * output channel: a half or a quarter of the memory every instance
+ * streams through. The matrices are then multiplied by WeightKernels,
+ * which widen the weights in registers as they go; biases stay float.
+ *
+ * The output matches NAM's WaveNet, with its Tanh and Fasttanh computed by
+ * the rational tanh the plugin installs over NAM's (see Waveshapers).
+ * Configurations it does not cover (a post-stack head, other activations)
+ * throw from Weights::parse, and the registry falls back to nam::get_dsp.
+ */
+class SharedWaveNet : public nam::DSP {
+public:
+  using Matrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>;
+  using MatrixMap = Eigen::Map<Matrix>;
+  using ConstMatrixMap = Eigen::Map<const Matrix>;
+  using ConstVectorMap = Eigen::Map<const Eigen::VectorXf>;
+
+  enum class Activation { Tanh, Sigmoid, ReLU, Hardtanh };
+
+  /**
+   * Immutable weights of one model, shared by every instance built from
+   * it. Matrices are column-major blocks of one float buffer.
+   */
+  struct Weights {
+    // A matrix or bias vector. Float32 matrices and every bias are in
+    // storage; reduced matrices are in halves or bytes, laid out as
+    // WeightKernels reads them, with int8 row scales in storage from
+    // `scales` on.
+    struct Block {
+      size_t offset{0};
+      int rows{0};
+      int cols{0};
+      size_t scales{0};
+    };
+
+    struct Layer {
+      int dilation{1};
+      Block convMix;   // gated channels x (kernel taps x channels + cond.)
+      Block convBias;  // gated channels
+      Block mixer;     // 1x1: channels x channels
+      Block mixerBias; // channels
+    };
+
+    struct LayerArray {
+      int inputSize{1};
+      int conditionSize{1};
+      int headSize{1};
+      int channels{1};
+      int kernelSize{1};
+      bool gated{false};
+      Activation activation{Activation::Tanh};
+
+      Block rechannel;     // channels x input
+      Block headRechannel; // head x channels
+      Block headBias;      // head, or empty
+      std::vector<Layer> layers;
+    };
+
+    std::vector<LayerArray> arrays;
+    float headScale{1.0f};
+
+    double expectedSampleRate{-1.0};
+    bool hasLoudness{false};
+    double loudness{0.0};
+
+    // Samples of history the output depends on
+    int receptiveField{1};
+
+    WeightQuantizer::Precision precision{WeightQuantizer::Precision::Float32};
+    std::vector<float> storage;
+    std::vector<uint16_t> halves;
+    std::vector<int8_t> bytes;
+
+    // Memory the weights take, shared by every instance
+    size_t getSizeInBytes() const {
+      return storage.size() * sizeof(float) +
+             halves.size() * sizeof(uint16_t) + bytes.size();
+    }
+
+    ConstMatrixMap map(const Block &block) const {
+      return ConstMatrixMap(storage.data() + block.offset, block.rows,
+                            block.cols);
+    }
+    ConstVectorMap mapVector(const Block &block) const {
+      return ConstVectorMap(storage.data() + block.offset, block.rows);
+    }
+
+    /**
+     * Reads a WaveNet's config and weights in NAM's order, and stores the
+     * matrices at `precision`. Throws std::runtime_error for a malformed
+     * model or one this class does not implement.
+     */
+    static std::shared_ptr<const Weights>
+    parse(const nam::dspData &config,
+          WeightQuantizer::Precision precision =
+              WeightQuantizer::Precision::Float32);
+
+  private:
+    // Moves the matrices from float storage to `newPrecision`
+    void reduce(WeightQuantizer::Precision newPrecision);
+  };
+
+  /**
+   * The instances of one model that run their blocks together, one block
+   * late. Shared by every instance built from the same Weights (the
+   * ModelRegistry keeps one per entry with the BATCHED_AMPS build option).
+   *
+   * Each member holds a slot. A block arrives, and the member's previous
+   * block is collected: if no other member has run it yet, this member
+   * runs it along with every block still waiting in the batch. The new
+   * block then waits in the slot. Members whose blocks arrive at different
+   * times never wait for each other. A pass holds other members' blocks
+   * one tile at a time, so a member whose block is in one waits out at
+   * most that tile, then runs the rest of its block itself, alone. Slots
+   * change hands with compare-exchanges, so process() takes no lock and
+   * never allocates.
+   *
+   * Only the audio thread's process() runs passes: prewarm() and the
+   * warm-up in ResamplingNAM::Reset() never run other members' blocks.
+   */
+  class Batch {
+  public:
+    Batch() {}
+
+    static constexpr int maxMembers = 64;
+
+  private:
+    friend class SharedWaveNet;
+
+    enum State { Free, Changing, Idle, Waiting, Running };
+
+    struct Slot {
+      std::atomic<int> state{Free};
+      SharedWaveNet *member{nullptr};
+    };
+    std::array<Slot, maxMembers> slots;
+
+    Batch(const Batch &) = delete;
+    Batch &operator=(const Batch &) = delete;
+  };
+
+  // Columns per matrix product
+  static constexpr int tileSize = 256;
+
+  // History buffers rewind after this many samples
+  static constexpr int rewindSpan = 1024;
+
+  explicit SharedWaveNet(std::shared_ptr<const Weights> sharedWeights,
+                         std::shared_ptr<Batch> sharedBatch = nullptr);
+  ~SharedWaveNet() override;
+
+  void prewarm() override;
+  void process(NAM_SAMPLE *input, NAM_SAMPLE *output,
+               const int num_frames) override;
+
+  /**
+   * Largest block process() will be given. With a batch, this joins it:
+   * the output is delayed by that many samples from then on. Message
+   * thread, while the model is not processing.
+   */
+  void setMaxBlockSize(int maxFrames);
+
+  // Samples the output is delayed by: the block a batch holds back
+  int getLatency() const { return batchDelay; }
+
+  const Weights &getWeights() const { return *weights; }
+
+private:
+  // One instance's share of a tile: its history, and n samples in and out
+  struct Lane {
+    SharedWaveNet *net;
+    const float *input;
+    float *output;
+    int n;
+  };
+
+  // Runs the lanes side by side as one tile of at most tileSize columns
+  void processLanes(const Lane *lanes, int numLanes);
+
+  // Runs a block on this instance's own, in tiles
+  void processAlone(const float *input, float *output, int numFrames);
+
+  // One block of at most batchDelay samples through the batch
+  void processBatched(const float *input, float *output, int numFrames);
+
+  // Makes sure this instance's waiting block has run, running it with
+  // every other waiting block if no member has yet
+  void collect();
+  void runBatch();
+
+  // The same, never running the batch: what is left of the waiting block
+  // runs here alone, once any pass holding it lets go
+  void finishWaiting();
+
+  void join();
+  void leave();
+
+  // y = W x for n columns; x's and y's columns are xStride and yStride
+  // floats apart
+  void multiply(const Weights::Block &matrix, const float *x, int xStride,
+                float *y, int yStride, int n) const;
+
+  static void activate(Activation activation, float *data, int size);
+
+  std::shared_ptr<const Weights> weights;
+  const weightkernels::Kernels &kernels;
+
+  // One history buffer per layer: the layer's input, channels x (history +
+  // rewindSpan), written at position and rewound when full
+  struct LayerState {
+    Matrix buffer;
+    int history{0};
+    int position{0};
+  };
+  std::vector<std::vector<LayerState>> layerStates;
+
+  // Scratch, mapped to each layer's shape per tile
+  std::vector<float> tileInput;
+  std::vector<float> stacked;
+  std::vector<float> activations;
+  std::vector<float> mixed;
+  std::vector<float> arrayOutputs[2];
+  std::vector<float> heads[2];
+
+  // Batched: the slot this instance holds (or -1, run alone), the block
+  // waiting in it and what the batch made of it, and the delay line that
+  // gives every sample back batchDelay samples later
+  std::shared_ptr<Batch> batch;
+  int slotIndex{-1};
+  int batchDelay{0};
+  std::vector<float> waitingInput;
+  std::vector<float> waitingOutput;
+  int waitingCount{0};
+  int waitingDone{0}; // samples of it run so far
+  std::vector<float> delayLine;
+  int delayRead{0};
+  int delayWrite{0};
+};
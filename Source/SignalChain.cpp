@@ -0,0 +1,700 @@
+#include "SignalChain.h"
+
+void SignalChain::hook(juce::AudioProcessorValueTreeState &apvts,
+                       ParameterSnapshot &bulkOwner,
+                       StageProfiler &stageProfiler) {
+  paramSnapshot.hook(apvts);
+  paramSnapshot.shareBulkChanges(bulkOwner);
+
+  // The profiler has a single writer per stage: the second amp runs on a
+  // worker, so it reports under stages of its own
+  profiler = &stageProfiler;
+  myNAM.setProfiler(profiler);
+  secondAmp.setProfiler(profiler, true);
+  secondAmp.setToneParameters(ParameterIDs::Amp2Bass, ParameterIDs::Amp2Middle,
+                              ParameterIDs::Amp2Treble);
+
+  compilePlans();
+}
+
+void SignalChain::compilePlans() {
+  // Only the left channel feeds the amp, so the pedals before it run on
+  // that one channel
+  const int preAmpChannels = 1;
+
+  for (int order = 0; order < ExecutionPlan::numOrders; ++order)
+    for (int awake = 0; awake < ExecutionPlan::numAwakeSets; ++awake) {
+      auto &compiled =
+          plans[(size_t)ExecutionPlan::getPlanIndex(order, awake)];
+      compiled.clear();
+
+      for (auto pedal : ExecutionPlan::getOrder(order)) {
+        if ((awake & (1 << pedal)) == 0)
+          continue;
+
+        switch (pedal) {
+        case ExecutionPlan::Compressor:
+          compiled.add(&SignalChain::runCompressor, preAmpChannels);
+          break;
+        case ExecutionPlan::Boost:
+          compiled.add(&SignalChain::runBoost, preAmpChannels);
+          break;
+        case ExecutionPlan::TubeScreamer:
+          compiled.add(&SignalChain::runTubeScreamer, preAmpChannels);
+          break;
+        case ExecutionPlan::Klon:
+          compiled.add(&SignalChain::runKlon, preAmpChannels);
+          break;
+        default:
+          break;
+        }
+      }
+    }
+}
+
+void SignalChain::prepare(const juce::dsp::ProcessSpec &spec) {
+  for (auto &bank : banks) {
+    bank.compressor.prepare(spec);
+
+    bank.boost.prepare(spec);
+
+    bank.ts.prepare(spec);
+    bank.klon.prepare(spec);
+  }
+
+  incomingPedalBuffer.setSize(1, (int)spec.maximumBlockSize);
+  orderWarmSamples = juce::jmax(1, (int)(orderWarmSeconds * spec.sampleRate));
+  orderFadeSamples = juce::jmax(1, (int)(orderFadeSeconds * spec.sampleRate));
+
+  auto namSpec = spec;
+  myNAM.prepare(namSpec);
+
+  auto secondAmpSpec = spec;
+  secondAmp.prepare(secondAmpSpec);
+  secondAmpBuffer.setSize(2, (int)spec.maximumBlockSize);
+  lastBlend = paramSnapshot.getLive(ParameterSnapshot::AmpBlend);
+  for (auto &ring : alignRings)
+    ring.fill(0.0f);
+  alignDelay = 0;
+
+  doubler.prepare(spec);
+
+  chorusProcessor.prepare(spec);
+
+  reverbProcessor.prepare(spec);
+
+  delayProcessor.prepare(spec);
+
+  prepareBypasses(spec);
+
+  // Re-push every parameter into the freshly prepared stages
+  paramSnapshot.prepare(spec.sampleRate);
+  paramSnapshot.markAllDirty();
+
+  // Pedals start on the current order, with no switch under way
+  liveBank = 0;
+  requestedOrder = banks[0].order = banks[1].order = getCurrentOrder();
+  for (auto &bank : banks) {
+    bank.ts.setOversampling(requestedOversampling);
+    bank.klon.setOversampling(requestedOversampling);
+    bank.oversampled = requestedOversampling;
+  }
+  orderSwitch = OrderSwitch::Idle;
+
+  // Hold times cover each stage's own ring-out
+  pedalSilence.prepare(spec.sampleRate, 50.0);
+  modulationSilence.prepare(spec.sampleRate, 100.0);
+  delaySilence.prepare(spec.sampleRate, 1100.0);
+  reverbSilence.prepare(spec.sampleRate, 100.0);
+}
+
+void SignalChain::setOversamplingOrder(int order) {
+  for (auto &bank : banks) {
+    bank.ts.setOversamplingOrder(order);
+    bank.klon.setOversamplingOrder(order);
+  }
+}
+
+void SignalChain::setAntiAliasing(bool shouldAntiAlias) {
+  for (auto &bank : banks)
+    bank.boost.setAntiAliasing(shouldAntiAlias);
+}
+
+bool SignalChain::loadModel(const std::string &modelPath) {
+  return myNAM.loadModel(modelPath);
+}
+
+bool SignalChain::loadSecondModel(const std::string &modelPath) {
+  return secondAmp.loadModel(modelPath);
+}
+
+void SignalChain::clearSecondModel() { secondAmp.clearModel(); }
+
+void SignalChain::prepareBypasses(const juce::dsp::ProcessSpec &spec) {
+  using TailMode = PedalBypass::TailMode;
+  using P = ParameterSnapshot;
+
+  auto isOn = [this](P::ID id) { return paramSnapshot.getLive(id) > 0.5f; };
+
+  for (auto &bank : banks) {
+    bank.compBypass.prepare(spec, isOn(P::CompEnabled));
+    bank.boostBypass.prepare(spec, isOn(P::BoostEnabled));
+    bank.tsBypass.prepare(spec, isOn(P::TsEnabled));
+    bank.klonBypass.prepare(spec, isOn(P::KlonEnabled));
+
+    // Stages resume from clean state when switched back on
+    auto *b = &bank;
+    bank.compBypass.onSleep = [b] { b->compressor.reset(); };
+    bank.boostBypass.onSleep = [b] { b->boost.reset(); };
+    bank.tsBypass.onSleep = [b] { b->ts.reset(); };
+    bank.klonBypass.onSleep = [b] { b->klon.reset(); };
+  }
+
+  doublerBypass.prepare(spec, paramSnapshot.getLive(P::DoublerSpread) > 0.0f);
+  chorusBypass.prepare(spec, isOn(P::ChorusEnabled));
+
+  // Delay and reverb ring out when switched off instead of being cut
+  delayBypass.prepare(spec, isOn(P::DelayEnabled), TailMode::Spill);
+  reverbBypass.prepare(spec, isOn(P::ReverbEnabled), TailMode::Spill);
+
+  // Must outlast the longest gap between two repeats
+  delayBypass.setTailHoldMs(1100.0);
+  reverbBypass.setTailHoldMs(200.0);
+
+  // As for the pedals above
+  doublerBypass.onSleep = [this] { doubler.reset(); };
+  chorusBypass.onSleep = [this] { chorusProcessor.reset(); };
+  delayBypass.onSleep = [this] { delayProcessor.reset(); };
+  reverbBypass.onSleep = [this] { reverbProcessor.reset(); };
+}
+
+void SignalChain::restart() {
+  using P = ParameterSnapshot;
+  auto isOn = [this](P::ID id) { return paramSnapshot.getLive(id) > 0.5f; };
+
+  liveBank = 0;
+  requestedOrder = getCurrentOrder();
+  orderSwitch = OrderSwitch::Idle;
+  for (auto &bank : banks)
+    restartBank(bank);
+
+  myNAM.reset();
+  secondAmp.reset();
+  lastBlend = paramSnapshot.getLive(P::AmpBlend);
+  for (auto &ring : alignRings)
+    ring.fill(0.0f);
+  alignDelay = 0;
+  doubler.reset();
+  chorusProcessor.reset();
+  delayProcessor.reset();
+  reverbProcessor.reset();
+
+  doublerBypass.reset(paramSnapshot.getLive(P::DoublerSpread) > 0.0f);
+  chorusBypass.reset(isOn(P::ChorusEnabled));
+  delayBypass.reset(isOn(P::DelayEnabled));
+  reverbBypass.reset(isOn(P::ReverbEnabled));
+
+  pedalSilence.reset();
+  modulationSilence.reset();
+  delaySilence.reset();
+  reverbSilence.reset();
+
+  paramSnapshot.markAllDirty();
+  held = false;
+}
+
+void SignalChain::restartBank(PedalBank &bank) {
+  using P = ParameterSnapshot;
+  auto isOn = [this](P::ID id) { return paramSnapshot.getLive(id) > 0.5f; };
+
+  bank.ts.setOversampling(requestedOversampling);
+  bank.klon.setOversampling(requestedOversampling);
+
+  bank.compressor.reset();
+  bank.boost.reset();
+  bank.ts.reset();
+  bank.klon.reset();
+
+  bank.compBypass.reset(isOn(P::CompEnabled));
+  bank.boostBypass.reset(isOn(P::BoostEnabled));
+  bank.tsBypass.reset(isOn(P::TsEnabled));
+  bank.klonBypass.reset(isOn(P::KlonEnabled));
+
+  bank.order = requestedOrder;
+  bank.oversampled = requestedOversampling;
+}
+
+bool SignalChain::isRequested(const PedalBank &bank) const {
+  return bank.order == requestedOrder &&
+         bank.oversampled == requestedOversampling;
+}
+
+int SignalChain::getCurrentOrder() const {
+  const auto order = paramSnapshot.getLive(ParameterSnapshot::PedalOrder);
+  return juce::jlimit(0, ExecutionPlan::numOrders - 1, (int)order);
+}
+
+void SignalChain::setQualityTier(int tier) {
+  using Q = QualityGovernor;
+
+  // processPedals() crossfades to banks on the new oversampling
+  requestedOversampling = tier < Q::NoOversampling;
+  myNAM.setFastResampling(tier >= Q::FastResampler);
+  secondAmp.setFastResampling(tier >= Q::FastResampler);
+  reverbProcessor.setReducedDensity(tier >= Q::ReducedReverb);
+}
+
+void SignalChain::dispatchParameters() {
+  using P = ParameterSnapshot;
+  const auto &p = paramSnapshot;
+
+  // processPedals() crossfades to the new order
+  if (p.changed(P::routingMask))
+    requestedOrder =
+        juce::jlimit(0, ExecutionPlan::numOrders - 1, (int)p[P::PedalOrder]);
+
+  // Only stages whose inputs changed get their setters called. Both banks
+  // follow the knobs, so either can take over at any time.
+  for (auto &bank : banks) {
+    if (p.changed(P::compMask)) {
+      bank.compressor.setVolume(p[P::CompVolume]);
+      bank.compressor.setAttack(p[P::CompAttack]);
+      bank.compressor.setSustain(p[P::CompSustain]);
+    }
+
+    if (p.changed(P::boostMask))
+      bank.boost.setBoost(p[P::BoostVolume]);
+
+    if (p.changed(P::tsMask)) {
+      bank.ts.setDrive(p[P::TsDrive]);
+      bank.ts.setTone(p[P::TsTone]);
+      bank.ts.setLevel(p[P::TsLevel]);
+    }
+
+    if (p.changed(P::klonMask)) {
+      bank.klon.setGain(p[P::KlonGain] / 10.0f);
+      bank.klon.setTreble(p[P::KlonTreble] / 10.0f);
+      bank.klon.setLevel(p[P::KlonLevel] / 10.0f);
+    }
+  }
+
+  myNAM.setParameters(p);
+  secondAmp.setParameters(p);
+
+  if (p.changed(P::doublerMask))
+    doubler.setDelayMs(p[P::DoublerSpread]);
+
+  if (p.changed(P::chorusMask)) {
+    chorusProcessor.setRate(p[P::ChorusRate]);
+    chorusProcessor.setDepth(p[P::ChorusDepth]);
+    chorusProcessor.setMix(p[P::ChorusMix]);
+  }
+
+  if (p.changed(P::delayMask)) {
+    delayProcessor.setTime(p[P::DelayTime]);
+    delayProcessor.setFeedback(p[P::DelayFeedback]);
+    delayProcessor.setMix(p[P::DelayMix]);
+  }
+
+  if (p.changed(P::reverbMask)) {
+    reverbProcessor.setMix(p[P::ReverbMix]);
+    reverbProcessor.setTone(p[P::ReverbTone]);
+    reverbProcessor.setSize(p[P::ReverbSize]);
+  }
+}
+
+bool SignalChain::isAsleep() const {
+  return pedalSilence.isAsleep() && myNAM.isAsleep() &&
+         (!dualAmpActive || secondAmp.isAsleep()) &&
+         modulationSilence.isAsleep() && delaySilence.isAsleep() &&
+         reverbSilence.isAsleep();
+}
+
+double SignalChain::getTailLengthSeconds() const {
+  // Amp model history, then whatever the time-based effects add on top
+  double tail = NeuralAmpModeler::receptiveFieldSeconds;
+
+  using P = ParameterSnapshot;
+
+  if (paramSnapshot.getLive(P::DelayEnabled) > 0.5f)
+    tail += DelayProcessor::getTailLengthSeconds(
+        paramSnapshot.getLive(P::DelayTime),
+        paramSnapshot.getLive(P::DelayFeedback));
+
+  if (paramSnapshot.getLive(P::ReverbEnabled) > 0.5f)
+    tail += ReverbProcessor::getTailLengthSeconds(
+        paramSnapshot.getLive(P::ReverbSize));
+
+  return tail;
+}
+
+bool SignalChain::getTriggerStatus() {
+  auto t_state = myNAM.getTrigger();
+  return t_state->isGating();
+}
+
+float SignalChain::getGateReductionDb() {
+  return (float)myNAM.getTrigger()->GetLastGainReductionDB();
+}
+
+void SignalChain::process(juce::AudioBuffer<float> &buffer,
+                          MeterFrame *meterFrame) {
+  using P = ParameterSnapshot;
+  const int numSamples = buffer.getNumSamples();
+  meters = meterFrame;
+
+  // One snapshot per block; setters only run for what changed
+  if (!held)
+    paramSnapshot.update(numSamples);
+  dispatchParameters();
+  paramSnapshot.clearChanged();
+
+  if (!paramSnapshot.isRamping()) {
+    processStages(buffer);
+    return;
+  }
+
+  // A knob is moving: run the chain in short sub-blocks so the ramped
+  // values reach the stages at block rate, ending exactly on the host's
+  // value at the end of the block
+  for (int start = 0; start < numSamples; start += P::subBlockSize) {
+    const int length = juce::jmin(P::subBlockSize, numSamples - start);
+
+    paramSnapshot.advance(length);
+    dispatchParameters();
+    paramSnapshot.clearChanged();
+
+    juce::AudioBuffer<float> subBuffer(buffer.getArrayOfWritePointers(),
+                                       buffer.getNumChannels(), start, length);
+    processStages(subBuffer);
+  }
+}
+
+void SignalChain::processStages(juce::AudioBuffer<float> &buffer) {
+  using P = ParameterSnapshot;
+  const int numSamples = buffer.getNumSamples();
+
+  auto *channelDataLeft = buffer.getWritePointer(0);
+  auto *channelDataRight = buffer.getWritePointer(1);
+
+  const bool inputSilent = SilenceDetector::isSilent(buffer);
+
+  // Pre-amp pedals, skipped as a group while idle. While they are silent
+  // an order or oversampling change needs no crossfade.
+  if (pedalSilence.isAsleep() && !isRequested(banks[liveBank])) {
+    restartBank(banks[liveBank]);
+    orderSwitch = OrderSwitch::Idle;
+  }
+
+  if (!pedalSilence.canSkip(inputSilent)) {
+    processPedals(buffer);
+
+    pedalSilence.update(inputSilent, SilenceDetector::isSilent(buffer),
+                        numSamples);
+  }
+
+  processAmps(buffer);
+
+  // Do Dual Mono
+  for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    channelDataRight[sample] = channelDataLeft[sample];
+
+  measure(MeterFrame::Amp, buffer);
+
+  // Doubler and Chorus, skipped as a group while idle
+  const bool modulationInputSilent = SilenceDetector::isSilent(buffer);
+  if (!modulationSilence.canSkip(modulationInputSilent)) {
+    // Doubler
+    if (auto *target = doublerBypass.processBlockIn(
+            buffer, paramSnapshot[P::DoublerSpread] > 0.0f)) {
+      StageProfiler::Scope scope(profiler, StageProfiler::Doubler);
+      doubler.process(*target);
+      doublerBypass.processBlockOut(buffer);
+      measure(MeterFrame::Doubler, buffer);
+    }
+
+    // Chorus
+    if (auto *target = chorusBypass.processBlockIn(
+            buffer, paramSnapshot.isOn(P::ChorusEnabled))) {
+      StageProfiler::Scope scope(profiler, StageProfiler::Chorus);
+      chorusProcessor.process(*target);
+      chorusBypass.processBlockOut(buffer);
+      measure(MeterFrame::Chorus, buffer);
+    }
+
+    if (modulationSilence.update(modulationInputSilent,
+                                 SilenceDetector::isSilent(buffer),
+                                 numSamples)) {
+      doubler.reset();
+      chorusProcessor.reset();
+    }
+  }
+
+  // Delay sleeps once its input is silent and the repeats have died away
+  const bool delayInputSilent = SilenceDetector::isSilent(buffer);
+  if (!delaySilence.canSkip(delayInputSilent)) {
+    // Delay (keeps ringing out after being switched off)
+    if (auto *target = delayBypass.processBlockIn(
+            buffer, paramSnapshot.isOn(P::DelayEnabled))) {
+      StageProfiler::Scope scope(profiler, StageProfiler::Delay);
+      delayProcessor.process(*target);
+      delayBypass.processBlockOut(buffer);
+      measure(MeterFrame::Delay, buffer);
+    }
+
+    if (delaySilence.update(delayInputSilent,
+                            SilenceDetector::isSilent(buffer), numSamples))
+      delayProcessor.reset();
+  }
+
+  // Reverb sleeps once its input is silent and the tank has decayed
+  const bool reverbInputSilent = SilenceDetector::isSilent(buffer);
+  if (!reverbSilence.canSkip(reverbInputSilent)) {
+    // Reverb (at end of chain, post-effects; keeps ringing out when off)
+    if (auto *target = reverbBypass.processBlockIn(
+            buffer, paramSnapshot.isOn(P::ReverbEnabled))) {
+      StageProfiler::Scope scope(profiler, StageProfiler::Reverb);
+      reverbProcessor.process(*target);
+      reverbBypass.processBlockOut(buffer);
+      measure(MeterFrame::Reverb, buffer);
+    }
+
+    if (reverbSilence.update(reverbInputSilent,
+                             SilenceDetector::isSilent(buffer), numSamples))
+      reverbProcessor.reset();
+  }
+}
+
+const ExecutionPlan &SignalChain::getPlan(const PedalBank &bank) const {
+  using P = ParameterSnapshot;
+  const auto &p = paramSnapshot;
+
+  // On, or still fading out
+  int awake = 0;
+  if (p.isOn(P::CompEnabled) || !bank.compBypass.isAsleep())
+    awake |= 1 << ExecutionPlan::Compressor;
+  if (p.isOn(P::BoostEnabled) || !bank.boostBypass.isAsleep())
+    awake |= 1 << ExecutionPlan::Boost;
+  if (p.isOn(P::TsEnabled) || !bank.tsBypass.isAsleep())
+    awake |= 1 << ExecutionPlan::TubeScreamer;
+  if (p.isOn(P::KlonEnabled) || !bank.klonBypass.isAsleep())
+    awake |= 1 << ExecutionPlan::Klon;
+
+  return plans[(size_t)ExecutionPlan::getPlanIndex(bank.order, awake)];
+}
+
+void SignalChain::runPlan(PedalBank &bank, juce::AudioBuffer<float> &buffer) {
+  for (const auto &step : getPlan(bank)) {
+    juce::AudioBuffer<float> channels(buffer.getArrayOfWritePointers(),
+                                      step.numChannels,
+                                      buffer.getNumSamples());
+    step.run(*this, bank, channels);
+  }
+}
+
+void SignalChain::processPedals(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  auto &live = banks[(size_t)liveBank];
+  auto &incoming = banks[(size_t)(1 - liveBank)];
+
+  // A new order or oversampling: the idle bank starts on it from clean
+  // state. A change mid-warm starts over; one mid-fade waits for the fade.
+  if (orderSwitch != OrderSwitch::Crossfading) {
+    if (isRequested(live)) {
+      orderSwitch = OrderSwitch::Idle;
+    } else if (orderSwitch == OrderSwitch::Idle || !isRequested(incoming)) {
+      restartBank(incoming);
+      orderSwitch = OrderSwitch::Warming;
+      orderSwitchSamplesLeft = orderWarmSamples;
+    }
+  }
+
+  if (orderSwitch == OrderSwitch::Idle) {
+    runPlan(live, buffer);
+    return;
+  }
+
+  // Both banks on the same input; the meters follow the live one
+  juce::AudioBuffer<float> incomingBuffer(
+      incomingPedalBuffer.getArrayOfWritePointers(), 1, numSamples);
+  incomingBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
+
+  runPlan(live, buffer);
+
+  auto *frame = meters;
+  meters = nullptr;
+  runPlan(incoming, incomingBuffer);
+  meters = frame;
+
+  if (orderSwitch == OrderSwitch::Warming) {
+    orderSwitchSamplesLeft -= numSamples;
+    if (orderSwitchSamplesLeft <= 0) {
+      orderSwitch = OrderSwitch::Crossfading;
+      orderSwitchSamplesLeft = orderFadeSamples;
+    }
+    return;
+  }
+
+  // Linear crossfade on the one pre-amp channel
+  const int fadeLength = juce::jmin(numSamples, orderSwitchSamplesLeft);
+  const float startGain =
+      1.0f - (float)orderSwitchSamplesLeft / (float)orderFadeSamples;
+  const float endGain =
+      1.0f - (float)(orderSwitchSamplesLeft - fadeLength) /
+                 (float)orderFadeSamples;
+
+  buffer.applyGainRamp(0, 0, fadeLength, 1.0f - startGain, 1.0f - endGain);
+  buffer.addFromWithRamp(0, 0, incomingBuffer.getReadPointer(0), fadeLength,
+                         startGain, endGain);
+  if (fadeLength < numSamples)
+    buffer.copyFrom(0, fadeLength, incomingBuffer, 0, fadeLength,
+                    numSamples - fadeLength);
+
+  orderSwitchSamplesLeft -= fadeLength;
+  if (orderSwitchSamplesLeft == 0) {
+    liveBank = 1 - liveBank;
+    orderSwitch = OrderSwitch::Idle;
+  }
+}
+
+void SignalChain::runCompressor(SignalChain &chain, PedalBank &bank,
+                                juce::AudioBuffer<float> &buffer) {
+  using P = ParameterSnapshot;
+  if (auto *target = bank.compBypass.processBlockIn(
+          buffer, chain.paramSnapshot.isOn(P::CompEnabled))) {
+    StageProfiler::Scope scope(chain.profiler, StageProfiler::Compressor);
+    bank.compressor.process(*target);
+    bank.compBypass.processBlockOut(buffer);
+    chain.measure(MeterFrame::Compressor, buffer);
+  }
+}
+
+void SignalChain::runBoost(SignalChain &chain, PedalBank &bank,
+                           juce::AudioBuffer<float> &buffer) {
+  using P = ParameterSnapshot;
+  if (auto *target = bank.boostBypass.processBlockIn(
+          buffer, chain.paramSnapshot.isOn(P::BoostEnabled))) {
+    StageProfiler::Scope scope(chain.profiler, StageProfiler::Boost);
+    bank.boost.process(*target);
+    bank.boostBypass.processBlockOut(buffer);
+    chain.measure(MeterFrame::Boost, buffer);
+  }
+}
+
+void SignalChain::runTubeScreamer(SignalChain &chain, PedalBank &bank,
+                                  juce::AudioBuffer<float> &buffer) {
+  using P = ParameterSnapshot;
+  if (auto *target = bank.tsBypass.processBlockIn(
+          buffer, chain.paramSnapshot.isOn(P::TsEnabled))) {
+    StageProfiler::Scope scope(chain.profiler, StageProfiler::TubeScreamer);
+    bank.ts.process(*target);
+    bank.tsBypass.processBlockOut(buffer);
+    chain.measure(MeterFrame::TubeScreamer, buffer);
+  }
+}
+
+void SignalChain::runKlon(SignalChain &chain, PedalBank &bank,
+                          juce::AudioBuffer<float> &buffer) {
+  using P = ParameterSnapshot;
+  if (auto *target = bank.klonBypass.processBlockIn(
+          buffer, chain.paramSnapshot.isOn(P::KlonEnabled))) {
+    StageProfiler::Scope scope(chain.profiler, StageProfiler::Klon);
+    bank.klon.process(*target);
+    bank.klonBypass.processBlockOut(buffer);
+    chain.measure(MeterFrame::Klon, buffer);
+  }
+}
+
+void SignalChain::processAmps(juce::AudioBuffer<float> &buffer) {
+  using P = ParameterSnapshot;
+  const int numSamples = buffer.getNumSamples();
+  const float blend = paramSnapshot[P::AmpBlend];
+
+  // The second amp runs while it has a model and is, or was until this
+  // block, part of the blend
+  secondAmp.applyDSPStaging();
+  dualAmpActive =
+      secondAmp.hasModel() && (blend > 0.0f || lastBlend > 0.0f);
+
+  if (!dualAmpActive) {
+    myNAM.processBlock(buffer);
+    lastBlend = blend;
+    alignDelay = 0; // the ring restarts when the second amp comes back
+    return;
+  }
+
+  // Same pre-amp signal into both; the second amp runs on a worker while
+  // the first runs here, so the block costs about one amp of wall time
+  juce::AudioBuffer<float> second(secondAmpBuffer.getArrayOfWritePointers(),
+                                  secondAmpBuffer.getNumChannels(),
+                                  numSamples);
+  second.copyFrom(0, 0, buffer, 0, 0, numSamples);
+  secondAmpTarget = &second;
+
+  // Until the processor has made a pool, the second amp runs here too
+  if (auto *pool = workers.load(std::memory_order_acquire)) {
+    pool->run(&SignalChain::runSecondAmp, this);
+    myNAM.processBlock(buffer);
+    pool->wait();
+  } else {
+    runSecondAmp(this);
+    myNAM.processBlock(buffer);
+  }
+
+  secondAmpTarget = nullptr;
+
+  alignAmps(buffer, second);
+
+  // Linear blend, ramped from the previous block's position
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), second.getNumChannels());
+  for (int ch = 0; ch < numChannels; ++ch) {
+    buffer.applyGainRamp(ch, 0, numSamples, 1.0f - lastBlend, 1.0f - blend);
+    buffer.addFromWithRamp(ch, 0, second.getReadPointer(ch), numSamples,
+                           lastBlend, blend);
+  }
+
+  lastBlend = blend;
+}
+
+void SignalChain::runSecondAmp(void *chain) {
+  auto &self = *static_cast<SignalChain *>(chain);
+  self.secondAmp.processBlock(*self.secondAmpTarget);
+}
+
+void SignalChain::alignAmps(juce::AudioBuffer<float> &first,
+                            juce::AudioBuffer<float> &second) {
+  // Either amp's resampler latency changes with its model and the quality
+  // tier; the ring restarts empty on the new difference
+  const int delay = juce::jlimit(
+      -(alignRingSize - 1), alignRingSize - 1,
+      secondAmp.getLatencySamples() - myNAM.getLatencySamples());
+  if (delay != alignDelay) {
+    for (auto &ring : alignRings)
+      ring.fill(0.0f);
+    alignDelay = delay;
+  }
+
+  if (delay == 0)
+    return;
+
+  // The lower-latency output is the one ahead. Each channel has its own
+  // ring, as the amps' outputs need not be the same on both.
+  auto &ahead = delay > 0 ? first : second;
+  const int shift = std::abs(delay);
+  const int mask = alignRingSize - 1;
+  const int numChannels = juce::jmin(ahead.getNumChannels(), alignChannels);
+
+  int position = alignPosition;
+  for (int ch = 0; ch < numChannels; ++ch) {
+    auto &ring = alignRings[(size_t)ch];
+    auto *data = ahead.getWritePointer(ch);
+    position = alignPosition;
+    for (int i = 0; i < ahead.getNumSamples(); ++i) {
+      ring[(size_t)position] = data[i];
+      data[i] = ring[(size_t)((position - shift) & mask)];
+      position = (position + 1) & mask;
+    }
+  }
+  alignPosition = position;
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+// clang-format off
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "NeuralAmpModeler.h"
+#include "DoublerProcessor.h"
+#include "pedals/TubeScreamer/TSProcessor.h"
+#include "pedals/KlonCentaur/KlonProcessor.h"
+#include "pedals/Compressor/CompressorProcessor.h"
+#include "pedals/CleanBoost/CleanBoostProcessor.h"
+#include "pedals/Chorus/ChorusProcessor.h"
+#include "pedals/Reverb/ReverbProcessor.h"
+#include "pedals/Delay/DelayProcessor.h"
+#include "PedalBypass.h"
+#include "SilenceDetector.h"
+#include "ParameterSnapshot.h"
+#include "Metering.h"
+#include "StageProfiler.h"
+#include "ExecutionPlan.h"
+#include "RealtimeWorkerPool.h"
+#include "QualityGovernor.h"
+// clang-format on
+
+/**
+ * Pedal Bank
+ * One set of the pre-amp pedals with their bypasses, the order the set
+ * runs in, and whether its TS and Klon oversample.
+ */
+struct PedalBank {
+  CompressorProcessor compressor;
+  CleanBoostProcessor boost;
+  TSProcessor ts;
+  KlonProcessor klon;
+
+  // Click-free switching; a bypassed pedal sleeps and leaves the plan
+  PedalBypass compBypass;
+  PedalBypass boostBypass;
+  PedalBypass tsBypass;
+  PedalBypass klonBypass;
+
+  int order{0};
+  bool oversampled{true};
+};
+
+/**
+ * Signal Chain
+ * Everything between the input pad and the plugin output gain: pedals, amp,
+ * doubler, chorus, delay and reverb, with their bypasses, idle detection
+ * and their own parameter snapshot.
+ *
+ * The processor keeps two chains so a preset switch can crossfade to an
+ * incoming one already running on live input (see NamJUCEAudioProcessor).
+ *
+ * The pre-amp pedals run from an ExecutionPlan in the order picked by the
+ * PEDAL_ORDER_ID parameter; the amp and everything after it are fixed.
+ * They live in a PedalBank, and the chain has two: an order change warms
+ * the idle bank up on the new order and crossfades to it inside the chain.
+ *
+ * Dual amp: with a second model loaded and AMP_BLEND_ID above zero, a
+ * second NeuralAmpModeler (own gate, and a tone stack on the AMP2_* knobs)
+ * runs on the same pre-amp signal on a worker thread while the first runs
+ * here. The amp whose resampler delays it less is delayed by the
+ * difference, and the two are blended before the doubler.
+ */
+class SignalChain {
+public:
+  SignalChain() {}
+  ~SignalChain() {}
+
+  // Call once, from the processor constructor
+  void hook(juce::AudioProcessorValueTreeState &apvts,
+            ParameterSnapshot &bulkOwner, StageProfiler &stageProfiler);
+
+  // The pool the second amp runs on; without one it runs on the caller.
+  // Message thread; the pool must outlive the chain.
+  void setWorkerPool(RealtimeWorkerPool *pool) {
+    workers.store(pool, std::memory_order_release);
+  }
+
+  void prepare(const juce::dsp::ProcessSpec &spec);
+
+  // TS and Klon oversampling as a power of two (1 = 2x); message thread,
+  // takes effect at the next prepare()
+  void setOversamplingOrder(int order);
+
+  // Anti-aliased clean boost clipper; message thread, before prepare()
+  void setAntiAliasing(bool shouldAntiAlias);
+
+  // Loads the amp model; message thread
+  bool loadModel(const std::string &modelPath);
+
+  // Loads or removes the dual-amp mode's second model; message thread
+  bool loadSecondModel(const std::string &modelPath);
+  void clearSecondModel();
+
+  // Samples the amp models add to the chain's latency themselves (see
+  // NeuralAmpModeler::getModelLatencySamples); the dual amps are aligned
+  // to the later one
+  int getModelLatencySamples() const {
+    return juce::jmax(myNAM.getModelLatencySamples(),
+                      secondAmp.getModelLatencySamples());
+  }
+
+  /**
+   * Clears every stage and snaps bypasses and parameters to the current
+   * values, as if the chain had been idle. Audio thread, no allocation.
+   */
+  void restart();
+
+  /**
+   * Runs the chain on a cued preset's values instead of the parameters, or
+   * on the parameters again with nullptr. Audio thread; follow it with
+   * restart() unless both hold the same values.
+   */
+  void followCue(ParameterSnapshot::Cue *cue) { paramSnapshot.follow(cue); }
+
+  /**
+   * Takes this block's parameter snapshot (unless held) and runs the chain.
+   * With a meter frame, each stage that runs adds its output level to it.
+   */
+  void process(juce::AudioBuffer<float> &buffer,
+               MeterFrame *meterFrame = nullptr);
+
+  /**
+   * A held chain stops following the parameters and keeps the values it
+   * has. Used for the outgoing chain while a preset switch crossfades.
+   */
+  void setHeld(bool shouldHold) { held = shouldHold; }
+
+  /**
+   * Runs the chain's stages at a QualityGovernor tier; tiers past
+   * ReducedReverb do not concern the chain. Audio thread, no allocation.
+   * Each stage changes over in place with a short crossfade of its own:
+   * the pedals as an order change does, the amp through a brief dip around
+   * the resampler swap, the reverb by running both modes for a moment.
+   */
+  void setQualityTier(int tier);
+
+  bool isAsleep() const;
+  double getTailLengthSeconds() const;
+  bool getTriggerStatus();
+  float getGateReductionDb();
+
+private:
+  void prepareBypasses(const juce::dsp::ProcessSpec &spec);
+  void dispatchParameters();
+  void processStages(juce::AudioBuffer<float> &buffer);
+
+  // One plan per pedal order and set of awake pedals; message thread
+  void compilePlans();
+
+  // Pre-amp pedals, crossfading between the banks while the order changes
+  void processPedals(juce::AudioBuffer<float> &buffer);
+
+  // A bank's plan for this block: its order, less the pedals asleep
+  const ExecutionPlan &getPlan(const PedalBank &bank) const;
+  void runPlan(PedalBank &bank, juce::AudioBuffer<float> &buffer);
+
+  // Clears a bank and puts it on the requested order and oversampling.
+  // Audio thread, no allocation.
+  void restartBank(PedalBank &bank);
+  bool isRequested(const PedalBank &bank) const;
+
+  // The PEDAL_ORDER_ID parameter's current value, in range
+  int getCurrentOrder() const;
+
+  // The amp, or both amps and their blend in dual-amp mode
+  void processAmps(juce::AudioBuffer<float> &buffer);
+
+  // Worker job: the second amp on secondAmpTarget
+  static void runSecondAmp(void *chain);
+
+  // Delays each channel of whichever amp output is ahead, so the blend
+  // adds the two in phase
+  void alignAmps(juce::AudioBuffer<float> &first,
+                 juce::AudioBuffer<float> &second);
+
+  // Plan steps, one per pre-amp pedal
+  static void runCompressor(SignalChain &chain, PedalBank &bank,
+                            juce::AudioBuffer<float> &buffer);
+  static void runBoost(SignalChain &chain, PedalBank &bank,
+                       juce::AudioBuffer<float> &buffer);
+  static void runTubeScreamer(SignalChain &chain, PedalBank &bank,
+                              juce::AudioBuffer<float> &buffer);
+  static void runKlon(SignalChain &chain, PedalBank &bank,
+                      juce::AudioBuffer<float> &buffer);
+
+  // Adds a stage's output to this block's meter frame, if there is one
+  void measure(MeterFrame::Tap tap, const juce::AudioBuffer<float> &buffer) {
+    if (meters != nullptr)
+      meters->measure(tap, buffer);
+  }
+
+  ParameterSnapshot paramSnapshot;
+  bool held{false};
+  MeterFrame *meters{nullptr};
+  StageProfiler *profiler{nullptr};
+
+  std::array<ExecutionPlan, ExecutionPlan::numPlans> plans;
+
+  // Pre-amp pedals. The live bank is heard; the other one only runs while
+  // an order or oversampling change warms it up and crossfades to it.
+  std::array<PedalBank, 2> banks;
+  int liveBank{0};
+  int requestedOrder{0};
+  bool requestedOversampling{true};
+
+  enum class OrderSwitch { Idle, Warming, Crossfading };
+  OrderSwitch orderSwitch{OrderSwitch::Idle};
+  int orderSwitchSamplesLeft{0};
+  int orderWarmSamples{1};
+  int orderFadeSamples{1};
+  juce::AudioBuffer<float> incomingPedalBuffer;
+
+  static constexpr double orderWarmSeconds = 0.01;
+  static constexpr double orderFadeSeconds = 0.02;
+
+  NeuralAmpModeler myNAM;
+
+  // Dual amp
+  NeuralAmpModeler secondAmp;
+  std::atomic<RealtimeWorkerPool *> workers{nullptr};
+  juce::AudioBuffer<float> secondAmpBuffer;
+  juce::AudioBuffer<float> *secondAmpTarget{nullptr};
+  bool dualAmpActive{false};
+  float lastBlend{0.0f};
+
+  // Latency alignment: second amp's latency minus the first's, and a ring
+  // to delay by it. Resampler latencies are a few dozen samples.
+  static constexpr int alignRingSize = 1024;
+  static constexpr int alignChannels = 2;
+  std::array<std::array<float, alignRingSize>, alignChannels> alignRings{};
+  int alignPosition{0};
+  int alignDelay{0};
+
+  Doubler doubler;
+  ChorusProcessor chorusProcessor;
+  ReverbProcessor reverbProcessor;
+  DelayProcessor delayProcessor;
+
+  // Click-free switching; a bypassed stage sleeps and is skipped entirely
+  PedalBypass doublerBypass;
+  PedalBypass chorusBypass;
+  PedalBypass delayBypass;
+  PedalBypass reverbBypass;
+
+  // Idle tracking per stage group; the amp keeps its own inside myNAM
+  SilenceDetector pedalSilence;
+  SilenceDetector modulationSilence;
+  SilenceDetector delaySilence;
+  SilenceDetector reverbSilence;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalChain)
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * Silence Detector
+ * Tracks how long one stage of the chain has seen silence so the stage can
+ * be put to sleep (skipped) while the session is idle.
+ *
+ * - A stage falls asleep once its input, and optionally its output (for
+ *   stages with a tail), has stayed below the threshold for the hold time.
+ * - Any signal at the input wakes the stage immediately, within the same
+ *   block.
+ *
+ * Usage:
+ *   const bool inputSilent = SilenceDetector::isSilent(buffer);
+ *   if (!detector.canSkip(inputSilent)) {
+ *     stage.process(buffer);
+ *     if (detector.update(inputSilent, SilenceDetector::isSilent(buffer),
+ *                         buffer.getNumSamples()))
+ *       stage.reset(); // just fell asleep
+ *   }
+ */
+class SilenceDetector {
+public:
+  SilenceDetector() {}
+  ~SilenceDetector() {}
+
+  // -120 dB: well below anything audible, above denormal residue
+  static constexpr float threshold = 1.0e-6f;
+
+  static bool isSilent(const juce::AudioBuffer<float> &buffer) {
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+      if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) >= threshold)
+        return false;
+    return true;
+  }
+
+  void prepare(double sampleRate, double holdMs) {
+    setHoldSamples((int)(sampleRate * holdMs / 1000.0));
+    reset();
+  }
+
+  void setHoldSamples(int numSamples) {
+    holdSamples = juce::jmax(0, numSamples);
+  }
+
+  void reset() {
+    silentSamples = 0;
+    asleep = false;
+  }
+
+  /**
+   * Call before the stage. Returns true while the stage is asleep and the
+   * input is still silent; a non-silent input wakes it.
+   */
+  bool canSkip(bool inputSilent) {
+    if (!inputSilent) {
+      silentSamples = 0;
+      asleep = false;
+    }
+    return asleep;
+  }
+
+  /**
+   * Call after the stage has run. Returns true on the block the stage falls
+   * asleep.
+   */
+  bool update(bool inputSilent, bool outputSilent, int numSamples) {
+    if (!(inputSilent && outputSilent)) {
+      silentSamples = 0;
+      return false;
+    }
+
+    silentSamples = juce::jmin(silentSamples + numSamples, holdSamples);
+    if (!asleep && silentSamples >= holdSamples) {
+      asleep = true;
+      return true;
+    }
+    return false;
+  }
+
+  bool isAsleep() const { return asleep; }
+
+private:
+  int holdSamples = 0;
+  int silentSamples = 0;
+  bool asleep = false;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SilenceDetector)
+};
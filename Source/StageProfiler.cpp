@@ -0,0 +1,184 @@
+#include "StageProfiler.h"
+
+void StageProfiler::reset() {
+  for (auto &counters : stages) {
+    counters.calls = 0;
+    counters.totalTicks = 0;
+    counters.maxTicks = 0;
+    for (auto &bucket : counters.histogram)
+      bucket = 0;
+  }
+
+  totalSamples = 0;
+  totalLoad = 0;
+  maxLoad = 0;
+  for (auto &bucket : loadHistogram)
+    bucket = 0;
+}
+
+void StageProfiler::record(Stage stage, juce::int64 ticks) {
+  auto &counters = stages[(size_t)stage];
+  const auto elapsed = (juce::uint64)juce::jmax((juce::int64)0, ticks);
+
+  add(counters.calls, 1);
+  add(counters.totalTicks, elapsed);
+
+  // Single writer: no compare-exchange needed
+  if (elapsed > counters.maxTicks.load(std::memory_order_relaxed))
+    counters.maxTicks.store(elapsed, std::memory_order_relaxed);
+
+  const auto micros = (juce::uint32)juce::jmin(
+      (double)std::numeric_limits<juce::uint32>::max(),
+      ticksToMicros((double)elapsed));
+  const int bucket =
+      micros == 0 ? 0
+                  : juce::jmin(numTimeBuckets - 1,
+                               juce::findHighestSetBit(micros) + 1);
+  counters.histogram[(size_t)bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void StageProfiler::recordBlock(juce::int64 ticks, int numSamples) {
+  record(Block, ticks);
+
+  if (numSamples <= 0)
+    return;
+
+  const double deadlineMicros = numSamples * 1.0e6 / sampleRate;
+  const auto load = (juce::uint64)juce::roundToInt(
+      1000.0 * ticksToMicros((double)ticks) / deadlineMicros);
+
+  add(totalSamples, (juce::uint64)numSamples);
+  add(totalLoad, load);
+
+  if (load > maxLoad.load(std::memory_order_relaxed))
+    maxLoad.store(load, std::memory_order_relaxed);
+
+  const int bucket = juce::jmin(numLoadBuckets - 1, (int)(load / 100));
+  loadHistogram[(size_t)bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+StageProfiler::StageStats StageProfiler::getStageStats(Stage stage) const {
+  const auto &counters = stages[(size_t)stage];
+
+  StageStats stats;
+  stats.calls = counters.calls.load(std::memory_order_relaxed);
+  if (stats.calls > 0)
+    stats.meanMicros =
+        ticksToMicros((double)counters.totalTicks.load() / stats.calls);
+  stats.maxMicros = ticksToMicros((double)counters.maxTicks.load());
+
+  for (int i = 0; i < numTimeBuckets; ++i)
+    stats.histogram[(size_t)i] = counters.histogram[(size_t)i].load();
+
+  return stats;
+}
+
+StageProfiler::LoadStats StageProfiler::getLoadStats() const {
+  LoadStats stats;
+  stats.blocks = stages[Block].calls.load(std::memory_order_relaxed);
+
+  if (stats.blocks > 0) {
+    stats.meanBlockMicros =
+        (double)totalSamples.load() / stats.blocks * 1.0e6 / sampleRate;
+    stats.meanLoad = (double)totalLoad.load() / stats.blocks / 1000.0;
+  }
+  stats.maxLoad = (double)maxLoad.load() / 1000.0;
+
+  for (int i = 0; i < numLoadBuckets; ++i)
+    stats.histogram[(size_t)i] = loadHistogram[(size_t)i].load();
+
+  return stats;
+}
+
+juce::String StageProfiler::getStageName(Stage stage) {
+  switch (stage) {
+  case Compressor:
+    return "Compressor";
+  case Boost:
+    return "Boost";
+  case TubeScreamer:
+    return "Tube Screamer";
+  case Klon:
+    return "Klon";
+  case Gate:
+    return "Noise Gate";
+  case Amp:
+    return "Amp Model";
+  case ToneStack:
+    return "Tone Stack";
+  case SecondGate:
+    return "Amp 2 Noise Gate";
+  case SecondAmp:
+    return "Amp 2 Model";
+  case SecondToneStack:
+    return "Amp 2 Tone Stack";
+  case Doubler:
+    return "Doubler";
+  case Chorus:
+    return "Chorus";
+  case Delay:
+    return "Delay";
+  case Reverb:
+    return "Reverb";
+  case Clipper:
+    return "Output Clipper";
+  case Block:
+    return "Whole Block";
+  default:
+    return {};
+  }
+}
+
+juce::String StageProfiler::getTimeBucketName(int bucket) {
+  if (bucket == 0)
+    return "<1us";
+  if (bucket == numTimeBuckets - 1)
+    return ">=" + juce::String(1 << (bucket - 1)) + "us";
+  return "<" + juce::String(1 << bucket) + "us";
+}
+
+juce::String StageProfiler::getLoadBucketName(int bucket) {
+  if (bucket == numLoadBuckets - 1)
+    return ">=100%";
+  return juce::String(bucket * 10) + "-" + juce::String(bucket * 10 + 10) +
+         "%";
+}
+
+juce::String StageProfiler::toCsv() const {
+  juce::String csv;
+
+  csv << "stage,calls,mean_us,max_us";
+  for (int i = 0; i < numTimeBuckets; ++i)
+    csv << "," << getTimeBucketName(i);
+  csv << "\n";
+
+  for (int s = 0; s < NumStages; ++s) {
+    const auto stats = getStageStats((Stage)s);
+    csv << getStageName((Stage)s) << "," << juce::String(stats.calls) << ","
+        << juce::String(stats.meanMicros, 2) << ","
+        << juce::String(stats.maxMicros, 2);
+    for (auto count : stats.histogram)
+      csv << "," << juce::String(count);
+    csv << "\n";
+  }
+
+  const auto load = getLoadStats();
+  csv << "\nblocks,mean_block_us,mean_load,max_load";
+  for (int i = 0; i < numLoadBuckets; ++i)
+    csv << "," << getLoadBucketName(i);
+  csv << "\n";
+
+  csv << juce::String(load.blocks) << ","
+      << juce::String(load.meanBlockMicros, 2) << ","
+      << juce::String(load.meanLoad, 4) << "," << juce::String(load.maxLoad, 4);
+  for (auto count : load.histogram)
+    csv << "," << juce::String(count);
+  csv << "\n";
+
+  return csv;
+}
+
+double StageProfiler::ticksToMicros(double ticks) {
+  return ticks * 1.0e6 /
+         (double)juce::Time::getHighResolutionTicksPerSecond();
+}
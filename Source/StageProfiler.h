@@ -0,0 +1,182 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/**
+ * Stage Profiler
+ * Per-stage timing of the audio thread, for finding the stage behind
+ * crackles on a given machine.
+ *
+ * Each stage is timed with a Scope (two high resolution tick reads) and
+ * lands in a lock-free histogram of call times; the whole processBlock is
+ * also compared against its deadline (the block's duration). Each stage
+ * has one writer, the audio thread or, for the dual amp's Second* stages,
+ * its worker; the editor reads any time. While disabled a Scope costs one
+ * relaxed load.
+ *
+ * Usage (audio thread):
+ *   {
+ *     StageProfiler::Scope scope(profiler, StageProfiler::Reverb);
+ *     reverb.process(buffer);
+ *   }
+ *
+ * Counts are per call: a stage run in ramp sub-blocks is counted once per
+ * sub-block.
+ */
+class StageProfiler {
+public:
+  enum Stage {
+    Compressor = 0,
+    Boost,
+    TubeScreamer,
+    Klon,
+    Gate,
+    Amp,
+    ToneStack,
+    SecondGate, // dual amp: the second amp's, timed on its worker
+    SecondAmp,
+    SecondToneStack,
+    Doubler,
+    Chorus,
+    Delay,
+    Reverb,
+    Clipper,
+    Block, // the whole processBlock
+    NumStages
+  };
+
+  // Call times: bucket 0 is < 1 us, bucket n is [2^(n-1), 2^n) us, the
+  // last bucket holds everything slower
+  static constexpr int numTimeBuckets = 16;
+
+  // Block time as a share of the block's duration, in 10% steps; the last
+  // bucket counts overruns (100% and above)
+  static constexpr int numLoadBuckets = 11;
+
+  StageProfiler() {}
+  ~StageProfiler() {}
+
+  void prepare(double newSampleRate) { sampleRate = newSampleRate; }
+
+  void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+  bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+  // Message thread; blocks in flight may still land in the old counts
+  void reset();
+
+  class Scope {
+  public:
+    Scope(StageProfiler *owner, Stage stageToTime)
+        : profiler(owner != nullptr && owner->isEnabled() ? owner : nullptr),
+          stage(stageToTime) {
+      resume();
+    }
+
+    ~Scope() {
+      pause();
+      if (profiler != nullptr)
+        profiler->record(stage, elapsed);
+    }
+
+    // Leaves out work in between, e.g. the model between the two halves
+    // of the gate
+    void pause() {
+      if (profiler != nullptr && start != 0) {
+        elapsed += juce::Time::getHighResolutionTicks() - start;
+        start = 0;
+      }
+    }
+
+    void resume() {
+      if (profiler != nullptr)
+        start = juce::Time::getHighResolutionTicks();
+    }
+
+  private:
+    StageProfiler *profiler;
+    Stage stage;
+    juce::int64 start{0};
+    juce::int64 elapsed{0};
+
+    JUCE_DECLARE_NON_COPYABLE(Scope)
+  };
+
+  // Times a whole processBlock, including against the block's deadline
+  class BlockScope {
+  public:
+    BlockScope(StageProfiler &owner, int blockSamples)
+        : profiler(owner.isEnabled() ? &owner : nullptr),
+          numSamples(blockSamples),
+          start(profiler != nullptr ? juce::Time::getHighResolutionTicks()
+                                    : 0) {}
+
+    ~BlockScope() {
+      if (profiler != nullptr)
+        profiler->recordBlock(juce::Time::getHighResolutionTicks() - start,
+                              numSamples);
+    }
+
+  private:
+    StageProfiler *profiler;
+    int numSamples;
+    juce::int64 start;
+
+    JUCE_DECLARE_NON_COPYABLE(BlockScope)
+  };
+
+  struct StageStats {
+    juce::uint64 calls{0};
+    double meanMicros{0.0};
+    double maxMicros{0.0};
+    std::array<juce::uint32, numTimeBuckets> histogram{};
+  };
+
+  struct LoadStats {
+    juce::uint64 blocks{0};
+    double meanBlockMicros{0.0}; // the deadline of an average block
+    double meanLoad{0.0};        // 1.0 = the whole deadline
+    double maxLoad{0.0};
+    std::array<juce::uint32, numLoadBuckets> histogram{};
+  };
+
+  StageStats getStageStats(Stage stage) const;
+  LoadStats getLoadStats() const;
+
+  static juce::String getStageName(Stage stage);
+  static juce::String getTimeBucketName(int bucket);
+  static juce::String getLoadBucketName(int bucket);
+
+  // Everything above as CSV, one section for stages, one for block load
+  juce::String toCsv() const;
+
+private:
+  struct Counters {
+    std::atomic<juce::uint64> calls{0};
+    std::atomic<juce::uint64> totalTicks{0};
+    std::atomic<juce::uint64> maxTicks{0};
+    std::array<std::atomic<juce::uint32>, numTimeBuckets> histogram{};
+  };
+
+  void record(Stage stage, juce::int64 ticks);
+  void recordBlock(juce::int64 ticks, int numSamples);
+
+  static void add(std::atomic<juce::uint64> &counter, juce::uint64 amount) {
+    counter.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  static double ticksToMicros(double ticks);
+
+  std::atomic<bool> enabled{false};
+  double sampleRate{48000.0};
+
+  std::array<Counters, NumStages> stages;
+
+  // Block load, in permille of the deadline
+  std::atomic<juce::uint64> totalSamples{0};
+  std::atomic<juce::uint64> totalLoad{0};
+  std::atomic<juce::uint64> maxLoad{0};
+  std::array<std::atomic<juce::uint32>, numLoadBuckets> loadHistogram{};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StageProfiler)
+};
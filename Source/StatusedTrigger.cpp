@@ -6,81 +6,189 @@ DSP_SAMPLE** StatusedTrigger::Process(DSP_SAMPLE** inputs, const size_t numChann
 {
     this->_PrepareBuffers(numChannels, numFrames);
 
-    // A bunch of numbers we'll use a few times.
+    bool isGating = this->gating.load (std::memory_order_relaxed);
+
+    // The main algorithm: compute the gain reduction. The envelope is worked
+    // out for the whole block first, then the state machine runs over it.
+    for (auto c = 0; c < numChannels; c++)
+    {
+        float* envelope = this->mEnvelope[c].data();
+        this->_ComputeEnvelope(inputs[c], envelope, numFrames, this->mLevel[c]);
+        this->_RunStateMachine(c, envelope, numFrames, isGating);
+    }
+
+    this->gating.store (isGating, std::memory_order_relaxed);
+
+    // Share the results with gain objects that are listening to this trigger:
+    for (auto gain = this->mGainListeners.begin(); gain != this->mGainListeners.end(); ++gain)
+        (*gain)->SetGainReductionDB(this->mGainReductionDB);
+
+    // Copy input to output
+    for (auto c = 0; c < numChannels; c++)
+        memcpy(this->mOutputs[c].data(), inputs[c], numFrames * sizeof(DSP_SAMPLE));
+    return this->_GetPointers();
+}
+
+void StatusedTrigger::_UpdateCoefficients()
+{
+    if (this->mSampleRate <= 0.0)
+        return;
+
+    const double dt = 1.0 / this->mSampleRate;
     const double alpha = pow(0.5, 1.0 / (this->mParams.GetTime() * this->mSampleRate));
     const double beta = 1.0 - alpha;
-    const double threshold = this->mParams.GetThreshold();
-    const double dt = 1.0 / this->mSampleRate;
-    const double maxHold = this->mParams.GetHoldTime();
-    const double maxGainReduction = this->_GetMaxGainReduction();
+
+    this->mAlpha = (float) alpha;
+    this->mBeta = (float) beta;
+
+    // Unrolling y[n] = alpha * y[n-1] + beta * x[n] four samples ahead
+    for (int k = 0; k < 4; k++)
+    {
+        this->mGroupCarry[k] = (float) pow(alpha, k + 1);
+        for (int j = 0; j < 4; j++)
+            this->mGroupWeights[k][j] = j <= k ? (float) (pow(alpha, k - j) * beta) : 0.0f;
+    }
+
+    // levelDB < threshold is the same test as level < this
+    this->mThresholdPower = (float) pow(10.0, this->mParams.GetThreshold() / 10.0);
+    this->mHoldSamples = std::max(1, (int) std::ceil(this->mParams.GetHoldTime() * this->mSampleRate));
+
     // Amount of open or close in a sample: rate times time
-    const double dOpen = -this->_GetMaxGainReduction() / this->mParams.GetOpenTime() * dt; // >0
-    const double dClose = this->_GetMaxGainReduction() / this->mParams.GetCloseTime() * dt; // <0
+    this->mOpenStep = -this->_GetMaxGainReduction() / this->mParams.GetOpenTime() * dt; // >0
+    this->mCloseStep = this->_GetMaxGainReduction() / this->mParams.GetCloseTime() * dt; // <0
+}
 
-    // The main algorithm: compute the gain reduction
-    for (auto c = 0; c < numChannels; c++)
+void StatusedTrigger::_ComputeEnvelope(const DSP_SAMPLE* input, float* envelope, const size_t numFrames, float& level) const
+{
+    const float minPower = (float) dsp::noise_gate::MINIMUM_LOUDNESS_POWER;
+    const float maxPower = 1000.0f;
+
+    // Instantaneous power
+    for (size_t s = 0; s < numFrames; s++)
+        envelope[s] = (float) (input[s] * input[s]);
+
+    // Given the level before a group, its four outputs don't depend on each
+    // other, so only the carry from one group to the next is serial
+    float y = level;
+    size_t s = 0;
+    for (; s + 4 <= numFrames; s += 4)
+    {
+        float group[4];
+        for (int k = 0; k < 4; k++)
+        {
+            float sum = this->mGroupCarry[k] * y;
+            for (int j = 0; j < 4; j++)
+                sum += this->mGroupWeights[k][j] * envelope[s + j];
+            group[k] = sum;
+        }
+
+        for (int k = 0; k < 4; k++)
+            envelope[s + k] = std::clamp(group[k], minPower, maxPower);
+
+        y = envelope[s + 3];
+    }
+
+    for (; s < numFrames; s++)
+    {
+        y = std::clamp(this->mAlpha * y + this->mBeta * envelope[s], minPower, maxPower);
+        envelope[s] = y;
+    }
+
+    level = y;
+}
+
+void StatusedTrigger::_RunStateMachine(const size_t channel, const float* envelope, const size_t numFrames, bool& isGating)
+{
+    DSP_SAMPLE* gainReduction = this->mGainReductionDB[channel].data();
+    const double maxGainReduction = this->_GetMaxGainReduction();
+    const float thresholdPower = this->mThresholdPower;
+
+    State state = this->mState[channel];
+    double lastGainReduction = this->mLastGainReductionDB[channel];
+    int heldSamples = this->mHeldSamples[channel];
+
+    size_t s = 0;
+    while (s < numFrames)
     {
-        for (auto s = 0; s < numFrames; s++)
+        if (state == StatusedTrigger::State::HOLDING)
         {
-            this->mLevel[c] =
-                std::clamp(alpha * this->mLevel[c] + beta * (inputs[c][s] * inputs[c][s]), dsp::noise_gate::MINIMUM_LOUDNESS_POWER, 1000.0);
-            const double levelDB = level_to_db(this->mLevel[c]);
-            if (this->mState[c] == StatusedTrigger::State::HOLDING)
+            // Fully open, so only the hold count changes until the level has
+            // been below threshold for long enough
+            const size_t start = s;
+            for (; s < numFrames; s++)
             {
-                this->mGainReductionDB[c][s] = 0.0;
-                this->mLastGainReductionDB[c] = 0.0;
-                if (levelDB < threshold)
+                if (envelope[s] >= thresholdPower)
                 {
-                    this->mTimeHeld[c] += dt;
-                    if (this->mTimeHeld[c] >= maxHold)
-                        this->mState[c] = StatusedTrigger::State::MOVING;
+                    heldSamples = 0;
                 }
-                else
+                else if (++heldSamples >= this->mHoldSamples)
                 {
-                    this->mTimeHeld[c] = 0.0;
+                    state = StatusedTrigger::State::MOVING;
+                    s++;
+                    break;
                 }
             }
-            else
-            { // Moving
-                const double targetGainReduction = this->_GetGainReduction(levelDB);
-                if (targetGainReduction > this->mLastGainReductionDB[c])
-                {
-                    const double dGain = std::clamp(0.5 * (targetGainReduction - this->mLastGainReductionDB[c]), 0.0, dOpen);
-                    this->mLastGainReductionDB[c] += dGain;
-                    if (this->mLastGainReductionDB[c] >= 0.0)
-                    {
-                        this->mLastGainReductionDB[c] = 0.0;
-                        this->mState[c] = StatusedTrigger::State::HOLDING;
-                        this->mTimeHeld[c] = 0.0;
-                    }
-
-                    if (levelDB > threshold)
-                        this->gating = false;
-                }
-                else if (targetGainReduction < this->mLastGainReductionDB[c])
-                {
-                    const double dGain = std::clamp(0.5 * (targetGainReduction - this->mLastGainReductionDB[c]), dClose, 0.0);
-                    this->mLastGainReductionDB[c] += dGain;
-                    if (this->mLastGainReductionDB[c] < maxGainReduction)
-                    {
-                        this->mLastGainReductionDB[c] = maxGainReduction;
-                    }
-
-                    gating = true;
-                }
-                this->mGainReductionDB[c][s] = this->mLastGainReductionDB[c];
+
+            std::fill(gainReduction + start, gainReduction + s, (DSP_SAMPLE) 0.0);
+            lastGainReduction = 0.0;
+            continue;
+        }
+
+        // Moving. Decibels are only needed below threshold, where the target
+        // isn't simply zero.
+        const float level = envelope[s];
+        const double targetGainReduction = level < thresholdPower ? this->_GetGainReduction(_PowerToDB(level)) : 0.0;
+        if (targetGainReduction > lastGainReduction)
+        {
+            const double dGain = std::clamp(0.5 * (targetGainReduction - lastGainReduction), 0.0, this->mOpenStep);
+            lastGainReduction += dGain;
+            if (lastGainReduction >= 0.0)
+            {
+                lastGainReduction = 0.0;
+                state = StatusedTrigger::State::HOLDING;
+                heldSamples = 0;
             }
+
+            if (level > thresholdPower)
+                isGating = false;
+        }
+        else if (targetGainReduction < lastGainReduction)
+        {
+            const double dGain = std::clamp(0.5 * (targetGainReduction - lastGainReduction), this->mCloseStep, 0.0);
+            lastGainReduction += dGain;
+            if (lastGainReduction < maxGainReduction)
+            {
+                lastGainReduction = maxGainReduction;
+            }
+
+            isGating = true;
         }
+        gainReduction[s++] = (DSP_SAMPLE) lastGainReduction;
     }
 
-    // Share the results with gain objects that are listening to this trigger:
-    for (auto gain = this->mGainListeners.begin(); gain != this->mGainListeners.end(); ++gain)
-        (*gain)->SetGainReductionDB(this->mGainReductionDB);
+    this->mState[channel] = state;
+    this->mLastGainReductionDB[channel] = lastGainReduction;
+    this->mHeldSamples[channel] = heldSamples;
+}
 
-    // Copy input to output
-    for (auto c = 0; c < numChannels; c++)
-        memcpy(this->mOutputs[c].data(), inputs[c], numFrames * sizeof(DSP_SAMPLE));
-    return this->_GetPointers();
+double StatusedTrigger::_PowerToDB(const float power)
+{
+    // power = 2^e * m with m in [1, 2). log2(m) = 2 / ln(2) * atanh(t) where
+    // t = (m - 1) / (m + 1) < 1/3, so a few terms of the series are plenty.
+    uint32_t bits;
+    memcpy(&bits, &power, sizeof(bits));
+    const int exponent = (int) ((bits >> 23) & 0xff) - 127;
+    bits = (bits & 0x007fffff) | 0x3f800000;
+
+    float mantissa;
+    memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    const float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+    const float t2 = t * t;
+    const float log2Mantissa = 2.8853900817779268f * t * (1.0f + t2 * (1.0f / 3.0f + t2 * (0.2f + t2 * (1.0f / 7.0f))));
+
+    // 10 * log10(2) dB per octave of power
+    return 3.0102999566398120 * ((double) exponent + (double) log2Mantissa);
 }
 
 void StatusedTrigger::_PrepareBuffers(const size_t numChannels, const size_t numFrames)
@@ -103,9 +211,10 @@ void StatusedTrigger::_PrepareBuffers(const size_t numChannels, const size_t num
             this->mState.resize(numChannels);
             std::fill(this->mState.begin(), this->mState.end(), StatusedTrigger::State::MOVING);
             this->mLevel.resize(numChannels);
-            std::fill(this->mLevel.begin(), this->mLevel.end(), dsp::noise_gate::MINIMUM_LOUDNESS_POWER);
-            this->mTimeHeld.resize(numChannels);
-            std::fill(this->mTimeHeld.begin(), this->mTimeHeld.end(), 0.0);
+            std::fill(this->mLevel.begin(), this->mLevel.end(), (float) dsp::noise_gate::MINIMUM_LOUDNESS_POWER);
+            this->mHeldSamples.resize(numChannels);
+            std::fill(this->mHeldSamples.begin(), this->mHeldSamples.end(), 0);
+            this->mEnvelope.resize(numChannels);
         }
         if (updateFrames)
         {
@@ -113,7 +222,8 @@ void StatusedTrigger::_PrepareBuffers(const size_t numChannels, const size_t num
             {
                 this->mGainReductionDB[i].resize(numFrames);
                 std::fill(this->mGainReductionDB[i].begin(), this->mGainReductionDB[i].end(), maxGainReduction);
+                this->mEnvelope[i].resize(numFrames);
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -5,6 +5,8 @@
 #include <unordered_set>
 #include <vector>
 #include <algorithm> // std::clamp
+#include <atomic>
+#include <cstdint>
 #include <cstring> // memcpy
 #include <cmath> // pow
 #include <sstream>
@@ -21,9 +23,11 @@ public:
     StatusedTrigger();
     DSP_SAMPLE** Process (DSP_SAMPLE** inputs, const size_t numChannels, const size_t numFrames) override;
     std::vector<std::vector<DSP_SAMPLE>> GetGainReduction() const { return this->mGainReductionDB; };
-    void SetParams(const dsp::noise_gate::TriggerParams& params) { this->mParams = params; };
-    void SetSampleRate(const double sampleRate) { this->mSampleRate = sampleRate; }
+    void SetParams(const dsp::noise_gate::TriggerParams& params) { this->mParams = params; this->_UpdateCoefficients(); };
+    void SetSampleRate(const double sampleRate) { this->mSampleRate = sampleRate; this->_UpdateCoefficients(); }
     std::vector<std::vector<DSP_SAMPLE>> GetGainReductionDB() const { return this->mGainReductionDB; };
+    // The last block's gain reduction for one channel, without a copy
+    const DSP_SAMPLE* GetGainReductionDBData(const size_t channel) const { return this->mGainReductionDB[channel].data(); };
 
     void AddListener(dsp::noise_gate::Gain* gain)
     {
@@ -32,7 +36,11 @@ public:
         this->mGainListeners.insert(gain);
     }
 
-    bool isGating() { return this->gating; };
+    // Safe to read from other threads; Process writes it
+    bool isGating() const { return this->gating.load (std::memory_order_relaxed); };
+
+    // Channel 0 gain reduction at the end of the last block, in dB
+    double GetLastGainReductionDB() const { return this->mLastGainReductionDB.empty() ? 0.0 : this->mLastGainReductionDB[0]; };
 
 private:
     enum class State
@@ -51,9 +59,25 @@ private:
     double _GetMaxGainReduction() const { return this->_GetGainReduction(dsp::noise_gate::MINIMUM_LOUDNESS_DB); }
     virtual void _PrepareBuffers (const size_t numChannels, const size_t numFrames) override;
 
+    // Everything Process needs from the params and sample rate, worked out
+    // once when either changes instead of every block
+    void _UpdateCoefficients();
+
+    // Power envelope of one channel into `envelope`, carrying `level` over
+    void _ComputeEnvelope (const DSP_SAMPLE* input, float* envelope, const size_t numFrames, float& level) const;
+
+    // Hold/open/close logic for one channel over its envelope
+    void _RunStateMachine (const size_t channel, const float* envelope, const size_t numFrames, bool& isGating);
+
+    // 10 * log10(power) without calling into libm; within 1e-4 dB
+    static double _PowerToDB (const float power);
+
     dsp::noise_gate::TriggerParams mParams;
     std::vector<State> mState; // One per channel
-    std::vector<double> mLevel;
+    std::vector<float> mLevel;
+
+    // Scratch: the power envelope of the current block, one per channel
+    std::vector<std::vector<float>> mEnvelope;
 
     // Hold the vectors of gain reduction for the block, in dB.
     // These can be given to the Gain object.
@@ -61,14 +85,23 @@ private:
     std::vector<double> mLastGainReductionDB;
 
     double mSampleRate;
-    // How long we've been holding
-    std::vector<double> mTimeHeld;
+    // How long we've been holding, in samples
+    std::vector<int> mHeldSamples;
+
+    // From _UpdateCoefficients. The follower runs in groups of four
+    // samples: y[n+k] = mGroupCarry[k] * y[n-1] + sum_j mGroupWeights[k][j] * x[n+j]
+    float mAlpha = 0.0f;
+    float mBeta = 1.0f;
+    float mGroupCarry[4] = {};
+    float mGroupWeights[4][4] = {};
+    float mThresholdPower = 0.0f;
+    int mHoldSamples = 1;
+    double mOpenStep = 0.0;  // >0, dB per sample
+    double mCloseStep = 0.0; // <0, dB per sample
 
     std::unordered_set<dsp::noise_gate::Gain*> mGainListeners;
 
-    double level_to_db(const DSP_SAMPLE db) { return 10.0 * log10(db); };
-
-    bool gating{false};
+    std::atomic<bool> gating{false};
 };
 
 #endif
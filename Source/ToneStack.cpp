@@ -2,56 +2,122 @@
 
 DSP_SAMPLE** dsp::tone_stack::BasicNamToneStack::Process(DSP_SAMPLE** inputs, const int numChannels, const int numFrames)
 {
-    DSP_SAMPLE** bassPointers = mToneBass.Process(inputs, numChannels, numFrames);
-    DSP_SAMPLE** midPointers = mToneMid.Process(bassPointers, numChannels, numFrames);
-    DSP_SAMPLE** treblePointers = mToneTreble.Process(midPointers, numChannels, numFrames);
-    return treblePointers;
+    this->_PrepareBuffers(numChannels, numFrames);
+
+    // All three bands in one pass over the block
+    for (int c = 0; c < numChannels; c++)
+        mCascade.process(inputs[c], mOutputs[c].data(), numFrames, mStates[c]);
+
+    for (int c = 0; c < numChannels; c++)
+        mOutputPointers[c] = mOutputs[c].data();
+    return mOutputPointers.data();
 }
 
 void dsp::tone_stack::BasicNamToneStack::Reset(const double sampleRate, const int maxBlockSize)
 {
     dsp::tone_stack::AbstractToneStack::Reset(sampleRate, maxBlockSize);
 
+    // Size for the largest block now, so Process doesn't allocate
+    this->_PrepareBuffers(std::max<int>(1, (int) mStates.size()), maxBlockSize);
+    for (auto& state : mStates)
+        BiquadCascade<kNumSections>::reset(state);
+
     // Refresh the params!
-    SetParam("bass", mBassVal);
-    SetParam("middle", mMiddleVal);
-    SetParam("treble", mTrebleVal);
+    _UpdateBass();
+    _UpdateMiddle();
+    _UpdateTreble();
 }
 
-void dsp::tone_stack::BasicNamToneStack::SetParam(const std::string name, const double val)
+void dsp::tone_stack::BasicNamToneStack::_PrepareBuffers(const int numChannels, const int numFrames)
 {
-    if (name == "bass")
+    if (numChannels > (int) mStates.size())
     {
-        // HACK: Store for refresh
-        mBassVal = val;
-        const double sampleRate = GetSampleRate();
-        const double bassGainDB = 4.0 * (val - 5.0); // +/- 20
-        const double bassFrequency = 150.0;
-        const double bassQuality = 0.707;
-        recursive_linear_filter::BiquadParams bassParams(sampleRate, bassFrequency, bassQuality, bassGainDB);
-        mToneBass.SetParams(bassParams);
+        mStates.resize(numChannels);
+        for (int c = (int) mOutputs.size(); c < numChannels; c++)
+            BiquadCascade<kNumSections>::reset(mStates[c]);
+        mOutputs.resize(numChannels);
+        mOutputPointers.resize(numChannels);
     }
+
+    for (auto& output : mOutputs)
+        if ((int) output.size() < numFrames)
+            output.resize(numFrames);
+}
+
+void dsp::tone_stack::BasicNamToneStack::SetParam(const std::string& name, const double val)
+{
+    if (name == "bass")
+        SetBass(val);
     else if (name == "middle")
-    {
-        // HACK: Store for refresh
-        mMiddleVal = val;
-        const double sampleRate = GetSampleRate();
-        const double midGainDB = 3.0 * (val - 5.0); // +/- 15
-        const double midFrequency = 425.0;
-        // Wider EQ on mid bump up to sound less honky.
-        const double midQuality = midGainDB < 0.0 ? 1.5 : 0.7;
-        recursive_linear_filter::BiquadParams midParams(sampleRate, midFrequency, midQuality, midGainDB);
-        mToneMid.SetParams(midParams);
-    }
+        SetMiddle(val);
     else if (name == "treble")
-    {
-        // HACK: Store for refresh
-        mTrebleVal = val;
-        const double sampleRate = GetSampleRate();
-        const double trebleGainDB = 2.0 * (val - 5.0); // +/- 10
-        const double trebleFrequency = 1800.0;
-        const double trebleQuality = 0.707;
-        recursive_linear_filter::BiquadParams trebleParams(sampleRate, trebleFrequency, trebleQuality, trebleGainDB);
-        mToneTreble.SetParams(trebleParams);
-    }
-}
\ No newline at end of file
+        SetTreble(val);
+}
+
+void dsp::tone_stack::BasicNamToneStack::SetBass(const double val)
+{
+    // The cascade already holds this knob value's coefficients
+    if (val == mBassVal)
+        return;
+
+    // HACK: Store for refresh
+    mBassVal = val;
+    _UpdateBass();
+}
+
+void dsp::tone_stack::BasicNamToneStack::SetMiddle(const double val)
+{
+    if (val == mMiddleVal)
+        return;
+
+    // HACK: Store for refresh
+    mMiddleVal = val;
+    _UpdateMiddle();
+}
+
+void dsp::tone_stack::BasicNamToneStack::SetTreble(const double val)
+{
+    if (val == mTrebleVal)
+        return;
+
+    // HACK: Store for refresh
+    mTrebleVal = val;
+    _UpdateTreble();
+}
+
+void dsp::tone_stack::BasicNamToneStack::_UpdateBass()
+{
+    const double sampleRate = GetSampleRate();
+    if (sampleRate <= 0.0)
+        return;
+
+    const double bassGainDB = 4.0 * (mBassVal - 5.0); // +/- 20
+    const double bassFrequency = 150.0;
+    const double bassQuality = 0.707;
+    mCascade.setSection(kBass, BiquadCoefficients::lowShelf(sampleRate, bassFrequency, bassQuality, bassGainDB));
+}
+
+void dsp::tone_stack::BasicNamToneStack::_UpdateMiddle()
+{
+    const double sampleRate = GetSampleRate();
+    if (sampleRate <= 0.0)
+        return;
+
+    const double midGainDB = 3.0 * (mMiddleVal - 5.0); // +/- 15
+    const double midFrequency = 425.0;
+    // Wider EQ on mid bump up to sound less honky.
+    const double midQuality = midGainDB < 0.0 ? 1.5 : 0.7;
+    mCascade.setSection(kMiddle, BiquadCoefficients::peaking(sampleRate, midFrequency, midQuality, midGainDB));
+}
+
+void dsp::tone_stack::BasicNamToneStack::_UpdateTreble()
+{
+    const double sampleRate = GetSampleRate();
+    if (sampleRate <= 0.0)
+        return;
+
+    const double trebleGainDB = 2.0 * (mTrebleVal - 5.0); // +/- 10
+    const double trebleFrequency = 1800.0;
+    const double trebleQuality = 0.707;
+    mCascade.setSection(kTreble, BiquadCoefficients::highShelf(sampleRate, trebleFrequency, trebleQuality, trebleGainDB));
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
+#include <vector>
 #include "../Modules/AudioDSPTools/dsp/dsp.h"
-#include "../Modules/AudioDSPTools/dsp/RecursiveLinearFilter.h"
+#include "BiquadCascade.h"
 
 namespace dsp
 {
@@ -21,7 +23,7 @@ public:
     };
     // Set the various parameters of your tone stack by name.
     // Call this during OnParamChange()
-    virtual void SetParam (const std::string name, const double val) = 0;
+    virtual void SetParam (const std::string& name, const double val) = 0;
 
 protected:
     double GetSampleRate() const { return mSampleRate; };
@@ -42,14 +44,49 @@ public:
 
     DSP_SAMPLE** Process (DSP_SAMPLE** inputs, const int numChannels, const int numFrames);
     virtual void Reset (const double sampleRate, const int maxBlockSize) override;
+    // Channel 0 only, with no buffers of its own: read(i) supplies sample i
+    // and write(i, y) takes the filtered sample, so the caller can fold its
+    // own per-sample work into the same pass. Call Reset() first.
+    template <typename Read, typename Write>
+    void ProcessMono (const int numFrames, Read&& read, Write&& write)
+    {
+        mCascade.run(numFrames, mStates[0], read, write);
+    }
+
     // :param val: Assumed to be between 0 and 10, 5 is "noon"
-    void SetParam (const std::string name, const double val);
+    void SetParam (const std::string& name, const double val);
+
+    // Typed setters for the real-time path: no string compare, and only the
+    // one band whose knob moved is recomputed. Setting a band to the value it
+    // already has costs a compare.
+    void SetBass (const double val);
+    void SetMiddle (const double val);
+    void SetTreble (const double val);
 
 
 protected:
-    recursive_linear_filter::LowShelf mToneBass;
-    recursive_linear_filter::Peaking mToneMid;
-    recursive_linear_filter::HighShelf mToneTreble;
+    // Coefficients for the stored knob values at the current sample rate
+    void _UpdateBass();
+    void _UpdateMiddle();
+    void _UpdateTreble();
+
+    // Grows the output buffers; only allocates past the Reset() sizes
+    void _PrepareBuffers (const int numChannels, const int numFrames);
+
+    // Bass (low shelf), middle (peaking) and treble (high shelf) as one
+    // fused cascade, with one state per channel
+    enum Section
+    {
+        kBass = 0,
+        kMiddle,
+        kTreble,
+        kNumSections
+    };
+    BiquadCascade<kNumSections> mCascade;
+    std::vector<BiquadCascade<kNumSections>::State> mStates;
+
+    std::vector<std::vector<DSP_SAMPLE>> mOutputs;
+    std::vector<DSP_SAMPLE*> mOutputPointers;
 
     // HACK not DRY w knob defs
     double mBassVal = 5.0;
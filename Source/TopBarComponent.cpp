@@ -27,11 +27,58 @@ TopBarComponent::TopBarComponent(NamJUCEAudioProcessor &p)
   if (JUCEApplication::isStandaloneApp())
     settingsDropdown->addItem(TRANS("Audio/Midi Settings..."), 1);
   settingsDropdown->addItem(TRANS("Info"), 2);
+  settingsDropdown->addItem(TRANS("CPU Profiler"), 3);
+  settingsDropdown->addItem(TRANS("Load Second Amp..."), 4);
+  settingsDropdown->addItem(TRANS("Clear Second Amp"), 5);
+  settingsDropdown->addItem(TRANS("Adaptive Quality: On"),
+                            adaptiveQualityItemId);
+  updateAdaptiveQualityItem();
+  settingsDropdown->addItem(TRANS("Live Preset Standby: Off"),
+                            liveStandbyItemId);
+  updateLiveStandbyItem();
+  settingsDropdown->addItem(TRANS("High Quality Bounce: Off"),
+                            highQualityBounceItemId);
+  updateHighQualityBounceItem();
+
+  juce::PopupMenu pedalOrderMenu;
+  const auto orderNames = ExecutionPlan::getOrderNames();
+  for (int i = 0; i < orderNames.size(); ++i)
+    pedalOrderMenu.addItem(pedalOrderItemId + i, orderNames[i]);
+  settingsDropdown->getRootMenu()->addSubMenu(TRANS("Pedal Order"),
+                                              pedalOrderMenu);
   settingsDropdown->addListener(this);
   settingsDropdown->setLookAndFeel(&lnf);
 
   // Currently no use for settings button, remove in the future if needed.
   settingsButton->setVisible(false);
+
+  // Share of the second amp; only shown while one is loaded
+  ampBlendSlider.setTooltip("Amp blend");
+  addChildComponent(ampBlendSlider);
+  ampBlendAttachment = std::make_unique<
+      juce::AudioProcessorValueTreeState::SliderAttachment>(
+      audioProcessor.apvts, "AMP_BLEND_ID", ampBlendSlider);
+
+  static constexpr const char *amp2ToneIds[] = {
+      "AMP2_BASS_ID", "AMP2_MIDDLE_ID", "AMP2_TREBLE_ID"};
+  static constexpr const char *amp2ToneNames[] = {
+      "Amp 2 bass", "Amp 2 middle", "Amp 2 treble"};
+  for (size_t i = 0; i < amp2ToneSliders.size(); ++i) {
+    auto &slider = amp2ToneSliders[i];
+    slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    slider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    slider.setTooltip(amp2ToneNames[i]);
+    addChildComponent(slider);
+    amp2ToneAttachments[i] = std::make_unique<
+        juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, amp2ToneIds[i], slider);
+  }
+  updateSecondAmpControls();
+
+  qualityLabel.setJustificationType(juce::Justification::centredLeft);
+  qualityLabel.setColour(juce::Label::textColourId, juce::Colours::orange);
+  addChildComponent(qualityLabel);
+  startTimerHz(4);
 }
 
 TopBarComponent::~TopBarComponent() {}
@@ -42,6 +89,10 @@ void TopBarComponent::resized() {
   // Position settings button on the right side of topbar
   settingsButton->setBounds(getWidth() - 35, 7, 25, 25);
   settingsDropdown->setBounds(settingsButton->getBounds());
+  ampBlendSlider.setBounds(getWidth() - 205, 10, 160, 20);
+  for (size_t i = 0; i < amp2ToneSliders.size(); ++i)
+    amp2ToneSliders[i].setBounds(getWidth() - 295 + 28 * (int)i, 8, 24, 24);
+  qualityLabel.setBounds(10, 10, 240, 20);
 }
 
 void TopBarComponent::setBackgroundColour(juce::Colour colour) {
@@ -51,6 +102,14 @@ void TopBarComponent::setBackgroundColour(juce::Colour colour) {
 
 void TopBarComponent::comboBoxChanged(ComboBox *comboBoxThatHasChanged) {
   if (comboBoxThatHasChanged == settingsDropdown.get()) {
+    const int selectedId = comboBoxThatHasChanged->getSelectedId();
+    if (selectedId >= pedalOrderItemId) {
+      setPedalOrder(selectedId - pedalOrderItemId);
+      settingsDropdown->setSelectedItemIndex(
+          -1, juce::NotificationType::dontSendNotification);
+      return;
+    }
+
     int selection = JUCEApplication::isStandaloneApp()
                         ? comboBoxThatHasChanged->getSelectedItemIndex()
                         : comboBoxThatHasChanged->getSelectedItemIndex() + 1;
@@ -65,6 +124,32 @@ void TopBarComponent::comboBoxChanged(ComboBox *comboBoxThatHasChanged) {
                      juce::String(PLUG_VERSION) +
                      "\n\nAll Mayer tones in one plugin.");
       break;
+    case DropdownOptions::Profiler:
+      if (onToggleProfiler)
+        onToggleProfiler();
+      break;
+    case DropdownOptions::LoadSecondAmp:
+      chooseSecondAmp();
+      break;
+    case DropdownOptions::ClearSecondAmp:
+      audioProcessor.clearSecondAmp();
+      updateSecondAmpControls();
+      break;
+    case DropdownOptions::AdaptiveQuality: {
+      auto &governor = audioProcessor.getQualityGovernor();
+      governor.setEnabled(!governor.isEnabled());
+      updateAdaptiveQualityItem();
+      break;
+    }
+    case DropdownOptions::LiveStandby:
+      audioProcessor.setLiveStandby(!audioProcessor.isLiveStandbyEnabled());
+      updateLiveStandbyItem();
+      break;
+    case DropdownOptions::HighQualityBounce:
+      audioProcessor.setHighQualityBounce(
+          !audioProcessor.isHighQualityBounceEnabled());
+      updateHighQualityBounceItem();
+      break;
     default:
       break;
     }
@@ -75,6 +160,78 @@ void TopBarComponent::comboBoxChanged(ComboBox *comboBoxThatHasChanged) {
   }
 }
 
+void TopBarComponent::setPedalOrder(int orderIndex) {
+  // One gesture, so the host records a single automation point
+  if (auto *param = audioProcessor.apvts.getParameter("PEDAL_ORDER_ID")) {
+    param->beginChangeGesture();
+    param->setValueNotifyingHost(param->convertTo0to1((float)orderIndex));
+    param->endChangeGesture();
+  }
+}
+
+void TopBarComponent::chooseSecondAmp() {
+  fileChooser = std::make_unique<juce::FileChooser>(
+      "Load Second Amp", audioProcessor.getSecondAmpFile(), "*.nam");
+
+  const int flags = juce::FileBrowserComponent::openMode |
+                    juce::FileBrowserComponent::canSelectFiles;
+
+  fileChooser->launchAsync(flags, [this](const juce::FileChooser &chooser) {
+    const auto file = chooser.getResult();
+    if (file == juce::File())
+      return;
+
+    if (!audioProcessor.loadSecondAmp(file))
+      openInfoWindow("Could not load\n\n" + file.getFileName());
+
+    updateSecondAmpControls();
+  });
+}
+
+void TopBarComponent::updateSecondAmpControls() {
+  const bool loaded = audioProcessor.getSecondAmpFile() != juce::File();
+  ampBlendSlider.setVisible(loaded);
+  for (auto &slider : amp2ToneSliders)
+    slider.setVisible(loaded);
+}
+
+void TopBarComponent::timerCallback() {
+  const auto &governor = audioProcessor.getQualityGovernor();
+  const auto tier = governor.getTier();
+
+  qualityLabel.setVisible(tier != QualityGovernor::Full);
+  if (tier == QualityGovernor::Full)
+    return;
+
+  qualityLabel.setText("CPU saver: " + QualityGovernor::getTierName(tier),
+                       juce::dontSendNotification);
+  qualityLabel.setTooltip(
+      "Quality reduced to keep up with the audio deadline. Load " +
+      juce::String(juce::roundToInt(governor.getLoad() * 100.0f)) + "%");
+}
+
+void TopBarComponent::updateAdaptiveQualityItem() {
+  settingsDropdown->changeItemText(
+      adaptiveQualityItemId,
+      audioProcessor.getQualityGovernor().isEnabled()
+          ? TRANS("Adaptive Quality: On")
+          : TRANS("Adaptive Quality: Off"));
+}
+
+void TopBarComponent::updateLiveStandbyItem() {
+  settingsDropdown->changeItemText(liveStandbyItemId,
+                                   audioProcessor.isLiveStandbyEnabled()
+                                       ? TRANS("Live Preset Standby: On")
+                                       : TRANS("Live Preset Standby: Off"));
+}
+
+void TopBarComponent::updateHighQualityBounceItem() {
+  settingsDropdown->changeItemText(highQualityBounceItemId,
+                                   audioProcessor.isHighQualityBounceEnabled()
+                                       ? TRANS("High Quality Bounce: On")
+                                       : TRANS("High Quality Bounce: Off"));
+}
+
 void TopBarComponent::openInfoWindow(juce::String m) {
   juce::DialogWindow::LaunchOptions options;
   auto *label = new Label();
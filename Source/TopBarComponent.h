@@ -6,7 +6,8 @@
 // clang-format on
 
 class TopBarComponent : public juce::AudioProcessorEditor,
-                        public juce::ComboBox::Listener {
+                        public juce::ComboBox::Listener,
+                        private juce::Timer {
 public:
   TopBarComponent(NamJUCEAudioProcessor &);
   ~TopBarComponent() override;
@@ -19,15 +20,64 @@ public:
   void comboBoxChanged(ComboBox *comboBoxThatHasChanged) override;
   void openInfoWindow(juce::String m);
 
-  enum DropdownOptions { AudioSettings = 0, Info };
+  enum DropdownOptions {
+    AudioSettings = 0,
+    Info,
+    Profiler,
+    LoadSecondAmp,
+    ClearSecondAmp,
+    AdaptiveQuality,
+    LiveStandby,
+    HighQualityBounce
+  };
+
+  // Called when "CPU Profiler" is picked from the settings menu
+  std::function<void()> onToggleProfiler;
 
 private:
+  // Item IDs of the "Pedal Order" submenu, one per ExecutionPlan ordering
+  static constexpr int pedalOrderItemId = 100;
+  void setPedalOrder(int orderIndex);
+
+  // Dual amp
+  void chooseSecondAmp();
+  void updateSecondAmpControls();
+
+  // Quality governor: tier shown while below full quality, and the menu
+  // item that switches it on and off
+  static constexpr int adaptiveQualityItemId = 6;
+  juce::Label qualityLabel;
+  void timerCallback() override;
+  void updateAdaptiveQualityItem();
+
+  // Live preset standby on or off
+  static constexpr int liveStandbyItemId = 7;
+  void updateLiveStandbyItem();
+
+  // 4x pedal oversampling in offline renders on or off
+  static constexpr int highQualityBounceItemId = 8;
+  void updateHighQualityBounceItem();
+
+  std::unique_ptr<juce::FileChooser> fileChooser;
+  juce::Slider ampBlendSlider{juce::Slider::LinearHorizontal,
+                              juce::Slider::NoTextBox};
+  std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
+      ampBlendAttachment;
+
+  // Second amp's bass, middle and treble
+  std::array<juce::Slider, 3> amp2ToneSliders;
+  std::array<std::unique_ptr<
+                 juce::AudioProcessorValueTreeState::SliderAttachment>,
+             3>
+      amp2ToneAttachments;
+
   std::unique_ptr<juce::ComboBox> settingsDropdown;
   std::unique_ptr<juce::ImageButton> settingsButton;
 
-  juce::Image settingsPushed = juce::ImageFileFormat::loadFrom(
+  juce::SharedResourcePointer<SharedImages> sharedImages;
+  juce::Image settingsPushed = sharedImages->get(
       BinaryData::settingspushed_png, BinaryData::settingspushed_pngSize);
-  juce::Image settingsUnpushed = juce::ImageFileFormat::loadFrom(
+  juce::Image settingsUnpushed = sharedImages->get(
       BinaryData::settingsunpushed_png, BinaryData::settingsunpushed_pngSize);
 
   juce::Colour backgroundColour{juce::Colours::transparentBlack};
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "architecture.hpp"
+
+#if defined(ARCH_EXT_SSE)
+#include <immintrin.h>
+#endif
+
+/**
+ * Shared waveshaper library
+ * Static saturation curves used by the output safety clipper, the Clean Boost
+ * soft clip and the NAM tanh activation.
+ *
+ * Shapes (in decreasing cost / accuracy):
+ * - RationalTanh: [7/6] Pade approximant of tanh, max error ~1e-4
+ * - CubicSoft:    x - x^3/3 soft clip, scaled to saturate at +/-1
+ * - Hard:         plain +/-1 clip
+ *
+ * Block functions are branch-free and use SSE where available; other
+ * architectures get a plain loop that the compiler can auto-vectorize.
+ * ADAA1 wraps any shape with first-order antiderivative anti-aliasing.
+ */
+namespace waveshapers {
+
+enum class Shape { RationalTanh = 0, CubicSoft, Hard };
+
+// Beyond this the Pade approximant is within 1e-4 of +/-1 and starts to
+// overshoot, so the input is clamped here.
+static constexpr float kTanhClamp = 4.97f;
+
+//==============================================================================
+// Scalar curves
+
+inline float rationalTanh(float x) noexcept {
+  x = std::clamp(x, -kTanhClamp, kTanhClamp);
+  const float x2 = x * x;
+  const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+  const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2));
+  return num / den;
+}
+
+inline float cubicSoftClip(float x) noexcept {
+  x = std::clamp(x, -1.0f, 1.0f);
+  return 1.5f * (x - x * x * x * (1.0f / 3.0f));
+}
+
+inline float hardClip(float x) noexcept { return std::clamp(x, -1.0f, 1.0f); }
+
+inline float shape(Shape s, float x) noexcept {
+  switch (s) {
+  case Shape::CubicSoft:
+    return cubicSoftClip(x);
+  case Shape::Hard:
+    return hardClip(x);
+  case Shape::RationalTanh:
+  default:
+    return rationalTanh(x);
+  }
+}
+
+//==============================================================================
+// First antiderivatives, used by ADAA1. Kept in double: the difference
+// quotient subtracts two nearly equal values.
+
+inline double tanhAntiderivative(double x) noexcept {
+  // log(cosh(x)) written so that it does not overflow for large |x|
+  const double ax = std::abs(x);
+  return ax + std::log1p(std::exp(-2.0 * ax)) - 0.69314718055994531;
+}
+
+inline double cubicSoftClipAntiderivative(double x) noexcept {
+  const double ax = std::abs(x);
+  if (ax <= 1.0) {
+    const double x2 = x * x;
+    return 1.5 * (0.5 * x2 - x2 * x2 * (1.0 / 12.0));
+  }
+  return ax - 0.375;
+}
+
+inline double hardClipAntiderivative(double x) noexcept {
+  const double ax = std::abs(x);
+  return ax <= 1.0 ? 0.5 * x * x : ax - 0.5;
+}
+
+inline double antiderivative(Shape s, double x) noexcept {
+  switch (s) {
+  case Shape::CubicSoft:
+    return cubicSoftClipAntiderivative(x);
+  case Shape::Hard:
+    return hardClipAntiderivative(x);
+  case Shape::RationalTanh:
+  default:
+    return tanhAntiderivative(x);
+  }
+}
+
+//==============================================================================
+// Block processing: data[i] = outputGain * shape(inputGain * data[i])
+
+namespace detail {
+#if defined(ARCH_EXT_SSE)
+inline __m128 rationalTanh4(__m128 x) noexcept {
+  x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-kTanhClamp)),
+                 _mm_set1_ps(kTanhClamp));
+  const __m128 x2 = _mm_mul_ps(x, x);
+
+  __m128 num = _mm_add_ps(x2, _mm_set1_ps(378.0f));
+  num = _mm_add_ps(_mm_mul_ps(num, x2), _mm_set1_ps(17325.0f));
+  num = _mm_add_ps(_mm_mul_ps(num, x2), _mm_set1_ps(135135.0f));
+  num = _mm_mul_ps(num, x);
+
+  __m128 den = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(28.0f)),
+                          _mm_set1_ps(3150.0f));
+  den = _mm_add_ps(_mm_mul_ps(den, x2), _mm_set1_ps(62370.0f));
+  den = _mm_add_ps(_mm_mul_ps(den, x2), _mm_set1_ps(135135.0f));
+
+  return _mm_div_ps(num, den);
+}
+
+inline __m128 cubicSoftClip4(__m128 x) noexcept {
+  x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+  const __m128 x3 = _mm_mul_ps(_mm_mul_ps(x, x), x);
+  return _mm_mul_ps(_mm_set1_ps(1.5f),
+                    _mm_sub_ps(x, _mm_mul_ps(x3, _mm_set1_ps(1.0f / 3.0f))));
+}
+
+inline __m128 hardClip4(__m128 x) noexcept {
+  return _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+}
+
+template <__m128 (*Curve)(__m128) noexcept, float (*ScalarCurve)(float) noexcept>
+inline void processBlock(float *data, int numSamples, float inputGain,
+                         float outputGain) noexcept {
+  const __m128 gIn = _mm_set1_ps(inputGain);
+  const __m128 gOut = _mm_set1_ps(outputGain);
+
+  int i = 0;
+  for (; i + 4 <= numSamples; i += 4) {
+    const __m128 x = _mm_mul_ps(_mm_loadu_ps(data + i), gIn);
+    _mm_storeu_ps(data + i, _mm_mul_ps(Curve(x), gOut));
+  }
+
+  for (; i < numSamples; ++i)
+    data[i] = outputGain * ScalarCurve(inputGain * data[i]);
+}
+#else
+template <float (*ScalarCurve)(float) noexcept>
+inline void processBlock(float *data, int numSamples, float inputGain,
+                         float outputGain) noexcept {
+  for (int i = 0; i < numSamples; ++i)
+    data[i] = outputGain * ScalarCurve(inputGain * data[i]);
+}
+#endif
+} // namespace detail
+
+inline void process(Shape s, float *data, int numSamples,
+                    float inputGain = 1.0f, float outputGain = 1.0f) noexcept {
+#if defined(ARCH_EXT_SSE)
+  switch (s) {
+  case Shape::CubicSoft:
+    detail::processBlock<detail::cubicSoftClip4, cubicSoftClip>(
+        data, numSamples, inputGain, outputGain);
+    break;
+  case Shape::Hard:
+    detail::processBlock<detail::hardClip4, hardClip>(data, numSamples,
+                                                      inputGain, outputGain);
+    break;
+  case Shape::RationalTanh:
+  default:
+    detail::processBlock<detail::rationalTanh4, rationalTanh>(
+        data, numSamples, inputGain, outputGain);
+    break;
+  }
+#else
+  switch (s) {
+  case Shape::CubicSoft:
+    detail::processBlock<cubicSoftClip>(data, numSamples, inputGain,
+                                        outputGain);
+    break;
+  case Shape::Hard:
+    detail::processBlock<hardClip>(data, numSamples, inputGain, outputGain);
+    break;
+  case Shape::RationalTanh:
+  default:
+    detail::processBlock<rationalTanh>(data, numSamples, inputGain,
+                                       outputGain);
+    break;
+  }
+#endif
+}
+
+/**
+ * Soft clipper with a ceiling: y = threshold * shape(x / threshold)
+ */
+inline void clip(Shape s, float *data, int numSamples,
+                 float threshold) noexcept {
+  process(s, data, numSamples, 1.0f / threshold, threshold);
+}
+
+//==============================================================================
+/**
+ * First-order antiderivative anti-aliasing (ADAA) around one of the shapes.
+ * y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1])
+ * Adds half a sample of delay. One instance per channel.
+ */
+class ADAA1 {
+public:
+  void setShape(Shape newShape) {
+    if (newShape != shapeType) {
+      shapeType = newShape;
+      reset();
+    }
+  }
+
+  Shape getShape() const { return shapeType; }
+
+  void reset() {
+    x1 = 0.0;
+    ad1 = antiderivative(shapeType, 0.0);
+  }
+
+  inline float processSample(float x) noexcept {
+    const double xd = (double)x;
+    const double ad = antiderivative(shapeType, xd);
+    const double diff = xd - x1;
+
+    // Ill-conditioned quotient: fall back to the curve at the midpoint
+    const float y = std::abs(diff) < kIllConditioned
+                        ? shape(shapeType, (float)(0.5 * (xd + x1)))
+                        : (float)((ad - ad1) / diff);
+
+    x1 = xd;
+    ad1 = ad;
+    return y;
+  }
+
+  void process(float *data, int numSamples, float inputGain = 1.0f,
+               float outputGain = 1.0f) noexcept {
+    for (int i = 0; i < numSamples; ++i)
+      data[i] = outputGain * processSample(inputGain * data[i]);
+  }
+
+private:
+  static constexpr double kIllConditioned = 1.0e-5;
+
+  Shape shapeType{Shape::RationalTanh};
+  double x1 = 0.0;
+  double ad1 = antiderivative(Shape::RationalTanh, 0.0);
+};
+
+} // namespace waveshapers
@@ -0,0 +1,213 @@
+#include "WeightKernels.h"
+#include "architecture.hpp"
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstring>
+
+#if defined(ARCH_X86_64)
+#include <immintrin.h>
+
+// Compiled for AVX2 whatever the build targets, and only called after the
+// CPU has been checked. MSVC accepts the intrinsics without a flag.
+#if defined(__GNUC__) || defined(__clang__)
+#define WEIGHT_KERNELS_AVX2 __attribute__((target("avx2,fma,f16c")))
+#else
+#define WEIGHT_KERNELS_AVX2
+#endif
+#define WEIGHT_KERNELS_HAVE_AVX2 1
+#endif
+
+namespace weightkernels {
+
+uint16_t toHalf(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const auto sign = (uint16_t)((bits >> 16) & 0x8000u);
+  const float magnitude = std::abs(value);
+
+  // Anything that would round past the largest finite half
+  if (!(magnitude < 65520.0f))
+    return (uint16_t)(sign | 0x7bffu);
+
+  // Below the smallest normal half the steps are a fixed 2^-24
+  if (magnitude < 6.103515625e-05f)
+    return (uint16_t)(sign | (uint16_t)std::nearbyint(magnitude * 16777216.0f));
+
+  // Keep 10 of the 23 mantissa bits, rounding to nearest even, and rebias
+  // the exponent from 127 to 15
+  std::memcpy(&bits, &magnitude, sizeof(bits));
+  bits += 0x00000fffu + ((bits >> 13) & 1u);
+  return (uint16_t)(sign | ((bits >> 13) - (112u << 10)));
+}
+
+float fromHalf(uint16_t half) {
+  const uint32_t exponent = (half >> 10) & 0x1fu;
+  const uint32_t mantissa = half & 0x3ffu;
+
+  float magnitude;
+  if (exponent == 0) {
+    magnitude = (float)mantissa / 16777216.0f;
+  } else {
+    const uint32_t bits = exponent == 0x1fu
+                              ? 0x7f800000u | (mantissa << 13)
+                              : ((exponent + 112u) << 23) | (mantissa << 13);
+    std::memcpy(&magnitude, &bits, sizeof(magnitude));
+  }
+
+  return (half & 0x8000u) != 0 ? -magnitude : magnitude;
+}
+
+namespace {
+inline float widen(uint16_t w) { return fromHalf(w); }
+inline float widen(int8_t w) { return (float)w; }
+
+template <typename Weight>
+void productScalar(const Weight *w, const float *scales, int rows, int cols,
+                   const float *x, int xStride, float *y, int yStride,
+                   int n) {
+  const int stride = getPaddedRows(rows);
+  for (int t = 0; t < n; ++t, x += xStride, y += yStride) {
+    for (int i = 0; i < rows; ++i) {
+      float sum = 0.0f;
+      for (int j = 0; j < cols; ++j)
+        sum += widen(w[(size_t)j * stride + i]) * x[j];
+      y[i] = scales != nullptr ? scales[i] * sum : sum;
+    }
+  }
+}
+
+void halfProductScalar(const uint16_t *w, int rows, int cols, const float *x,
+                       int xStride, float *y, int yStride, int n) {
+  productScalar(w, nullptr, rows, cols, x, xStride, y, yStride, n);
+}
+
+void int8ProductScalar(const int8_t *w, const float *scales, int rows,
+                       int cols, const float *x, int xStride, float *y,
+                       int yStride, int n) {
+  productScalar(w, scales, rows, cols, x, xStride, y, yStride, n);
+}
+
+#if WEIGHT_KERNELS_HAVE_AVX2
+// Eight weights, widened to float
+WEIGHT_KERNELS_AVX2 inline __m256 load8(const uint16_t *w) {
+  return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)w));
+}
+WEIGHT_KERNELS_AVX2 inline __m256 load8(const int8_t *w) {
+  return _mm256_cvtepi32_ps(
+      _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)w)));
+}
+
+// Writes the first numRows of eight sums, scaled if there are scales
+WEIGHT_KERNELS_AVX2 inline void storeRows(__m256 sums, const float *scales,
+                                          float *out, int numRows) {
+  if (scales != nullptr)
+    sums = _mm256_mul_ps(sums, _mm256_loadu_ps(scales));
+
+  if (numRows >= 8) {
+    _mm256_storeu_ps(out, sums);
+    return;
+  }
+
+  alignas(32) float lanes[8];
+  _mm256_store_ps(lanes, sums);
+  for (int r = 0; r < numRows; ++r)
+    out[r] = lanes[r];
+}
+
+// numBlocks blocks of eight rows, from row i, for numColumns input
+// columns: every weight is widened once and multiplied by each column's
+// broadcast input. 2 x 6 accumulators and two weight vectors fit the
+// sixteen AVX registers.
+template <int numBlocks, int numColumns, typename Weight>
+WEIGHT_KERNELS_AVX2 inline void
+productTileAvx2(const Weight *w, const float *scales, int rows, int cols,
+                int i, const float *x, int xStride, float *y, int yStride) {
+  const int stride = getPaddedRows(rows);
+
+  __m256 sums[numBlocks][numColumns];
+  for (int b = 0; b < numBlocks; ++b)
+    for (int c = 0; c < numColumns; ++c)
+      sums[b][c] = _mm256_setzero_ps();
+
+  for (int j = 0; j < cols; ++j) {
+    __m256 weights[numBlocks];
+    for (int b = 0; b < numBlocks; ++b)
+      weights[b] = load8(w + (size_t)j * stride + i + 8 * b);
+
+    for (int c = 0; c < numColumns; ++c) {
+      const __m256 input = _mm256_broadcast_ss(x + (size_t)c * xStride + j);
+      for (int b = 0; b < numBlocks; ++b)
+        sums[b][c] = _mm256_fmadd_ps(weights[b], input, sums[b][c]);
+    }
+  }
+
+  for (int b = 0; b < numBlocks; ++b)
+    for (int c = 0; c < numColumns; ++c)
+      storeRows(sums[b][c],
+                scales != nullptr ? scales + i + 8 * b : nullptr,
+                y + (size_t)c * yStride + i + 8 * b, rows - i - 8 * b);
+}
+
+template <int numColumns, typename Weight>
+WEIGHT_KERNELS_AVX2 inline void
+productColumnsAvx2(const Weight *w, const float *scales, int rows, int cols,
+                   const float *x, int xStride, float *y, int yStride) {
+  int i = 0;
+  for (; i + 8 < rows; i += 16)
+    productTileAvx2<2, numColumns>(w, scales, rows, cols, i, x, xStride, y,
+                                   yStride);
+  if (i < rows)
+    productTileAvx2<1, numColumns>(w, scales, rows, cols, i, x, xStride, y,
+                                   yStride);
+}
+
+template <typename Weight>
+WEIGHT_KERNELS_AVX2 void productAvx2(const Weight *w, const float *scales,
+                                     int rows, int cols, const float *x,
+                                     int xStride, float *y, int yStride,
+                                     int n) {
+  int t = 0;
+  for (; t + 6 <= n; t += 6)
+    productColumnsAvx2<6>(w, scales, rows, cols, x + (size_t)t * xStride,
+                          xStride, y + (size_t)t * yStride, yStride);
+  for (; t < n; ++t)
+    productColumnsAvx2<1>(w, scales, rows, cols, x + (size_t)t * xStride,
+                          xStride, y + (size_t)t * yStride, yStride);
+}
+
+WEIGHT_KERNELS_AVX2 void halfProductAvx2(const uint16_t *w, int rows,
+                                         int cols, const float *x,
+                                         int xStride, float *y, int yStride,
+                                         int n) {
+  productAvx2(w, nullptr, rows, cols, x, xStride, y, yStride, n);
+}
+
+WEIGHT_KERNELS_AVX2 void int8ProductAvx2(const int8_t *w, const float *scales,
+                                         int rows, int cols, const float *x,
+                                         int xStride, float *y, int yStride,
+                                         int n) {
+  productAvx2(w, scales, rows, cols, x, xStride, y, yStride, n);
+}
+#endif
+
+const Kernels scalarKernels{halfProductScalar, int8ProductScalar, "scalar"};
+
+const Kernels &pick() {
+#if WEIGHT_KERNELS_HAVE_AVX2
+  // Every CPU with AVX2 and FMA also has F16C
+  static const Kernels avx2Kernels{halfProductAvx2, int8ProductAvx2, "AVX2"};
+  if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+    return avx2Kernels;
+#endif
+  return scalarKernels;
+}
+} // namespace
+
+const Kernels &get() {
+  static const Kernels &kernels = pick();
+  return kernels;
+}
+
+const Kernels &getScalar() { return scalarKernels; }
+
+} // namespace weightkernels
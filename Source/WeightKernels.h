@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Weight Kernels
+ * Matrix products over weights kept in reduced precision, for
+ * SharedWaveNet's float16 and int8 storage.
+ *
+ * Matrices are column-major, each column padded with zeros to a multiple
+ * of eight rows (getPaddedRows), so that eight output channels' weights
+ * for one input are one aligned-size load. Each output is the dot product
+ * of a row with an input column, accumulated eight rows at a time: one
+ * widened weight vector times one broadcast input, for several input
+ * columns at once. Int8 rows carry one scale each (per output channel),
+ * applied to the finished sums.
+ *
+ * On x86 CPUs with AVX2, FMA and F16C the products run in AVX registers
+ * (F16C converts halves, AVX2 widens bytes), six input columns at a time
+ * so that each weight is widened once per six outputs. The choice is
+ * made once, on first use; elsewhere a scalar loop computes the same sums.
+ */
+namespace weightkernels {
+
+// Rows a column is stored in: `rows` rounded up to a multiple of eight
+inline int getPaddedRows(int rows) { return (rows + 7) & ~7; }
+
+// For each of n columns t: y_t[i] = sum_j w[j * getPaddedRows(rows) + i] *
+// x_t[j], for i in [0, rows), where x_t = x + t * xStride and y_t = y +
+// t * yStride
+using HalfProduct = void (*)(const uint16_t *w, int rows, int cols,
+                             const float *x, int xStride, float *y,
+                             int yStride, int n);
+
+// The same, with y_t[i] scaled by scales[i]; scales holds
+// getPaddedRows(rows) values
+using Int8Product = void (*)(const int8_t *w, const float *scales, int rows,
+                             int cols, const float *x, int xStride, float *y,
+                             int yStride, int n);
+
+struct Kernels {
+  HalfProduct half;
+  Int8Product int8;
+  const char *name;
+};
+
+// The fastest kernels this CPU runs
+const Kernels &get();
+
+// The plain loops, for comparison
+const Kernels &getScalar();
+
+// IEEE 754 binary16, round to nearest even; saturates at the largest half
+uint16_t toHalf(float value);
+float fromHalf(uint16_t half);
+
+} // namespace weightkernels
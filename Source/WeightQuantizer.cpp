@@ -0,0 +1,226 @@
+#include "WeightQuantizer.h"
+#include "SharedWaveNet.h"
+#include "WeightKernels.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+// Where each matrix row (one output channel's weights) sits in NAM's flat
+// weight vector. Biases, states and scalars are stepped over: they stay
+// float, as in SharedWaveNet.
+class RowFinder {
+public:
+  struct Row {
+    size_t offset;
+    size_t length;
+  };
+
+  // A matrix NAM stores row by row
+  void matrix(int rows, int cols) {
+    for (int i = 0; i < rows; ++i) {
+      found.push_back({position, (size_t)cols});
+      position += (size_t)cols;
+    }
+  }
+
+  void skip(int count) { position += (size_t)count; }
+
+  // The rows of a model of an architecture NAM builds, or none if its
+  // config is unknown or does not account for exactly its weights
+  static std::vector<Row> find(const nam::dspData &config) {
+    RowFinder finder;
+    try {
+      finder.walk(config);
+    } catch (nlohmann::json::exception &) {
+      return {};
+    }
+    if (finder.position != config.weights.size())
+      return {};
+    return std::move(finder.found);
+  }
+
+private:
+  void walk(const nam::dspData &config) {
+    const auto &json = config.config;
+    const auto &architecture = config.architecture;
+
+    if (architecture == "Linear") {
+      matrix(1, json.at("receptive_field").get<int>());
+      skip(json.at("bias").get<bool>() ? 1 : 0);
+    } else if (architecture == "ConvNet") {
+      // Kernel size 2; a bias, or a batch norm's mean, variance, weight,
+      // bias and epsilon; then a head of one output channel
+      const int channels = json.at("channels").get<int>();
+      const bool batchnorm = json.at("batchnorm").get<bool>();
+      const auto &dilations = json.at("dilations");
+      for (size_t i = 0; i < dilations.size(); ++i) {
+        matrix(channels, 2 * (i == 0 ? 1 : channels));
+        skip(batchnorm ? 4 * channels + 1 : channels);
+      }
+      matrix(1, channels);
+      skip(1);
+    } else if (architecture == "LSTM") {
+      // Per cell the four gates over [input, hidden], their bias and the
+      // initial hidden and cell states; then a head of one output channel
+      const int hidden = json.at("hidden_size").get<int>();
+      const int numLayers = json.at("num_layers").get<int>();
+      for (int i = 0; i < numLayers; ++i) {
+        const int input = i == 0 ? json.at("input_size").get<int>() : hidden;
+        matrix(4 * hidden, input + hidden);
+        skip(4 * hidden + 2 * hidden);
+      }
+      matrix(1, hidden);
+      skip(1);
+    } else if (architecture == "WaveNet") {
+      // SharedWaveNet's order (see Weights::parse), for the configurations
+      // it leaves to NAM
+      for (const auto &array : json.at("layers")) {
+        const int channels = array.at("channels").get<int>();
+        const int gatedChannels =
+            array.at("gated").get<bool>() ? 2 * channels : channels;
+        const int headSize = array.at("head_size").get<int>();
+
+        matrix(channels, array.at("input_size").get<int>());
+        for (size_t i = 0; i < array.at("dilations").size(); ++i) {
+          matrix(gatedChannels, channels * array.at("kernel_size").get<int>());
+          skip(gatedChannels);
+          matrix(gatedChannels, array.at("condition_size").get<int>());
+          matrix(channels, channels);
+          skip(channels);
+        }
+        matrix(headSize, channels);
+        skip(array.at("head_bias").get<bool>() ? headSize : 0);
+      }
+      skip(1); // head scale
+    } else {
+      position = std::numeric_limits<size_t>::max();
+    }
+  }
+
+  size_t position{0};
+  std::vector<Row> found;
+};
+} // namespace
+
+void WeightQuantizer::quantize(nam::dspData &config, Precision precision) {
+  if (precision == Precision::Float32)
+    return;
+
+  const auto rows = RowFinder::find(config);
+  if (rows.empty()) {
+    DBG("Weights left in float: unknown " + juce::String(config.architecture) +
+        " layout");
+    return;
+  }
+
+  for (const auto &row : rows) {
+    float *weights = config.weights.data() + row.offset;
+
+    if (precision == Precision::Float16) {
+      for (size_t i = 0; i < row.length; ++i)
+        weights[i] = roundToHalf(weights[i]);
+      continue;
+    }
+
+    // Int8: the row scaled so its largest weight is 127
+    float largest = 0.0f;
+    for (size_t i = 0; i < row.length; ++i)
+      largest = juce::jmax(largest, std::abs(weights[i]));
+
+    if (largest == 0.0f)
+      continue;
+
+    const float scale = largest / 127.0f;
+    for (size_t i = 0; i < row.length; ++i)
+      weights[i] = std::nearbyint(weights[i] / scale) * scale;
+  }
+}
+
+float WeightQuantizer::roundToHalf(float value) {
+  return weightkernels::fromHalf(weightkernels::toHalf(value));
+}
+
+WeightQuantizer::Report WeightQuantizer::measure(const nam::dspData &config,
+                                                 Precision precision) {
+  Report report;
+  report.numWeights = (int)config.weights.size();
+
+  // A WaveNet runs from SharedWaveNet's reduced storage; anything else is
+  // rounded for NeuralAmpModelerCore
+  std::unique_ptr<nam::DSP> reference, quantized;
+  try {
+    reference = std::make_unique<SharedWaveNet>(
+        SharedWaveNet::Weights::parse(config, Precision::Float32));
+    quantized = std::make_unique<SharedWaveNet>(
+        SharedWaveNet::Weights::parse(config, precision));
+  } catch (std::runtime_error &) {
+    nam::dspData referenceConfig = config;
+    nam::dspData quantizedConfig = config;
+    quantize(quantizedConfig, precision);
+
+    reference = nam::get_dsp(referenceConfig);
+    quantized = nam::get_dsp(quantizedConfig);
+  }
+
+  reference->prewarm();
+  quantized->prewarm();
+
+  // Two seconds at the model's own rate: a rising sweep under decaying
+  // noise bursts, at guitar DI levels, from a fixed seed
+  const double sampleRate =
+      config.expected_sample_rate > 0.0 ? config.expected_sample_rate : 48000.0;
+  const int numSamples = (int)(2.0 * sampleRate);
+  const int blockSize = 256;
+
+  juce::Random random(0x4d415952);
+  std::vector<float> input((size_t)blockSize);
+  std::vector<float> referenceOut((size_t)blockSize);
+  std::vector<float> quantizedOut((size_t)blockSize);
+
+  double phase = 0.0;
+  double signalEnergy = 0.0;
+  double errorEnergy = 0.0;
+
+  for (int start = 0; start < numSamples; start += blockSize) {
+    const int n = juce::jmin(blockSize, numSamples - start);
+
+    for (int i = 0; i < n; ++i) {
+      const double t = (start + i) / sampleRate;
+      const double frequency = 80.0 * std::pow(2.0, 3.0 * t); // 3 octaves
+      phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+      const double burst = std::exp(-8.0 * std::fmod(t, 0.25));
+      input[(size_t)i] =
+          (float)(0.2 * std::sin(phase) +
+                  0.3 * burst * (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    reference->process(input.data(), referenceOut.data(), n);
+    reference->finalize_(n);
+    quantized->process(input.data(), quantizedOut.data(), n);
+    quantized->finalize_(n);
+
+    for (int i = 0; i < n; ++i) {
+      const double y = referenceOut[(size_t)i];
+      const double e = quantizedOut[(size_t)i] - y;
+      signalEnergy += y * y;
+      errorEnergy += e * e;
+    }
+  }
+
+  report.esr = signalEnergy > 0.0 ? errorEnergy / signalEnergy : 0.0;
+  report.nullDb = juce::Decibels::gainToDecibels(std::sqrt(report.esr), -200.0);
+  return report;
+}
+
+juce::String WeightQuantizer::getName(Precision precision) {
+  switch (precision) {
+  case Precision::Float16:
+    return "float16";
+  case Precision::Int8:
+    return "int8";
+  case Precision::Float32:
+  default:
+    return "float32";
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "../Modules/NeuralAmpModelerCore/NAM/dsp.h"
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * Weight Quantizer
+ * Reduced-precision amp model weights, chosen at build time with the
+ * WEIGHT_PRECISION CMake option (see ModelRegistry), and a measure of
+ * what they cost in accuracy.
+ *
+ * - Float16: each weight rounded to the nearest half float.
+ * - Int8: weights scaled per output channel so the largest maps to 127.
+ *
+ * WaveNets are stored at the precision itself: SharedWaveNet keeps the
+ * reduced matrices and runs them on WeightKernels, in a half or a quarter
+ * of the memory. Other architectures are built by NeuralAmpModelerCore,
+ * which keeps its layers in float; quantize() rounds their matrices'
+ * weights in place, with one int8 scale per row as SharedWaveNet has, so
+ * they sound as they would in low precision but use the same memory.
+ */
+class WeightQuantizer {
+public:
+  enum class Precision { Float32 = 0, Float16, Int8 };
+
+  // Rounds a model's matrix weights in place to what `precision` can
+  // represent; biases and states stay float. Leaves the weights of a
+  // layout it does not know alone.
+  static void quantize(nam::dspData &config, Precision precision);
+
+  static float roundToHalf(float value);
+
+  struct Report {
+    double esr{0.0};    // error-to-signal ratio, sum(e^2) / sum(y^2)
+    double nullDb{0.0}; // the same as a level: residual vs. reference, dB
+    int numWeights{0};
+  };
+
+  /**
+   * Offline: runs a fixed test signal through the model built from
+   * `config` in float and at `precision`, the way the registry would build
+   * each, and compares the outputs. Message thread; builds two models, so
+   * it takes a moment.
+   */
+  static Report measure(const nam::dspData &config, Precision precision);
+
+  static juce::String getName(Precision precision);
+};
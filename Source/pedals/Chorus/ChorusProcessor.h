@@ -25,11 +25,11 @@ public:
     // Initialize JUCE Chorus with ProcessSpec
     chorus.prepare(spec);
 
-    // Set initial parameters immediately after prepare
-    updateChorusParameters();
-
     // Mark as initialized
     initialized = true;
+
+    // Set initial parameters immediately after prepare
+    updateChorusParameters();
   }
 
   void reset() {
@@ -44,7 +44,10 @@ public:
    * 1.5 = typical vintage chorus rate
    * 2.5 = fast, pronounced modulation
    */
-  void setRate(float rateHz) { currentRate = juce::jlimit(0.5f, 2.5f, rateHz); }
+  void setRate(float rateHz) {
+    currentRate = juce::jlimit(0.5f, 2.5f, rateHz);
+    updateChorusParameters();
+  }
 
   /**
    * Set the chorus depth (0.0 to 0.2)
@@ -52,7 +55,10 @@ public:
    * 0.1 = moderate effect
    * 0.2 = pronounced detuning
    */
-  void setDepth(float depth) { currentDepth = juce::jlimit(0.0f, 0.2f, depth); }
+  void setDepth(float depth) {
+    currentDepth = juce::jlimit(0.0f, 0.2f, depth);
+    updateChorusParameters();
+  }
 
   /**
    * Set the mix/wet-dry balance (0.0 to 100.0)
@@ -60,7 +66,10 @@ public:
    * 50 = 50% wet / 50% dry (balanced)
    * 100 = 100% wet (full chorus)
    */
-  void setMix(float mix) { currentMix = juce::jlimit(0.0f, 100.0f, mix); }
+  void setMix(float mix) {
+    currentMix = juce::jlimit(0.0f, 100.0f, mix);
+    updateChorusParameters();
+  }
 
   /**
    * Process audio buffer through chorus
@@ -71,9 +80,7 @@ public:
       return;
     }
 
-    // Rebuild parameters every block from current setter values
-    updateChorusParameters();
-
+    // Parameters are pushed by the setters, only when they change
     // Create AudioBlock from buffer
     juce::dsp::AudioBlock<float> block(buffer);
 
@@ -2,6 +2,9 @@
 #include <JuceHeader.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include "../../BiquadCascade.h"
+#include "../../Waveshapers.h"
+
 /**
  * Clean Boost Processor
  * Transparent boost pedal with tone shaping and soft clipping capabilities.
@@ -9,7 +12,7 @@
  * Algorithm:
  * 1. High-pass filter (30Hz, 2nd order)
  * 2. Gain stage (0dB to +20dB)
- * 3. Soft clipping (tanh)
+ * 3. Soft clipping (rational tanh, optionally anti-aliased)
  * 4. Presence boost (2kHz, +2dB, Q=1.5)
  * 5. High-frequency roll-off (10kHz, 1st order)
  * 6. Output limiter (+-0.95)
@@ -37,32 +40,27 @@ public:
     auto lpfCoeffs = juce::dsp::IIR::Coefficients<float>::makeFirstOrderLowPass(
         sampleRate, 10000.0f);
 
-    for (int ch = 0; ch < 2; ++ch) {
-      // Initialize filters
-      highPassFilter[ch].prepare(spec);
-      highPassFilter[ch].coefficients = hpfCoeffs;
-
-      presenceFilter[ch].prepare(spec);
-      presenceFilter[ch].coefficients = presenceCoeffs;
+    highPassFilter.setSection(0, toBiquad(*hpfCoeffs));
+    postFilter.setSection(0, toBiquad(*presenceCoeffs));
+    postFilter.setSection(1, toBiquad(*lpfCoeffs));
 
-      lowPassFilter[ch].prepare(spec);
-      lowPassFilter[ch].coefficients = lpfCoeffs;
-
-      // Reset state
-      highPassFilter[ch].reset();
-      presenceFilter[ch].reset();
-      lowPassFilter[ch].reset();
-    }
+    reset();
   }
 
   void reset() {
     for (int ch = 0; ch < 2; ++ch) {
-      highPassFilter[ch].reset();
-      presenceFilter[ch].reset();
-      lowPassFilter[ch].reset();
+      BiquadCascade<1>::reset(highPassState[ch]);
+      BiquadCascade<2>::reset(postState[ch]);
+      softClipper[ch].reset();
     }
   }
 
+  /**
+   * Enable first-order antiderivative anti-aliasing on the soft clipper.
+   * Costs more per sample; meant for offline / high quality rendering.
+   */
+  void setAntiAliasing(bool shouldAntiAlias) { antiAliasing = shouldAntiAlias; }
+
   /**
    * Set the boost amount (0.0 to 10.0)
    * Maps to 0 dB to +8 dB of gain
@@ -74,45 +72,56 @@ public:
   }
 
   void process(juce::AudioBuffer<float> &buffer) {
+    const int numSamples = buffer.getNumSamples();
+
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
       auto *channelData = buffer.getWritePointer(ch);
       // Use channel 0 state for mono, otherwise match channel index (up to 2)
       int idx = (ch < 2) ? ch : 0;
 
-      for (int i = 0; i < buffer.getNumSamples(); ++i) {
-        float sample = channelData[i];
-
-        // 1. Pre-Filtering: High-pass (30 Hz)
-        sample = highPassFilter[idx].processSample(sample);
-
-        // 2. Gain Stage
-        sample *= currentGain;
-
-        // 3. Soft Clipping (Waveshaper)
-        // tanh provides tube-like saturation curve
-        sample = std::tanh(sample);
-
-        // 4. Post-Filtering: Presence Boost (2 kHz)
-        sample = presenceFilter[idx].processSample(sample);
-
-        // 5. Post-Filtering: HF Roll-off (10 kHz)
-        sample = lowPassFilter[idx].processSample(sample);
-
-        // 6. Safety Limiter
-        // Hard clip at +/- 0.95 to prevent digital overs
-        sample = juce::jlimit(-0.95f, 0.95f, sample);
-
-        channelData[i] = sample;
-      }
+      // 1. Pre-Filtering: High-pass (30 Hz)
+      highPassFilter.process(channelData, channelData, numSamples,
+                             highPassState[idx]);
+
+      // 2. Gain Stage + 3. Soft Clipping (Waveshaper)
+      // tanh provides tube-like saturation curve
+      if (antiAliasing)
+        softClipper[idx].process(channelData, numSamples, currentGain);
+      else
+        waveshapers::process(waveshapers::Shape::RationalTanh, channelData,
+                             numSamples, currentGain);
+
+      // 4. Presence Boost (2 kHz) + 5. HF Roll-off (10 kHz), in one pass
+      postFilter.process(channelData, channelData, numSamples,
+                         postState[idx]);
+
+      // 6. Safety Limiter
+      // Hard clip at +/- 0.95 to prevent digital overs
+      juce::FloatVectorOperations::clip(channelData, channelData, -0.95f,
+                                        0.95f, numSamples);
     }
   }
 
 private:
+  // JUCE's coefficients are already normalised: b0, b1, b2, a1, a2 for a
+  // biquad and b0, b1, a1 for a first-order filter
+  static BiquadCoefficients
+  toBiquad(const juce::dsp::IIR::Coefficients<float> &coefficients) {
+    const float *c = coefficients.getRawCoefficients();
+    if (coefficients.getFilterOrder() == 1)
+      return {c[0], c[1], 0.0f, c[2], 0.0f};
+    return {c[0], c[1], c[2], c[3], c[4]};
+  }
+
   double sampleRate = 44100.0;
   float currentGain = 1.0f;
+  bool antiAliasing = false;
+
+  // Filters shared by both channels; state per channel
+  BiquadCascade<1> highPassFilter;
+  BiquadCascade<2> postFilter; // presence, roll-off
+  BiquadCascade<1>::State highPassState[2];
+  BiquadCascade<2>::State postState[2];
 
-  // Stereo filters
-  juce::dsp::IIR::Filter<float> highPassFilter[2];
-  juce::dsp::IIR::Filter<float> presenceFilter[2];
-  juce::dsp::IIR::Filter<float> lowPassFilter[2];
+  waveshapers::ADAA1 softClipper[2];
 };
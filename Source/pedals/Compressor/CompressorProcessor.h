@@ -42,6 +42,8 @@ public:
    */
   void setAttack(float attackMs) {
     currentAttack = juce::jlimit(5.0f, 50.0f, attackMs);
+    for (int ch = 0; ch < 2; ++ch)
+      compressor[ch].setAttack(currentAttack);
   }
 
   /**
@@ -50,6 +52,8 @@ public:
    */
   void setSustain(float sustainMs) {
     currentRelease = juce::jlimit(50.0f, 500.0f, sustainMs);
+    for (int ch = 0; ch < 2; ++ch)
+      compressor[ch].setRelease(currentRelease);
   }
 
   /**
@@ -65,11 +69,8 @@ public:
    */
   void process(juce::AudioBuffer<float> &buffer) {
     // ========== COMPRESSION STAGE ==========
+    // Attack/release are pushed by the setters, only when they change
     for (int ch = 0; ch < buffer.getNumChannels() && ch < 2; ++ch) {
-      // Update dynamic parameters
-      compressor[ch].setAttack(currentAttack);
-      compressor[ch].setRelease(currentRelease);
-
       // Create a mono audio block for this channel
       juce::dsp::AudioBlock<float> block(buffer);
       auto monoBlock = block.getSingleChannelBlock(ch);
@@ -35,11 +35,11 @@ public:
       fRec0[i] = 0.0;
     }
 
-    // Clear delay buffer
+    // The delay buffer is not cleared: reads reaching back past the first
+    // write after a reset return silence instead (see readDelay). Clearing
+    // 2 MB here would cost too much on the audio thread, where the
+    // processor restarts its standby chain.
     IOTA = 0;
-    for (int i = 0; i < 262144; ++i) {
-      fVec0[i] = 0.0;
-    }
 
     // Clear recursive filter states
     for (int i = 0; i < 3; ++i) {
@@ -73,6 +73,17 @@ public:
    */
   void setMix(float mix) { currentMix = juce::jlimit(0.0f, 1.2f, mix); }
 
+  /**
+   * Time for the repeats to decay below -80 dB, used for the plugin's
+   * reported tail length
+   */
+  static double getTailLengthSeconds(float timeMs, float feedback) {
+    const double fb = juce::jlimit(0.0, 0.999, (double)feedback);
+    const double repeats =
+        fb > 1.0e-4 ? std::ceil(std::log(1.0e-4) / std::log(fb)) : 1.0;
+    return juce::jmin(repeats + 1.0, 1000.0) * timeMs / 1000.0;
+  }
+
   /**
    * Process audio buffer through delay
    */
@@ -119,8 +130,9 @@ private:
   double fRec4[2];   // Delay time ramping progress
   double fRec5[2];   // Target delay time (new)
   double fRec6[2];   // Current delay time (old)
-  int IOTA;          // Circular buffer index
+  int IOTA;          // Samples written since reset(), kept below 2 x size
   double fVec0[262144];  // 262144 samples = ~6 seconds at 44.1kHz
+  static constexpr int delaySize = 262144;
   double fRec2[3];   // Highpass filter state
   double fRec1[3];   // Lowpass filter state
   double fRec0[2];   // Output filter state
@@ -136,6 +148,16 @@ private:
     fConst4 = (0.0 - fConst3);
   }
 
+  /**
+   * Delay line tap; silence where the write position has not been since
+   * reset()
+   */
+  double readDelay(double delaySamples) const {
+    const int offset =
+        int(std::min<double>(192000.0, std::max<double>(0.0, delaySamples)));
+    return IOTA >= offset ? fVec0[(IOTA - offset) & (delaySize - 1)] : 0.0;
+  }
+
   /**
    * Helper function for power calculations
    */
@@ -196,15 +218,8 @@ private:
 
       // Read from delay buffer with interpolation between old and new delay times
       fRec2[0] =
-          ((1.0 *
-            ((fRec4[0] *
-              fVec0[((IOTA - int(std::min<double>(
-                           192000.0, std::max<double>(0.0, fRec6[0]))))
-                     & 262143)]) +
-             ((1.0 - fRec4[0]) *
-              fVec0[((IOTA - int(std::min<double>(
-                           192000.0, std::max<double>(0.0, fRec5[0]))))
-                     & 262143)]))) -
+          ((1.0 * ((fRec4[0] * readDelay(fRec6[0])) +
+                   ((1.0 - fRec4[0]) * readDelay(fRec5[0])))) -
            (fSlow5 * ((fSlow9 * fRec2[2]) + (fSlow10 * fRec2[1]))));
 
       // Highpass filter
@@ -230,7 +245,11 @@ private:
       fRec4[1] = fRec4[0];
       fRec5[1] = fRec5[0];
       fRec6[1] = fRec6[0];
+      // Past one full lap everything readable has been written; step back
+      // a lap so the index never overflows
       IOTA = (IOTA + 1);
+      if (IOTA == 2 * delaySize)
+        IOTA = delaySize;
       fRec2[2] = fRec2[1];
       fRec2[1] = fRec2[0];
       fRec1[2] = fRec1[1];
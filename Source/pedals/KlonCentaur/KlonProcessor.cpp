@@ -37,8 +37,10 @@ void KlonProcessor::prepare(const juce::dsp::ProcessSpec &spec) {
 }
 
 void KlonProcessor::reset() {
+  // No reallocation here: reset() is called from the audio thread when the
+  // pedal is bypassed
   if (gainStageProc) {
-    gainStageProc->reset(sampleRate, maxBlockSize);
+    gainStageProc->resetState(sampleRate);
   }
   for (int ch = 0; ch < 2; ++ch) {
     inProc[ch]->prepare((float)sampleRate);
@@ -54,12 +56,28 @@ void KlonProcessor::setGain(float gain) {
   }
 }
 
+void KlonProcessor::setOversampling(bool shouldOversample) {
+  if (gainStageProc) {
+    gainStageProc->setOversampling(shouldOversample);
+  }
+}
+
+void KlonProcessor::setOversamplingOrder(int order) {
+  if (gainStageProc) {
+    gainStageProc->setOversamplingOrder(order);
+  }
+}
+
 void KlonProcessor::setTreble(float treble) {
   currentTreble = juce::jlimit(0.0f, 1.0f, treble);
+  for (int ch = 0; ch < 2; ++ch)
+    tone[ch]->setTreble(currentTreble);
 }
 
 void KlonProcessor::setLevel(float level) {
   currentLevel = juce::jlimit(0.0f, 1.0f, level);
+  for (int ch = 0; ch < 2; ++ch)
+    outProc[ch]->setLevel(currentLevel);
 }
 
 void KlonProcessor::process(juce::AudioBuffer<float> &buffer) {
@@ -85,7 +103,6 @@ void KlonProcessor::process(juce::AudioBuffer<float> &buffer) {
   for (int ch = 0; ch < buffer.getNumChannels() && ch < 2; ++ch) {
     auto *x = buffer.getWritePointer(ch);
 
-    tone[ch]->setTreble(currentTreble);
     tone[ch]->processBlock(x, numSamples);
 
     // Inverting amplifier + op-amp clipping (from original circuit)
@@ -93,7 +110,6 @@ void KlonProcessor::process(juce::AudioBuffer<float> &buffer) {
     juce::FloatVectorOperations::clip(x, x, -13.1f, 11.7f, numSamples);
 
     // ========== OUTPUT STAGE ==========
-    outProc[ch]->setLevel(currentLevel);
     outProc[ch]->processBlock(x, numSamples);
   }
 }
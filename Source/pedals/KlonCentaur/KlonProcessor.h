@@ -43,6 +43,19 @@ public:
    */
   void process(juce::AudioBuffer<float> &buffer);
 
+  /**
+   * 2x oversampling around the diode clipper, on by default. Off, it clips
+   * at the host rate: cheaper, with more aliasing at high gain. Audio
+   * thread, no allocation; follow with reset().
+   */
+  void setOversampling(bool shouldOversample);
+
+  /**
+   * Oversampling factor as a power of two: 1 = 2x (the default), 2 = 4x.
+   * Message thread; takes effect at the next prepare().
+   */
+  void setOversamplingOrder(int order);
+
   // Getters for current parameter values (for UI)
   float getCurrentGain() const;
   float getCurrentTreble() const;
@@ -8,15 +8,13 @@ namespace GainStageSpace
 class AmpStage : public chowdsp::IIRFilter<2>
 {
 public:
-    AmpStage()
-    {
-        r10bSmooth = 2000.0f;
-    }
+    AmpStage() {}
 
     void setGain (float gain)
     {
         float newR10b = (1.0f - gain) * 100000.0f + 2000.0f;
-        r10bSmooth.setTargetValue (jlimit (2000.0f, 102000.0f, newR10b));
+        r10b = jlimit (2000.0f, 102000.0f, newR10b);
+        calcCoefs (r10b);
     }
 
     void prepare (float sampleRate)
@@ -24,10 +22,7 @@ public:
         chowdsp::IIRFilter<2>::reset();
         fs = (float) sampleRate;
 
-        r10bSmooth.setCurrentAndTargetValue (r10bSmooth.getTargetValue());
-        r10bSmooth.reset (sampleRate, 0.05);
-
-        calcCoefs (r10bSmooth.getTargetValue());
+        calcCoefs (r10b);
     }
 
     void calcCoefs (float curR10b)
@@ -52,32 +47,15 @@ public:
         chowdsp::Bilinear::BilinearTransform<float, 3>::call (b, a, bs, as, K);
     }
 
-    void processBlock (float* block, const int numSamples) noexcept override
-    {
-        if (r10bSmooth.isSmoothing())
-        {
-            for (int n = 0; n < numSamples; ++n)
-            {
-                auto curR10b = r10bSmooth.getNextValue();
-                calcCoefs (curR10b);
-                block[n] = processSample (block[n]);
-
-                // block[n] += 4.5f * R12 / (R12 + R11 + curR10b); // bias
-            }
-        }
-        else
-        {
-            chowdsp::IIRFilter<2>::processBlock (block, numSamples);
-            // FloatVectorOperations::add (block, 4.5f * R12 / (R12 + R11 + r10bSmooth.getCurrentValue()), numSamples); // bias
-        }
-    }
-
 private:
     const float R11 = (float) 15e3;
     const float R12 = (float) 422e3;
 
     float fs = 44100.0f;
-    SmoothedValue<float, ValueSmoothingTypes::Multiplicative> r10bSmooth;
+
+    // Gain pot resistance. Coefficients are recomputed once per (sub-)block
+    // in setGain(); automation arrives as a block-rate ramp.
+    float r10b = 2000.0f;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AmpStage)
 };
@@ -6,23 +6,21 @@ template <typename T, typename Next>
 CustomDiodePairT<T, Next>::CustomDiodePairT (T Is, T Vt, Next& n) : Is (Is),
                                                                     Vt (Vt),
                                                                     oneOverVt ((T) 1 / Vt),
-                                                                    next (n)
+                                                                    next (n),
+                                                                    wrightOmegaLUT (getWrightOmegaLUT())
 {
     next.connectToParent (this);
     calcImpedance();
-
-    if (! lutIsInitialised)
-    {
-        wrightOmegaLUT.initialise ([] (double x) { return std::real (wrightomega (x)); }, -1.0f, 1.0f, 1 << 18);
-        lutIsInitialised = true;
-    }
 }
 
 template <typename T, typename Next>
-dsp::LookupTableTransform<double> CustomDiodePairT<T, Next>::wrightOmegaLUT;
-
-template <typename T, typename Next>
-bool CustomDiodePairT<T, Next>::lutIsInitialised = false;
+const dsp::LookupTableTransform<double>& CustomDiodePairT<T, Next>::getWrightOmegaLUT()
+{
+    // Function-local static: built on first use, thread-safe, and never
+    // rebuilt when a new instance or sample rate comes along
+    static const dsp::LookupTableTransform<double> lut ([] (double x) { return std::real (wrightomega (x)); }, -1.0, 1.0, 1 << 18);
+    return lut;
+}
 
 //======================================================================
 ClippingWDF::ClippingWDF (double sampleRate) : C9 (1.0e-6, sampleRate),
@@ -71,9 +71,9 @@ private:
 
     Next& next;
 
-    // lookup table
-    static dsp::LookupTableTransform<double> wrightOmegaLUT;
-    static bool lutIsInitialised;
+    // lookup table, built once per process and shared by every instance
+    static const dsp::LookupTableTransform<double>& getWrightOmegaLUT();
+    const dsp::LookupTableTransform<double>& wrightOmegaLUT;
 };
 
 } // namespace GainStageSpace
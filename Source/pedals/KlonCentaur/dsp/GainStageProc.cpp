@@ -3,15 +3,31 @@
 using namespace GainStageSpace;
 
 GainStageProc::GainStageProc(double sampleRate)
-    : preAmpL(sampleRate), preAmpR(sampleRate),
-      clipL(sampleRate * os.getOversamplingFactor()),
-      clipR(sampleRate * os.getOversamplingFactor()), ff2L(sampleRate),
+    : wdfRate(sampleRate), preAmpL(sampleRate), preAmpR(sampleRate),
+      clipBaseL(sampleRate), clipBaseR(sampleRate), ff2L(sampleRate),
       ff2R(sampleRate) {
   // No APVTS needed
+  setOversamplingOrder(oversamplingOrder);
+}
+
+void GainStageProc::setOversamplingOrder(int order) {
+  order = jlimit(1, 3, order);
+  if (os != nullptr && order == oversamplingOrder)
+    return;
+
+  oversamplingOrder = order;
+  os = std::make_unique<dsp::Oversampling<float>>(
+      2, oversamplingOrder,
+      dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR);
+
+  const double clipRate = wdfRate * os->getOversamplingFactor();
+  clipL = std::make_unique<ClippingWDF>(clipRate);
+  clipR = std::make_unique<ClippingWDF>(clipRate);
+  setOversampling(oversample);
 }
 
 void GainStageProc::reset(double sampleRate, int samplesPerBlock) {
-  os.initProcessing(samplesPerBlock);
+  os->initProcessing(samplesPerBlock);
 
   for (int ch = 0; ch < 2; ++ch) {
     amp[ch].prepare((float)sampleRate);
@@ -22,6 +38,31 @@ void GainStageProc::reset(double sampleRate, int samplesPerBlock) {
   ff2Buff.setSize(2, samplesPerBlock);
 }
 
+void GainStageProc::resetState(double sampleRate) {
+  os->reset();
+
+  for (int ch = 0; ch < 2; ++ch) {
+    amp[ch].prepare((float)sampleRate);
+    sumAmp[ch].prepare((float)sampleRate);
+  }
+}
+
+void GainStageProc::setGain(float gain) {
+  gainValue = gain;
+
+  for (int ch = 0; ch < 2; ++ch) {
+    preAmp[ch]->setGain(gainValue);
+    amp[ch].setGain(gainValue);
+    ff2[ch]->setGain(gainValue);
+  }
+}
+
+void GainStageProc::setOversampling(bool shouldOversample) {
+  oversample = shouldOversample;
+  clip[0] = oversample ? clipL.get() : &clipBaseL;
+  clip[1] = oversample ? clipR.get() : &clipBaseR;
+}
+
 void GainStageProc::processBlock(AudioBuffer<float> &buffer) {
   const auto numSamples = buffer.getNumSamples();
   for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
@@ -33,13 +74,11 @@ void GainStageProc::processBlock(AudioBuffer<float> &buffer) {
     FloatVectorOperations::copy(x2, x, numSamples);
 
     // Gain stage
-    preAmp[ch]->setGain(gainValue);
     for (int n = 0; n < numSamples; ++n) {
       x[n] = preAmp[ch]->processSample(x[n]);
       x1[n] = preAmp[ch]->getFF1();
     }
 
-    amp[ch].setGain(gainValue);
     amp[ch].processBlock(x, numSamples);
     FloatVectorOperations::clip(x, x, -4.5f, 4.5f, numSamples);
   }
@@ -48,7 +87,8 @@ void GainStageProc::processBlock(AudioBuffer<float> &buffer) {
   dsp::AudioBlock<float> osBlock(buffer);
 
   // upsample
-  osBlock = os.processSamplesUp(block);
+  if (oversample)
+    osBlock = os->processSamplesUp(block);
   const auto osNumSamples = (int)osBlock.getNumSamples();
   for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
     auto *x = osBlock.getChannelPointer(ch);
@@ -59,7 +99,8 @@ void GainStageProc::processBlock(AudioBuffer<float> &buffer) {
   }
 
   // downsample
-  os.processSamplesDown(block);
+  if (oversample)
+    os->processSamplesDown(block);
 
   for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
     auto *x = buffer.getWritePointer(ch);
@@ -67,7 +108,6 @@ void GainStageProc::processBlock(AudioBuffer<float> &buffer) {
     auto *x2 = ff2Buff.getWritePointer(ch);
 
     // Feed forward network 2
-    ff2[ch]->setGain(gainValue);
     for (int n = 0; n < numSamples; ++n)
       x2[n] = ff2[ch]->processSample(x2[n]);
 
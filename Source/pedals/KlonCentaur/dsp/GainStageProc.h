@@ -12,25 +12,43 @@ public:
   GainStageProc(double sampleRate);
 
   void reset(double sampleRate, int samplesPerBlock);
+
+  // Clears filter state only; safe to call from the audio thread
+  void resetState(double sampleRate);
+
   void processBlock(AudioBuffer<float> &buffer);
 
-  // Direct gain control (0.0 to 1.0)
-  void setGain(float gain) { gainValue = gain; }
+  // Direct gain control (0.0 to 1.0). Pushed into the WDFs and the amp
+  // stage immediately, once per (sub-)block.
+  void setGain(float gain);
   float getGain() const { return gainValue; }
 
+  // Oversampling around the clipper (default on). Switches between two
+  // clipper pairs, as the WDF capacitors fix their rate when built.
+  void setOversampling(bool shouldOversample);
+
+  // Oversampling factor as a power of two, 1 = 2x by default. Rebuilds the
+  // oversampler and its clipper pair; message thread, before reset().
+  void setOversamplingOrder(int order);
+
 private:
   float gainValue = 0.5f; // Direct storage instead of pointer
 
   AudioBuffer<float> ff1Buff;
   AudioBuffer<float> ff2Buff;
-  dsp::Oversampling<float> os{
-      2, 1, dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR};
+  std::unique_ptr<dsp::Oversampling<float>> os;
+  int oversamplingOrder = 1;
+
+  // Rate the WDFs are built for
+  double wdfRate;
 
   GainStageSpace::PreAmpWDF preAmpL, preAmpR;
   GainStageSpace::PreAmpWDF *preAmp[2]{&preAmpL, &preAmpR};
 
-  GainStageSpace::ClippingWDF clipL, clipR;
-  GainStageSpace::ClippingWDF *clip[2]{&clipL, &clipR};
+  bool oversample = true;
+  std::unique_ptr<GainStageSpace::ClippingWDF> clipL, clipR; // oversampled
+  GainStageSpace::ClippingWDF clipBaseL, clipBaseR;           // base rate
+  GainStageSpace::ClippingWDF *clip[2]{&clipBaseL, &clipBaseR};
 
   GainStageSpace::FeedForward2WDF ff2L, ff2R;
   GainStageSpace::FeedForward2WDF *ff2[2]{&ff2L, &ff2R};
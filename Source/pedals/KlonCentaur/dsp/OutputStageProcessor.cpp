@@ -5,10 +5,7 @@ void OutputStageProc::prepare (float sampleRate)
     chowdsp::IIRFilter<1>::reset();
     fs = (float) sampleRate;
 
-    levelSmooth.setCurrentAndTargetValue (levelSmooth.getTargetValue());
-    levelSmooth.reset (sampleRate, 0.05);
-
-    calcCoefs (levelSmooth.getTargetValue());
+    calcCoefs (level);
 }
 
 void OutputStageProc::calcCoefs (float curLevel)
@@ -28,19 +25,3 @@ void OutputStageProc::calcCoefs (float curLevel)
     const auto K = 2.0f * fs;
     chowdsp::Bilinear::BilinearTransform<float, 2>::call (b, a, bs, as, K);
 }
-
-void OutputStageProc::processBlock (float* block, const int numSamples) noexcept
-{
-    if (levelSmooth.isSmoothing())
-    {
-        for (int n = 0; n < numSamples; ++n)
-        {
-            calcCoefs (levelSmooth.getNextValue());
-            block[n] = processSample (block[n]);
-        }
-    }
-    else
-    {
-        chowdsp::IIRFilter<1>::processBlock (block, numSamples);
-    }
-}
@@ -5,20 +5,22 @@
 
 class OutputStageProc : public chowdsp::IIRFilter<1> {
 public:
-  OutputStageProc() { levelSmooth = 1.0f; }
+  OutputStageProc() {}
 
-  void setLevel(float level) {
-    levelSmooth.setTargetValue(jlimit(0.00001f, 1.0f, level));
+  void setLevel(float newLevel) {
+    level = jlimit(0.00001f, 1.0f, newLevel);
+    calcCoefs(level);
   }
 
   void prepare(float sampleRate);
   void calcCoefs(float curLevel);
-  void processBlock(float *block, const int numSamples) noexcept override;
 
 private:
   float fs = 44100.0f;
 
-  SmoothedValue<float, ValueSmoothingTypes::Multiplicative> levelSmooth;
+  // Coefficients are recomputed once per (sub-)block in setLevel();
+  // automation arrives as a block-rate ramp.
+  float level = 1.0f;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputStageProc)
 };
@@ -5,10 +5,7 @@ void ToneFilterProcessor::prepare (float sampleRate)
     chowdsp::IIRFilter<1>::reset();
     fs = (float) sampleRate;
 
-    trebleSmooth.setCurrentAndTargetValue (trebleSmooth.getTargetValue());
-    trebleSmooth.reset (sampleRate, 0.05);
-
-    calcCoefs (trebleSmooth.getTargetValue());
+    calcCoefs (treble);
 }
 
 void ToneFilterProcessor::calcCoefs (float curTreble)
@@ -40,19 +37,3 @@ void ToneFilterProcessor::calcCoefs (float curTreble)
     b[0] = bU[0] / aU[1];
     b[1] = bU[1] / aU[1];
 }
-
-void ToneFilterProcessor::processBlock (float* block, const int numSamples) noexcept
-{
-    if (trebleSmooth.isSmoothing())
-    {
-        for (int n = 0; n < numSamples; ++n)
-        {
-            calcCoefs (trebleSmooth.getNextValue());
-            block[n] = processSample (block[n]);
-        }
-    }
-    else
-    {
-        chowdsp::IIRFilter<1>::processBlock (block, numSamples);
-    }
-}
@@ -5,20 +5,22 @@
 
 class ToneFilterProcessor : public chowdsp::IIRFilter<1> {
 public:
-  ToneFilterProcessor() { trebleSmooth = 0.287394f; }
+  ToneFilterProcessor() {}
 
-  void setTreble(float treble) {
-    trebleSmooth.setTargetValue(jlimit(0.0f, 1.0f, treble));
+  void setTreble(float newTreble) {
+    treble = jlimit(0.0f, 1.0f, newTreble);
+    calcCoefs(treble);
   }
 
   void prepare(float sampleRate);
   void calcCoefs(float curTreble);
-  void processBlock(float *block, const int numSamples) noexcept override;
 
 private:
   float fs = 44100.0f;
 
-  juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> trebleSmooth;
+  // Coefficients are recomputed once per (sub-)block in setTreble();
+  // automation arrives as a block-rate ramp.
+  float treble = 0.287394f;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ToneFilterProcessor)
 };
@@ -17,12 +17,58 @@ public:
 
     // Initialize JUCE Reverb
     reverb.setSampleRate(sampleRate);
+    monoReverb.setSampleRate(sampleRate);
+
+    // Reduced density: the mono sum, and the dry gain juce::Reverb would
+    // otherwise smooth itself
+    monoBuffer.setSize(1, (int)spec.maximumBlockSize);
+    dryGain.reset(sampleRate, 0.01);
+
+    // Density handover: the outgoing mode's copy of the block
+    handoverBuffer.setSize(2, (int)spec.maximumBlockSize);
+    handoverSamples = juce::jmax(1, (int)(handoverSeconds * sampleRate));
+    handoverSamplesLeft = 0;
 
     // Set initial parameters
     updateReverbParameters();
   }
 
-  void reset() { reverb.reset(); }
+  void reset() {
+    reverb.reset();
+    monoReverb.reset();
+    dryGain.setCurrentAndTargetValue(dryGain.getTargetValue());
+    handoverSamplesLeft = 0;
+  }
+
+  /**
+   * Reduced density: one mono tail shared by both sides instead of two
+   * decorrelated ones. juce::Reverb already feeds both of its comb banks
+   * the sum of the inputs, so this runs half the comb and allpass filters
+   * for the same level and decay, at the cost of width. Audio thread, no
+   * allocation. The new mode starts from a clean tail and both run for
+   * handoverSeconds while their outputs crossfade.
+   */
+  void setReducedDensity(bool shouldReduce) {
+    if (shouldReduce == reducedDensity)
+      return;
+
+    reducedDensity = shouldReduce;
+
+    // Turned back mid-handover: the mode coming back still has its tail,
+    // and fades in from the gain it had reached
+    if (handoverSamplesLeft > 0) {
+      handoverSamplesLeft = handoverSamples - handoverSamplesLeft;
+      return;
+    }
+
+    if (reducedDensity) {
+      monoReverb.reset();
+      dryGain.setCurrentAndTargetValue(dryGain.getTargetValue());
+    } else {
+      reverb.reset();
+    }
+    handoverSamplesLeft = handoverSamples;
+  }
 
   /**
    * Set the mix/wet-dry balance (0.0 to 10.0)
@@ -32,6 +78,7 @@ public:
    */
   void setMix(float mix) {
     currentMix = juce::jlimit(0.0f, 10.0f, mix);
+    updateReverbParameters();
   }
 
   /**
@@ -42,6 +89,7 @@ public:
    */
   void setTone(float tone) {
     currentTone = juce::jlimit(0.0f, 10.0f, tone);
+    updateReverbParameters();
   }
 
   /**
@@ -52,18 +100,33 @@ public:
    */
   void setSize(float size) {
     currentSize = juce::jlimit(0.0f, 10.0f, size);
+    updateReverbParameters();
+  }
+
+  /**
+   * RT60 estimate for a given size (0.0 to 10.0), used for the plugin's
+   * reported tail length. Mirrors juce::Reverb: comb feedback is
+   * roomSize * 0.28 + 0.7 around a longest comb delay of 1617 samples
+   * at 44.1 kHz.
+   */
+  static double getTailLengthSeconds(float size) {
+    const double combFeedback =
+        juce::jlimit(0.0f, 10.0f, size) / 10.0 * 0.28 + 0.7;
+    const double longestCombSeconds = 1617.0 / 44100.0;
+    return 3.0 * longestCombSeconds / -std::log10(combFeedback);
   }
 
   /**
    * Process audio buffer through reverb
    */
   void process(juce::AudioBuffer<float> &buffer) {
-    // Rebuild parameters every block from current setter values
-    updateReverbParameters();
+    // Parameters are pushed by the setters, only when they change
+    if (handoverSamplesLeft > 0) {
+      processHandover(buffer);
+      return;
+    }
 
-    // Process stereo (plugin architecture guarantees 2 channels)
-    reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1),
-                         buffer.getNumSamples());
+    processMode(reducedDensity, buffer);
   }
 
   // Getters for current parameter values (for UI)
@@ -76,6 +139,22 @@ private:
   juce::Reverb reverb;
   juce::Reverb::Parameters currentParams;
 
+  // Reduced density: wet-only mono reverb, dry applied here
+  bool reducedDensity = false;
+  juce::Reverb monoReverb;
+  juce::AudioBuffer<float> monoBuffer;
+  juce::SmoothedValue<float> dryGain{1.0f};
+
+  // Density change under way: samples until the new mode alone is heard
+  juce::AudioBuffer<float> handoverBuffer;
+  int handoverSamples = 1;
+  int handoverSamplesLeft = 0;
+
+  static constexpr double handoverSeconds = 0.1;
+
+  // juce::Reverb's scaling of Parameters::dryLevel
+  static constexpr float dryScaleFactor = 2.0f;
+
   // Audio processing specs
   double sampleRate = 44100.0;
   int numChannels = 2;
@@ -115,5 +194,64 @@ private:
 
     // Apply parameters to reverb
     reverb.setParameters(currentParams);
+
+    auto wetOnly = currentParams;
+    wetOnly.dryLevel = 0.0f;
+    monoReverb.setParameters(wetOnly);
+    dryGain.setTargetValue(currentParams.dryLevel * dryScaleFactor);
+  }
+
+  void processMode(bool reduced, juce::AudioBuffer<float> &buffer) {
+    if (reduced) {
+      processMonoTail(buffer);
+      return;
+    }
+
+    // Process stereo (plugin architecture guarantees 2 channels)
+    reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1),
+                         buffer.getNumSamples());
+  }
+
+  // Both modes on the same input, the new one fading in over the old
+  void processHandover(juce::AudioBuffer<float> &buffer) {
+    const int numSamples = buffer.getNumSamples();
+    juce::AudioBuffer<float> outgoing(handoverBuffer.getArrayOfWritePointers(),
+                                      2, numSamples);
+    for (int ch = 0; ch < 2; ++ch)
+      outgoing.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+    processMode(!reducedDensity, outgoing);
+    processMode(reducedDensity, buffer);
+
+    const int fadeLength = juce::jmin(numSamples, handoverSamplesLeft);
+    const float length = (float)handoverSamples;
+    const float startGain = 1.0f - (float)handoverSamplesLeft / length;
+    const float endGain =
+        1.0f - (float)(handoverSamplesLeft - fadeLength) / length;
+
+    for (int ch = 0; ch < 2; ++ch) {
+      buffer.applyGainRamp(ch, 0, fadeLength, startGain, endGain);
+      buffer.addFromWithRamp(ch, 0, outgoing.getReadPointer(ch), fadeLength,
+                             1.0f - startGain, 1.0f - endGain);
+    }
+
+    handoverSamplesLeft -= fadeLength;
+  }
+
+  void processMonoTail(juce::AudioBuffer<float> &buffer) {
+    const int numSamples = buffer.getNumSamples();
+    auto *left = buffer.getWritePointer(0);
+    auto *right = buffer.getWritePointer(1);
+    auto *tail = monoBuffer.getWritePointer(0);
+
+    // Summed, not averaged: the stereo reverb's input is L + R too
+    juce::FloatVectorOperations::add(tail, left, right, numSamples);
+    monoReverb.processMono(tail, numSamples);
+
+    const float dryStart = dryGain.getCurrentValue();
+    const float dryEnd = dryGain.skip(numSamples);
+    buffer.applyGainRamp(0, numSamples, dryStart, dryEnd);
+    juce::FloatVectorOperations::add(left, tail, numSamples);
+    juce::FloatVectorOperations::add(right, tail, numSamples);
   }
 };
@@ -2,9 +2,11 @@
 #include "dsp/ClippingStage.h"
 #include "dsp/ToneStage.h"
 
-TSProcessor::TSProcessor()
-    : oversampling(2, 1,
-                   juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR) {
+TSProcessor::TSProcessor() {
+  oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
+      2, oversamplingOrder,
+      juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR);
+
   // Initialize DSP instances
   for (int ch = 0; ch < 2; ++ch) {
     clippingStage[ch] = std::make_unique<ClippingStage>();
@@ -19,16 +21,17 @@ void TSProcessor::prepare(const juce::dsp::ProcessSpec &spec) {
   maxBlockSize = spec.maximumBlockSize;
   numChannels = spec.numChannels;
 
-  // Initialize oversampling (2x oversampling, order 1)
-  oversampling.initProcessing(maxBlockSize);
-
-  // Oversample factor for clipping stage
-  const float oversampledRate =
-      (float)sampleRate * std::pow(2.0f, 1.0f); // 2^1 = 2x
+  // Initialize oversampling (2^order, 2x unless set otherwise)
+  if (oversampling->getOversamplingFactor() !=
+      ((size_t)1 << oversamplingOrder))
+    oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
+        2, oversamplingOrder,
+        juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR);
+  oversampling->initProcessing(maxBlockSize);
 
   // Prepare clipping and tone stages for each channel
   for (int ch = 0; ch < 2; ++ch) {
-    clippingStage[ch]->prepare(oversampledRate);
+    clippingStage[ch]->prepare(getClippingRate());
     clippingStage[ch]->setDrive(currentDrive);
 
     toneStage[ch]->prepare((float)sampleRate);
@@ -37,7 +40,7 @@ void TSProcessor::prepare(const juce::dsp::ProcessSpec &spec) {
 }
 
 void TSProcessor::reset() {
-  oversampling.reset();
+  oversampling->reset();
 
   for (int ch = 0; ch < 2; ++ch) {
     clippingStage[ch]->reset();
@@ -45,12 +48,36 @@ void TSProcessor::reset() {
   }
 }
 
+void TSProcessor::setOversampling(bool shouldOversample) {
+  if (shouldOversample == oversample)
+    return;
+
+  oversample = shouldOversample;
+
+  // The WDF capacitors only recompute their impedances
+  for (int ch = 0; ch < 2; ++ch)
+    clippingStage[ch]->prepare(getClippingRate());
+}
+
+void TSProcessor::setOversamplingOrder(int order) {
+  oversamplingOrder = juce::jlimit(1, 3, order);
+}
+
+float TSProcessor::getClippingRate() const {
+  return oversample ? (float)(sampleRate * (1 << oversamplingOrder))
+                    : (float)sampleRate;
+}
+
 void TSProcessor::setDrive(float drive) {
   currentDrive = juce::jlimit(0.0f, 10.0f, drive);
+  for (int ch = 0; ch < 2; ++ch)
+    clippingStage[ch]->setDrive(currentDrive);
 }
 
 void TSProcessor::setTone(float tone) {
   currentTone = juce::jlimit(0.0f, 10.0f, tone);
+  for (int ch = 0; ch < 2; ++ch)
+    toneStage[ch]->setTone(currentTone);
 }
 
 void TSProcessor::setLevel(float level) {
@@ -61,11 +88,10 @@ void TSProcessor::process(juce::AudioBuffer<float> &buffer) {
   const auto numSamples = buffer.getNumSamples();
   juce::dsp::AudioBlock<float> block(buffer);
 
-  // ========== CLIPPING STAGE (with 2x oversampling) ==========
-  auto osBlock = oversampling.processSamplesUp(block);
+  // ========== CLIPPING STAGE (oversampled, 2x by default) ==========
+  auto osBlock = oversample ? oversampling->processSamplesUp(block) : block;
 
   for (int ch = 0; ch < osBlock.getNumChannels(); ++ch) {
-    clippingStage[ch]->setDrive(currentDrive);
     auto *x = osBlock.getChannelPointer(ch);
 
     for (int n = 0; n < osBlock.getNumSamples(); ++n) {
@@ -73,13 +99,13 @@ void TSProcessor::process(juce::AudioBuffer<float> &buffer) {
     }
   }
 
-  oversampling.processSamplesDown(block);
+  if (oversample)
+    oversampling->processSamplesDown(block);
 
   // ========== TONE STAGE ==========
   for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
     auto *x = buffer.getWritePointer(ch);
 
-    toneStage[ch]->setTone(currentTone);
     toneStage[ch]->processBlock(x, numSamples);
   }
 
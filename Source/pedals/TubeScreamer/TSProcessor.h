@@ -42,6 +42,19 @@ public:
    */
   void process(juce::AudioBuffer<float> &buffer);
 
+  /**
+   * 2x oversampling around the clipping stage, on by default. Off, the
+   * diodes clip at the host rate: cheaper, with more aliasing at high
+   * drive. Audio thread, no allocation; follow with reset().
+   */
+  void setOversampling(bool shouldOversample);
+
+  /**
+   * Oversampling factor as a power of two: 1 = 2x (the default), 2 = 4x.
+   * Message thread; takes effect at the next prepare().
+   */
+  void setOversamplingOrder(int order);
+
   float getCurrentDrive() const;
   float getCurrentTone() const;
   float getCurrentLevel() const;
@@ -56,8 +69,15 @@ private:
   std::unique_ptr<ClippingStage> clippingStage[2];
   std::unique_ptr<ToneStage> toneStage[2];
 
-  // Oversampling for clipping stage
-  juce::dsp::Oversampling<float> oversampling;
+  // Oversampling for clipping stage, rebuilt by prepare() when the order
+  // changes
+  std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+  int oversamplingOrder = 1;
+  bool oversample = true;
+
+  // Rate the clipping stage runs at: the host rate, times the oversampling
+  // factor if oversampling
+  float getClippingRate() const;
 
   // Current parameter values
   float currentDrive = 2.0f;
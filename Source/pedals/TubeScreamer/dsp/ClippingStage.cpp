@@ -17,7 +17,8 @@ ClippingStage::ClippingStage()
 void ClippingStage::setDrive(float drive)
 {
     auto audioTaperPotOutput = audioTaperPotSim(drive);
-    p1Smoothed.setTargetValue(jmap(audioTaperPotOutput, 0.0f, 10.0f, 10.0f, rPot));
+    p1 = jmap(audioTaperPotOutput, 0.0f, 10.0f, 10.0f, rPot);
+    clipWDFc.setPotResitanceValue(p1);
 }
 
 void ClippingStage::reset()
@@ -31,18 +32,14 @@ void ClippingStage::prepare(float sampleRate)
 {
     fs = (float)sampleRate;
 
-    p1Smoothed.setCurrentAndTargetValue(10.0f);
-    p1Smoothed.reset(sampleRate, 0.05);
-
     clipWDFa.prepare(sampleRate);
     clipWDFb.prepare(sampleRate);
     clipWDFc.prepare(sampleRate);
+    clipWDFc.setPotResitanceValue(p1);
 }
 
 float ClippingStage::processSample(float x) noexcept
 {
-    clipWDFc.setPotResitanceValue(p1Smoothed.getNextValue());
-
     const float clipWDFaOut = clipWDFa.processSample(x);
     const float clipWDFbOut = clipWDFb.processSample(clipWDFaOut);
     return clipWDFc.processSample(clipWDFbOut);
@@ -33,7 +33,9 @@ private:
 
   const float rPot = 500000.0f;
 
-  juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> p1Smoothed;
+  // Drive pot resistance. Set once per (sub-)block; automation arrives as a
+  // block-rate ramp from the processor instead of per-sample smoothing.
+  float p1 = 10.0f;
 
   juce::dsp::Oversampling<float> oversampling{
       2, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR};
@@ -17,7 +17,8 @@ ToneStage::ToneStage()
 void ToneStage::setTone(float tone)
 {
     auto gTaperPotOutput = taperPotSim(tone);
-    rLSmoothed.setTargetValue(jmap(gTaperPotOutput, 0.0f, 10.0f, 10.0f, rPot));
+    rL = jmap(gTaperPotOutput, 0.0f, 10.0f, 10.0f, rPot);
+    calcCoefs(rL);
 }
 
 void ToneStage::prepare(float sampleRate)
@@ -25,10 +26,7 @@ void ToneStage::prepare(float sampleRate)
     chowdsp::IIRFilter<2>::reset();
     fs = (float)sampleRate;
 
-    rLSmoothed.setCurrentAndTargetValue(10.0f);
-    rLSmoothed.reset(sampleRate, 0.05);
-
-    calcCoefs(rLSmoothed.getTargetValue());
+    calcCoefs(rL);
 }
 
 void ToneStage::calcCoefs(float rL)
@@ -76,22 +74,6 @@ void ToneStage::calcCoefs(float rL)
 
 }
 
-void ToneStage::processBlock(float* block, const int numSamples) noexcept
-{
-    if (rLSmoothed.isSmoothing())
-    {
-        for (int n = 0; n < numSamples; ++n)
-        {
-            calcCoefs(rLSmoothed.getNextValue());
-            block[n] = processSample(block[n]);
-        }
-    }
-    else
-    {
-        chowdsp::IIRFilter<2>::processBlock(block, numSamples);
-    }
-}
-
 float ToneStage::taperPotSim(float in)
 {
     jassert(in >= 0.0f && in <= 10.0f);
@@ -19,7 +19,6 @@ public:
   void setTone(float tone);
   void prepare(float sampleRate);
   void calcCoefs(float curTreble);
-  void processBlock(float *block, const int numSamples) noexcept override;
 
 private:
   float taperPotSim(float in);
@@ -27,7 +26,9 @@ private:
 
   const float rPot = 20000.0f;
 
-  juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> rLSmoothed;
+  // Tone pot resistance. Coefficients are recomputed once per (sub-)block
+  // in setTone(); automation arrives as a block-rate ramp.
+  float rL = 10.0f;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ToneStage)
-};
\ No newline at end of file
+};
\ No newline at end of file
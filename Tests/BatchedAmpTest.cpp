@@ -0,0 +1,145 @@
+#include "ModelRegistry.h"
+#include <thread>
+
+/**
+ * Batched Amp Test
+ * Instances of the test model that share a SharedWaveNet::Batch must give
+ * the same output as instances running alone, one block later. Each
+ * instance gets its own input and block size, so batches mix instances
+ * part-way through their blocks, and tiles mix lanes of different lengths.
+ * The instances run in turn on one thread, then on a thread each, as in a
+ * host that processes tracks in parallel. Last, one instance is prewarmed
+ * while another runs: that must not disturb the other's output.
+ */
+class BatchedAmpTest : public juce::UnitTest {
+public:
+  BatchedAmpTest() : juce::UnitTest("Batched amps", "Batched amps") {}
+
+  void runTest() override {
+    juce::MemoryBlock contents;
+    expect(juce::File(MAYERISM_TEST_MODEL).loadFileAsData(contents),
+           "Missing test model");
+    weights =
+        SharedWaveNet::Weights::parse(ModelRegistry::parseContents(contents));
+
+    // Guitar DI level noise, different for each instance
+    juce::Random random(0x42415443);
+    for (auto &input : inputs) {
+      input.resize((size_t)numSamples);
+      for (auto &sample : input)
+        sample = 0.2f * (random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    for (size_t i = 0; i < numInstances; ++i) {
+      expected[i].resize((size_t)numSamples);
+      SharedWaveNet alone(weights);
+      alone.process(inputs[i].data(), expected[i].data(), numSamples);
+    }
+
+    beginTest("In turn");
+    runBatched(false);
+
+    beginTest("In parallel");
+    runBatched(true);
+
+    beginTest("Prewarm while another runs");
+    runPrewarm();
+  }
+
+private:
+  static constexpr size_t numInstances = 5;
+  static constexpr int numSamples = 48000;
+  static constexpr int maxBlockSize = 128;
+  static constexpr std::array<int, numInstances> blockSizes{128, 64, 100,
+                                                            37, 128};
+
+  void runBatched(bool inParallel) {
+    auto batch = std::make_shared<SharedWaveNet::Batch>();
+
+    std::array<std::unique_ptr<SharedWaveNet>, numInstances> nets;
+    std::array<std::vector<float>, numInstances> outputs;
+    for (size_t i = 0; i < numInstances; ++i) {
+      nets[i] = std::make_unique<SharedWaveNet>(weights, batch);
+      nets[i]->setMaxBlockSize(maxBlockSize);
+      expectEquals(nets[i]->getLatency(), maxBlockSize);
+      outputs[i].resize((size_t)numSamples);
+    }
+
+    auto runBlock = [&](size_t i, int start) {
+      const int n = juce::jmin(blockSizes[i], numSamples - start);
+      nets[i]->process(inputs[i].data() + start, outputs[i].data() + start,
+                       n);
+    };
+
+    if (inParallel) {
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < numInstances; ++i)
+        threads.emplace_back([&, i] {
+          for (int start = 0; start < numSamples; start += blockSizes[i])
+            runBlock(i, start);
+        });
+      for (auto &thread : threads)
+        thread.join();
+    } else {
+      std::array<int, numInstances> starts{};
+      for (bool running = true; running;) {
+        running = false;
+        for (size_t i = 0; i < numInstances; ++i) {
+          if (starts[i] >= numSamples)
+            continue;
+          runBlock(i, starts[i]);
+          starts[i] += blockSizes[i];
+          running = true;
+        }
+      }
+    }
+
+    // One block of silence, then the output of the instance running alone.
+    // Tiles of other widths may round differently.
+    for (size_t i = 0; i < numInstances; ++i) {
+      float maxError = 0.0f;
+      for (int t = 0; t < numSamples; ++t) {
+        const float reference =
+            t < maxBlockSize ? 0.0f
+                             : expected[i][(size_t)(t - maxBlockSize)];
+        maxError =
+            juce::jmax(maxError, std::abs(outputs[i][(size_t)t] - reference));
+      }
+      expectLessThan(maxError, 1.0e-5f);
+    }
+  }
+
+  void runPrewarm() {
+    auto batch = std::make_shared<SharedWaveNet::Batch>();
+    SharedWaveNet running(weights, batch), prewarmed(weights, batch);
+    running.setMaxBlockSize(maxBlockSize);
+    prewarmed.setMaxBlockSize(maxBlockSize);
+
+    std::vector<float> output((size_t)numSamples), scratch((size_t)numSamples);
+    std::thread thread([&] {
+      for (int start = 0; start < numSamples; start += maxBlockSize)
+        running.process(inputs[0].data() + start, output.data() + start,
+                        juce::jmin(maxBlockSize, numSamples - start));
+    });
+
+    // Half the signal through the batch, then a prewarm as on a model load
+    for (int start = 0; start < numSamples / 2; start += blockSizes[1])
+      prewarmed.process(inputs[1].data() + start, scratch.data() + start,
+                        blockSizes[1]);
+    prewarmed.prewarm();
+    thread.join();
+
+    float maxError = 0.0f;
+    for (int t = maxBlockSize; t < numSamples; ++t)
+      maxError = juce::jmax(
+          maxError, std::abs(output[(size_t)t] -
+                             expected[0][(size_t)(t - maxBlockSize)]));
+    expectLessThan(maxError, 1.0e-5f);
+  }
+
+  std::shared_ptr<const SharedWaveNet::Weights> weights;
+  std::array<std::vector<float>, numInstances> inputs;
+  std::array<std::vector<float>, numInstances> expected;
+};
+
+static BatchedAmpTest batchedAmpTest;
@@ -0,0 +1,115 @@
+#include "PluginProcessor.h"
+
+/**
+ * Bounce Test
+ * An offline render must line up with realtime playback sample for
+ * sample. The same input goes through a processor playing live and one
+ * rendering offline, in host blocks of different sizes; shifted by the
+ * latency each reports, the outputs must match. The two report the same
+ * latency, as a host may not hear of a change when a render starts.
+ *
+ * Runs as a plain bounce, and as a high quality one, which gathers host
+ * blocks into chunks and delays live playback to match. That run has the
+ * boost, TS and Klon off, as its 4x clipping sounds different by design.
+ */
+class BounceTest : public juce::UnitTest {
+public:
+  BounceTest() : juce::UnitTest("Bounce", "Bounce") {}
+
+  void runTest() override {
+    // Preparing starts the chunk size tuning; keep it off the user's
+    // settings
+    const juce::TemporaryFile settings(".settings");
+    juce::SharedResourcePointer<ChunkSizeTuner> tuner;
+    tuner->setSettingsFile(settings.getFile());
+
+    juce::Random random(0x424f554e);
+    input.resize((size_t)numSamples);
+    for (auto &sample : input)
+      sample = 0.2f * (random.nextFloat() * 2.0f - 1.0f);
+
+    for (const bool highQuality : {false, true}) {
+      beginTest(highQuality ? "High quality" : "Plain");
+
+      int liveLatency = 0;
+      int bounceLatency = 0;
+      const auto live = render(false, highQuality, liveLatency);
+      const auto bounce = render(true, highQuality, bounceLatency);
+
+      // A batched amp's own delay follows the chunk size
+      if (!ModelRegistry::batchedAmps)
+        expectEquals(bounceLatency, liveLatency);
+
+      const int length =
+          numSamples - juce::jmax(liveLatency, bounceLatency);
+      float maxError = 0.0f;
+      float peak = 0.0f;
+      for (int t = 0; t < length; ++t) {
+        const float expected = live[(size_t)(t + liveLatency)];
+        const float actual = bounce[(size_t)(t + bounceLatency)];
+        maxError = juce::jmax(maxError, std::abs(actual - expected));
+        peak = juce::jmax(peak, std::abs(expected));
+      }
+
+      logMessage("Latency " + juce::String(bounceLatency) + ", peak " +
+                 juce::String(peak, 4) + ", largest difference " +
+                 juce::String(maxError, 9));
+
+      // Silence would line up with anything
+      expectGreaterThan(peak, 1.0e-3f);
+      expectLessThan(maxError, tolerance);
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int numSamples = 48000;
+  static constexpr int liveBlockSize = 128;
+  static constexpr int bounceBlockSize = 1000;
+
+  // The amp's tiles fall differently at each block size, which changes
+  // the float rounding and nothing else
+  static constexpr float tolerance = 1.0e-4f;
+
+  // The left output of a fresh processor on the default preset
+  std::vector<float> render(bool offline, bool highQuality, int &latency) {
+    NamJUCEAudioProcessor processor;
+    processor.getQualityGovernor().setEnabled(false);
+    processor.setHighQualityBounce(highQuality);
+
+    if (highQuality)
+      for (const auto id : {ParameterIDs::BoostEnabled,
+                            ParameterIDs::TsEnabled,
+                            ParameterIDs::KlonEnabled})
+        processor.apvts.getParameter(ParameterIDs::getParameterID(id))
+            ->setValueNotifyingHost(0.0f);
+
+    const int blockSize = offline ? bounceBlockSize : liveBlockSize;
+    processor.setNonRealtime(offline);
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    latency = processor.getLatencySamples();
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    std::vector<float> output((size_t)numSamples);
+
+    for (int start = 0; start < numSamples; start += blockSize) {
+      const int n = juce::jmin(blockSize, numSamples - start);
+      juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, n);
+      for (int ch = 0; ch < 2; ++ch)
+        block.copyFrom(ch, 0, input.data() + start, n);
+
+      processor.processBlock(block, midi);
+      std::copy(block.getReadPointer(0), block.getReadPointer(0) + n,
+                output.begin() + start);
+    }
+
+    processor.releaseResources();
+    return output;
+  }
+
+  std::vector<float> input;
+};
+
+static BounceTest bounceTest;
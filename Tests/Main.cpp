@@ -0,0 +1,21 @@
+#include <JuceHeader.h>
+
+// Runs every juce::UnitTest linked in, or those of the category named on
+// the command line. Fails if any expectation failed.
+int main(int argc, char *argv[]) {
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  juce::UnitTestRunner runner;
+  runner.setAssertOnFailure(false);
+
+  if (argc > 1)
+    runner.runTestsInCategory(argv[1]);
+  else
+    runner.runAllTests();
+
+  int failures = 0;
+  for (int i = 0; i < runner.getNumResults(); ++i)
+    failures += runner.getResult(i)->failures;
+
+  return failures > 0 ? 1 : 0;
+}
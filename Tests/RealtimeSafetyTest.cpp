@@ -0,0 +1,186 @@
+#include "PluginProcessor.h"
+#include "RealtimeGuard.h"
+
+#if !MAYERISM_REALTIME_CHECKS
+#error "The realtime safety test needs the REALTIME_CHECKS build option"
+#endif
+
+/**
+ * Realtime Safety Test
+ * Drives the processor the way a host and a user would, with the realtime
+ * guard in Abort mode: any allocation, free or lock inside processBlock
+ * stops the runner, and ctest reports the test as failed.
+ *
+ * For each sample rate and block size the processor is prepared, then fed
+ * a noisy guitar-level signal while, between blocks, pedals are toggled,
+ * the pedal order changes and the second amp's model is swapped in and
+ * out. With live standby on, one of two presets is cued and, once the
+ * standby chain has warmed on it, loaded, so the switch crossfades at
+ * once; every other time "Default" loads instead, which has to warm up.
+ * Every change reaches the audio thread through the same handoffs a host
+ * would exercise. The same runs are repeated as an
+ * offline render.
+ */
+class RealtimeSafetyTest : public juce::UnitTest {
+public:
+  RealtimeSafetyTest() : juce::UnitTest("Realtime safety", "Realtime safety") {}
+
+  void runTest() override {
+    RealtimeGuard::setMode(RealtimeGuard::Mode::Abort);
+
+    const juce::File model(MAYERISM_TEST_MODEL);
+    expect(model.existsAsFile(), "Missing test model");
+
+    // The first prepare starts the chunk size tuning, which then stores its
+    // result in a scratch file rather than the user's settings
+    const juce::TemporaryFile settings(".settings");
+    juce::SharedResourcePointer<ChunkSizeTuner> tuner;
+    tuner->setSettingsFile(settings.getFile());
+
+    for (const double sampleRate : {44100.0, 48000.0, 96000.0}) {
+      NamJUCEAudioProcessor processor;
+      processor.setLiveStandby(true);
+
+      for (const int blockSize : {1, 16, 64, 128, 441, 512, 1024, 4096}) {
+        beginTest(juce::String(sampleRate, 0) + " Hz, " +
+                  juce::String(blockSize) + " samples");
+
+        RealtimeGuard::resetViolations();
+        run(processor, model, sampleRate, blockSize);
+        expectEquals(RealtimeGuard::getNumViolations(), 0);
+      }
+    }
+
+    // Offline renders, as they are and as high quality bounces, which
+    // gather host blocks into chunks
+    for (const bool highQuality : {false, true}) {
+      NamJUCEAudioProcessor processor;
+      processor.setNonRealtime(true);
+      processor.setHighQualityBounce(highQuality);
+
+      for (const int blockSize : {1, 441, 4096, 5000}) {
+        beginTest(juce::String("Bounce") + (highQuality ? " (HQ), " : ", ") +
+                  juce::String(blockSize) + " samples");
+
+        RealtimeGuard::resetViolations();
+        run(processor, model, 48000.0, blockSize);
+        expectEquals(RealtimeGuard::getNumViolations(), 0);
+      }
+    }
+  }
+
+private:
+  // Audio per configuration, and how often something changes in it
+  static constexpr double secondsPerRun = 0.5;
+  static constexpr double secondsPerEvent = 0.025;
+
+  void run(NamJUCEAudioProcessor &processor, const juce::File &model,
+           double sampleRate, int blockSize) {
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+
+    const int numBlocks =
+        juce::jmax(1, (int)(secondsPerRun * sampleRate) / blockSize);
+    const int blocksPerEvent =
+        juce::jmax(1, (int)(secondsPerEvent * sampleRate) / blockSize);
+
+    int event = 0;
+    for (int block = 0; block < numBlocks; ++block) {
+      if (block % blocksPerEvent == 0)
+        changeSomething(processor, model, event++);
+
+      for (int i = 0; i < blockSize; ++i) {
+        const float sample = 0.2f * (random.nextFloat() * 2.0f - 1.0f);
+        buffer.setSample(0, i, sample);
+        buffer.setSample(1, i, sample);
+      }
+
+      processor.processBlock(buffer, midi);
+    }
+
+    processor.releaseResources();
+  }
+
+  // Message thread side: one change per call, cycling through them all
+  void changeSomething(NamJUCEAudioProcessor &processor,
+                       const juce::File &model, int event) {
+    using P = ParameterIDs;
+    static constexpr P::ID pedals[] = {P::TsEnabled,     P::KlonEnabled,
+                                       P::CompEnabled,   P::BoostEnabled,
+                                       P::ChorusEnabled, P::ReverbEnabled,
+                                       P::DelayEnabled};
+
+    // A cycle cues a preset first and switches last, long enough after
+    // for the standby chain to have filled the amp's history
+    const int cycle = event / 8;
+    switch (event % 8) {
+    case 0:
+      cued = std::make_unique<ParameterSet>(processor.apvts);
+      fillPreset(*cued, cycle % 2);
+      processor.cueParameterSet(*cued);
+      break;
+    case 1:
+    case 4: {
+      const auto id = pedals[(size_t)(event / 4) % std::size(pedals)];
+      toggle(processor, P::getParameterID(id));
+      break;
+    }
+    case 2:
+      setNormalised(processor, P::getParameterID(P::PedalOrder),
+                    random.nextFloat());
+      break;
+    case 3:
+      expect(processor.loadSecondAmp(model), "Second amp did not load");
+      setNormalised(processor, P::getParameterID(P::AmpBlend), 0.5f);
+      break;
+    case 5:
+      processor.clearSecondAmp();
+      break;
+    case 7:
+      if (cycle % 2 == 0)
+        processor.applyParameterSet(*cued);
+      else
+        processor.getPresetManager().loadPreset("Default");
+      break;
+    }
+  }
+
+  // The fixture's two presets, built here rather than saved to the
+  // preset folder
+  static void fillPreset(ParameterSet &values, int preset) {
+    using P = ParameterIDs;
+    const auto set = [&values](P::ID id, float value) {
+      values.set(P::getParameterID(id), value);
+    };
+
+    if (preset == 0) {
+      set(P::TsEnabled, 1.0f);
+      set(P::TsDrive, 7.0f);
+      set(P::ReverbEnabled, 1.0f);
+      set(P::Bass, 6.5f);
+    } else {
+      set(P::KlonEnabled, 1.0f);
+      set(P::DelayEnabled, 1.0f);
+      set(P::PedalOrder, 1.0f);
+      set(P::Treble, 3.5f);
+    }
+  }
+
+  static void toggle(NamJUCEAudioProcessor &processor, const char *id) {
+    auto *param = processor.apvts.getParameter(id);
+    param->setValueNotifyingHost(param->getValue() > 0.5f ? 0.0f : 1.0f);
+  }
+
+  static void setNormalised(NamJUCEAudioProcessor &processor, const char *id,
+                            float value) {
+    processor.apvts.getParameter(id)->setValueNotifyingHost(value);
+  }
+
+  juce::Random random{0x52544753};
+  std::unique_ptr<ParameterSet> cued;
+};
+
+static RealtimeSafetyTest realtimeSafetyTest;
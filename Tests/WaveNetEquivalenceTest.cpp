@@ -0,0 +1,132 @@
+#include "ModelRegistry.h"
+#include "NeuralAmpModeler.h"
+
+/**
+ * WaveNet Equivalence Test
+ * SharedWaveNet must give the output NeuralAmpModelerCore's own WaveNet
+ * gives for the same model. Both are built from one config, prewarmed and
+ * fed the same noise in blocks of uneven sizes; the outputs may differ
+ * only by float rounding, as SharedWaveNet sums the kernel taps in another
+ * order.
+ *
+ * Runs on the bundled model, and on a small synthetic one with gated
+ * layers in two arrays, which the bundled model does not have.
+ */
+class WaveNetEquivalenceTest : public juce::UnitTest {
+public:
+  WaveNetEquivalenceTest()
+      : juce::UnitTest("WaveNet equivalence", "WaveNet equivalence") {}
+
+  void runTest() override {
+    // Installs the plugin's tanh over NAM's, as SharedWaveNet computes it
+    NeuralAmpModeler amp;
+
+    beginTest("Bundled model");
+    juce::MemoryBlock contents;
+    expect(juce::File(MAYERISM_TEST_MODEL).loadFileAsData(contents),
+           "Missing test model");
+    compare(ModelRegistry::parseContents(contents));
+
+    beginTest("Gated layers");
+    compare(makeGatedConfig());
+  }
+
+private:
+  static constexpr int numSamples = 16384;
+  static constexpr float tolerance = 1.0e-4f;
+
+  void compare(const nam::dspData &config) {
+    // get_dsp may modify its config
+    nam::dspData copy = config;
+    auto reference = nam::get_dsp(copy);
+    SharedWaveNet shared(SharedWaveNet::Weights::parse(config));
+
+    reference->prewarm();
+    shared.prewarm();
+
+    juce::Random random(0x57415645);
+    std::vector<float> input((size_t)numSamples);
+    for (auto &sample : input)
+      sample = 0.3f * (random.nextFloat() * 2.0f - 1.0f);
+
+    std::vector<float> expected((size_t)numSamples);
+    std::vector<float> actual((size_t)numSamples);
+
+    static constexpr int blockSizes[] = {64, 1, 300, 17, 512};
+    int block = 0;
+    for (int start = 0; start < numSamples;) {
+      const int n = juce::jmin(blockSizes[block++ % std::size(blockSizes)],
+                               numSamples - start);
+      reference->process(input.data() + start, expected.data() + start, n);
+      reference->finalize_(n);
+      shared.process(input.data() + start, actual.data() + start, n);
+      shared.finalize_(n);
+      start += n;
+    }
+
+    float maxError = 0.0f;
+    float peak = 0.0f;
+    for (size_t i = 0; i < expected.size(); ++i) {
+      maxError = juce::jmax(maxError, std::abs(actual[i] - expected[i]));
+      peak = juce::jmax(peak, std::abs(expected[i]));
+    }
+
+    logMessage("Peak " + juce::String(peak, 4) + ", largest difference " +
+               juce::String(maxError, 9));
+
+    // A silent model would compare equal whatever SharedWaveNet does
+    expectGreaterThan(peak, 1.0e-3f);
+    expectLessThan(maxError, tolerance);
+  }
+
+  // Two arrays of gated layers with random weights, in the shape of a
+  // small .nam file
+  static nam::dspData makeGatedConfig() {
+    nam::dspData config;
+    config.version = "0.5.2";
+    config.architecture = "WaveNet";
+    config.expected_sample_rate = 48000.0;
+    config.metadata = nlohmann::json::object();
+    config.config = nlohmann::json::parse(R"({
+      "layers": [
+        {"input_size": 1, "condition_size": 1, "head_size": 4,
+         "channels": 4, "kernel_size": 3, "dilations": [1, 2, 4],
+         "activation": "Tanh", "gated": true, "head_bias": false},
+        {"input_size": 4, "condition_size": 1, "head_size": 1,
+         "channels": 4, "kernel_size": 3, "dilations": [8, 16],
+         "activation": "Tanh", "gated": true, "head_bias": true}],
+      "head": null,
+      "head_scale": 0.5})");
+
+    // Per array: rechannel, then per layer the dilated convolution and its
+    // bias, the input mixin and the 1x1 with its bias; then the head
+    // rechannel. The head scale comes last.
+    size_t numWeights = 1;
+    for (const auto &array : config.config["layers"]) {
+      const size_t channels = array["channels"].get<size_t>();
+      const size_t gatedChannels =
+          array["gated"].get<bool>() ? 2 * channels : channels;
+      const size_t headSize = array["head_size"].get<size_t>();
+
+      numWeights += channels * array["input_size"].get<size_t>();
+      numWeights += array["dilations"].size() *
+                    (gatedChannels * channels *
+                         array["kernel_size"].get<size_t>() +
+                     gatedChannels +
+                     gatedChannels * array["condition_size"].get<size_t>() +
+                     channels * channels + channels);
+      numWeights += headSize * channels +
+                    (array["head_bias"].get<bool>() ? headSize : 0);
+    }
+
+    juce::Random random(0x47415445);
+    config.weights.resize(numWeights);
+    for (auto &weight : config.weights)
+      weight = random.nextFloat() - 0.5f;
+    config.weights.back() = 0.5f;
+
+    return config;
+  }
+};
+
+static WaveNetEquivalenceTest waveNetEquivalenceTest;
@@ -0,0 +1,116 @@
+#include "ModelRegistry.h"
+#include "WeightKernels.h"
+#include "WeightQuantizer.h"
+
+/**
+ * Weight Precision Test
+ * Bounds what reduced-precision weight storage costs. For each precision
+ * the test model is run in float and at that precision on
+ * WeightQuantizer::measure()'s test signal; the error-to-signal ratio must
+ * stay under the precision's limit, and the shared weights must shrink.
+ * The report is logged, so a run doubles as the accuracy table.
+ *
+ * The fastest kernels this CPU runs are also checked against the scalar
+ * ones on shapes that exercise every partial row block and column tail.
+ */
+class WeightPrecisionTest : public juce::UnitTest {
+public:
+  WeightPrecisionTest()
+      : juce::UnitTest("Weight precision", "Weight precision") {}
+
+  void runTest() override {
+    using Precision = WeightQuantizer::Precision;
+
+    juce::MemoryBlock contents;
+    expect(juce::File(MAYERISM_TEST_MODEL).loadFileAsData(contents),
+           "Missing test model");
+    const auto config = ModelRegistry::parseContents(contents);
+    const auto floatBytes =
+        SharedWaveNet::Weights::parse(config)->getSizeInBytes();
+
+    // Limits on ESR, and on size as a share of float storage (a little
+    // over a half and a quarter: biases stay float, columns are padded)
+    struct Limit {
+      Precision precision;
+      double maxEsr;
+      double maxSize;
+    };
+    for (const auto &limit : {Limit{Precision::Float16, 1.0e-6, 0.6},
+                              Limit{Precision::Int8, 1.0e-3, 0.35}}) {
+      beginTest(WeightQuantizer::getName(limit.precision));
+
+      const auto report = WeightQuantizer::measure(config, limit.precision);
+      const auto bytes =
+          SharedWaveNet::Weights::parse(config, limit.precision)
+              ->getSizeInBytes();
+
+      logMessage("ESR " + juce::String(report.esr, 10) + ", null " +
+                 juce::String(report.nullDb, 1) + " dB, " +
+                 juce::String((int)bytes) + " of " +
+                 juce::String((int)floatBytes) + " bytes");
+
+      expectLessThan(report.esr, limit.maxEsr);
+      expectLessThan((double)bytes, limit.maxSize * (double)floatBytes);
+    }
+
+    beginTest(juce::String("Kernels: ") + weightkernels::get().name);
+    checkKernels();
+  }
+
+private:
+  void checkKernels() {
+    const auto &fast = weightkernels::get();
+    const auto &scalar = weightkernels::getScalar();
+
+    juce::Random random(0x4b45524e);
+    auto next = [&random] { return random.nextFloat() * 2.0f - 1.0f; };
+
+    for (const int rows : {1, 7, 8, 12, 17, 24, 33})
+      for (const int cols : {1, 9, 73})
+        for (const int n : {1, 5, 6, 13}) {
+          const int padded = weightkernels::getPaddedRows(rows);
+          const int xStride = cols + 3;
+          const int yStride = rows + 2;
+
+          std::vector<uint16_t> halves((size_t)(padded * cols));
+          std::vector<int8_t> bytes((size_t)(padded * cols));
+          std::vector<float> scales((size_t)padded);
+          std::vector<float> x((size_t)(xStride * n));
+          for (auto &w : halves)
+            w = weightkernels::toHalf(next());
+          for (auto &w : bytes)
+            w = (int8_t)(127.0f * next());
+          for (auto &s : scales)
+            s = 0.01f * next();
+          for (auto &v : x)
+            v = next();
+
+          std::vector<float> expected((size_t)(yStride * n));
+          std::vector<float> actual((size_t)(yStride * n));
+
+          scalar.half(halves.data(), rows, cols, x.data(), xStride,
+                      expected.data(), yStride, n);
+          fast.half(halves.data(), rows, cols, x.data(), xStride,
+                    actual.data(), yStride, n);
+          expectMatches(expected, actual, rows, yStride, n, 1.0e-4f);
+
+          scalar.int8(bytes.data(), scales.data(), rows, cols, x.data(),
+                      xStride, expected.data(), yStride, n);
+          fast.int8(bytes.data(), scales.data(), rows, cols, x.data(),
+                    xStride, actual.data(), yStride, n);
+          expectMatches(expected, actual, rows, yStride, n, 1.0e-3f);
+        }
+  }
+
+  void expectMatches(const std::vector<float> &expected,
+                     const std::vector<float> &actual, int rows, int yStride,
+                     int n, float tolerance) {
+    for (int t = 0; t < n; ++t)
+      for (int i = 0; i < rows; ++i) {
+        const auto index = (size_t)(t * yStride + i);
+        expectWithinAbsoluteError(actual[index], expected[index], tolerance);
+      }
+  }
+};
+
+static WeightPrecisionTest weightPrecisionTest;